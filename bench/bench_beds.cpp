@@ -0,0 +1,134 @@
+// bench_beds.cpp
+// Débit des admissions quand beaucoup de transferts visent le même hôpital en même temps :
+// ancien chemin (fonds sous mutex, un seul compteur de lits) contre l'allocateur par CPU.
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include <pcosynchro/pcomutex.h>
+#include <pcosynchro/pcothread.h>
+
+#include "bed_allocator.h"
+#include "hospital.h"
+#include "utils.h"
+
+/// Accès aux lits pour la sortie ; Hospital déclare ce nom ami, hors espace anonyme
+class TestableHospital : public Hospital {
+public:
+    using Hospital::Hospital;
+
+    /// Sortie comme vers une clinique : stock sous le verrou, puis lits rendus à l'allocateur
+    void discharge(int qty) {
+        mutex.lock();
+        stocks[ItemType::SickPatient] -= qty;
+        mutex.unlock();
+        beds.release(qty);
+        population().add(PatientHolder::Hospital, -qty);
+    }
+};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Admission telle qu'elle était faite : fonds lus sous le verrou, puis CAS sur un compteur unique.
+class LockedBeds {
+public:
+    explicit LockedBeds(int beds) : freeBeds(beds) {}
+
+    int claim(int qty) {
+        mutex.lock();
+        bool solvent = money > 0;
+        mutex.unlock();
+        if (!solvent) return 0;
+
+        int free = freeBeds.load();
+        int taken;
+        do {
+            taken = std::min(qty, free);
+            if (taken <= 0) return 0;
+        } while (!freeBeds.compare_exchange_weak(free, free - taken));
+        return taken;
+    }
+
+    void release(int qty) { freeBeds.fetch_add(qty); }
+
+private:
+    PcoMutex mutex;
+    int money{1000};
+    std::atomic<int> freeBeds;
+};
+
+/// Admission réelle (reserve puis commit) et sortie par BedAllocator::release().
+class HospitalBeds {
+public:
+    explicit HospitalBeds(int beds) : hospital(1, 1000, beds) {}
+
+    int claim(int qty) {
+        Reservation token = hospital.reserve(ItemType::SickPatient, qty);
+        return hospital.commit(token);
+    }
+    void release(int qty) {
+        if (qty > 0) hospital.discharge(qty);
+    }
+
+private:
+    TestableHospital hospital;
+};
+
+/// Millions d'admissions (suivies d'une sortie) par seconde.
+template<typename Beds>
+double run(Beds& beds, int nbTransferers, int durationMs) {
+    std::atomic<bool> done{false};
+    std::atomic<long long> admissions{0};
+
+    std::vector<std::unique_ptr<PcoThread>> threads;
+    for (int t = 0; t < nbTransferers; ++t) {
+        threads.emplace_back(std::make_unique<PcoThread>([&, t]() {
+            long long local = 0;
+            for (int k = t; !done.load(std::memory_order_relaxed); ++k) {
+                int got = beds.claim(1 + k % 3);
+                local += got > 0;
+                beds.release(got);
+            }
+            admissions += local;
+        }));
+    }
+
+    auto start = Clock::now();
+    PcoThread::usleep(static_cast<uint64_t>(durationMs) * 1000);
+    done = true;
+    for (auto& t : threads) t->join();
+    double s = std::chrono::duration<double>(Clock::now() - start).count();
+    return static_cast<double>(admissions.load()) / s / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int nbTransferers = argc > 1 ? atoi(argv[1]) : 64;
+    int durationMs    = argc > 2 ? atoi(argv[2]) : 500;
+    int nbBeds        = argc > 3 ? atoi(argv[3]) : MAX_BEDS_PER_HOSTPITAL;
+    int nbSlabs       = argc > 4 ? atoi(argv[4]) : BedAllocator::defaultSlabCount();
+
+    logger().setVerbosity(0);
+    printf("%d transferers, %d beds, %d slabs, %d ms per run\n", nbTransferers, nbBeds,
+           BedAllocator(nbBeds, nbSlabs).getSlabCount(), durationMs);
+    printf("%-28s %14s\n", "admission path", "Madmit/s");
+
+    LockedBeds locked(nbBeds);
+    double base = run(locked, nbTransferers, durationMs);
+    printf("%-28s %14.2f\n", "mutex funds + one counter", base);
+
+    BedAllocator sharded(nbBeds, nbSlabs);
+    double slabs = run(sharded, nbTransferers, durationMs);
+    printf("%-28s %14.2f %7.2fx\n", "BedAllocator", slabs, slabs / base);
+
+    HospitalBeds hospital(nbBeds);
+    double full = run(hospital, nbTransferers, durationMs);
+    printf("%-28s %14.2f %7.2fx  (%d slabs)\n", "Hospital::reserve/commit", full, full / base,
+           BedAllocator(nbBeds).getSlabCount());
+    return 0;
+}
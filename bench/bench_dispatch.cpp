@@ -0,0 +1,98 @@
+// bench_dispatch.cpp
+// Compare l'envoi des patients vers un hôpital tiré au hasard avec la répartition
+// selon les lits libres publiés : patients livrés, refusés et salaires payés pour rien.
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include <pcosynchro/pcothread.h>
+
+#include "day_clock.h"
+#include "dispatch.h"
+#include "insurance.h"
+#include "topology.h"
+#include "utils.h"
+
+namespace {
+
+struct Result {
+    int delivered;   ///< Patients sortis des ambulances
+    int rejected;    ///< Patients refusés par un hôpital plein
+    int trips;       ///< Appels à transfer, chacun payé d'un salaire
+};
+
+Result runMode(const std::string& mode, int nbDays, int nbHospitals) {
+    srand(7);
+
+    auto ambulances = createAmbulances(6, 0);
+    auto suppliers  = createSuppliers(3, 6);
+    auto hospitals  = createHospitals(nbHospitals, 9);
+    auto clinics    = createClinics(3, 9 + nbHospitals);
+    Insurance insurance(12 + nbHospitals, INSURANCE_FUND);
+
+    applyTopology(makeTopology("", static_cast<int>(ambulances.size()), static_cast<int>(suppliers.size()),
+                               static_cast<int>(clinics.size()), static_cast<int>(hospitals.size())),
+                  ambulances, suppliers, clinics, hospitals);
+    for (auto* a : ambulances) {
+        a->setInsurance(&insurance);
+        a->setDispatchMode(parseDispatchMode(mode));
+    }
+    for (auto* h : hospitals)  h->setInsurance(&insurance);
+    for (auto* c : clinics) c->setInsurance(&insurance);
+
+    DayClock clock(static_cast<int>(ambulances.size() + suppliers.size() + hospitals.size() + clinics.size()) + 1);
+    for (auto* a : ambulances) a->setClock(&clock);
+    for (auto* s : suppliers)  s->setClock(&clock);
+    for (auto* h : hospitals)  h->setClock(&clock);
+    for (auto* c : clinics)    c->setClock(&clock);
+    insurance.setClock(&clock);
+
+    int initial = 0;
+    for (auto* a : ambulances) initial += a->getNumberPatients();
+    std::vector<std::unique_ptr<PcoThread>> threads;
+    startWorkers(ambulances, threads);
+    startWorkers(suppliers, threads);
+    startWorkers(hospitals, threads);
+    startWorkers(clinics, threads);
+    startWorkers(std::vector<Insurance*>{&insurance}, threads);
+
+    for (int day = 0; day < nbDays; ++day) {
+        clock.start_next_day();
+        clock.wait_all_done();
+    }
+
+    endService(threads);
+    clock.start_next_day();
+    for (auto& t : threads) t->join();
+
+    Result result{initial, 0, 0};
+    for (auto* a : ambulances) {
+        result.delivered -= a->getNumberPatients();
+        result.rejected += a->getRejectedPatients();
+        result.trips += a->getTransferCalls();
+    }
+
+    for (auto* a : ambulances) delete a;
+    for (auto* s : suppliers)  delete s;
+    for (auto* h : hospitals)  delete h;
+    for (auto* c : clinics)    delete c;
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int nbDays      = argc > 1 ? atoi(argv[1]) : 100;
+    int nbHospitals = argc > 2 ? atoi(argv[2]) : 4;
+
+    logger().setVerbosity(0);
+    printf("%d days, %d hospitals\n", nbDays, nbHospitals);
+    printf("%-10s %10s %10s %10s %14s\n", "dispatch", "delivered", "rejected", "trips", "patients/trip");
+    for (const std::string mode : {"random", "capacity"}) {
+        Result r = runMode(mode, nbDays, nbHospitals);
+        printf("%-10s %10d %10d %10d %14.2f\n", mode.c_str(), r.delivered, r.rejected, r.trips,
+               r.trips > 0 ? static_cast<double>(r.delivered) / r.trips : 0.0);
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+// bench_inventory.cpp
+// Compare les politiques de réapprovisionnement d'une clinique :
+// jours bloqués faute de ressources et appels à Supplier::buy par patient traité.
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include <pcosynchro/pcothread.h>
+
+#include "clinic.h"
+#include "day_clock.h"
+#include "insurance.h"
+#include "inventory_policy.h"
+#include "supplier.h"
+#include "utils.h"
+
+namespace {
+
+/// Hôpital minimal : accepte tous les patients en réhabilitation.
+class RehabSink : public Seller {
+public:
+    explicit RehabSink(int id) : Seller(0, id) {}
+    int  transfer(ItemType, int qty) override { return qty; }
+    int  buy(ItemType, int) override { return 0; }
+    void invoice(int, Seller*) override {}
+    void pay(int) override {}
+};
+
+struct Result {
+    int treated;
+    int stallDays;
+    int purchases;
+};
+
+Result runPolicy(const std::string& policy, int nbDays, int capacity, int arrivalsPerDay) {
+    srand(42);
+
+    auto suppliers = createSuppliers(2, 0);
+    Pulmonology clinic(2, CLINICS_FUND);
+    RehabSink sink(3);
+    Insurance insurance(4, INSURANCE_FUND);
+
+    std::vector<Seller*> sellerSuppliers(suppliers.begin(), suppliers.end());
+    clinic.setHospitalsAndSuppliers({&sink}, sellerSuppliers);
+    clinic.setInsurance(&insurance);
+    clinic.setTreatmentCapacity(capacity);
+    clinic.setInventoryPolicy(parseInventoryPolicy(policy));
+
+    DayClock clock(static_cast<int>(suppliers.size()) + 2);
+    for (auto* s : suppliers) s->setClock(&clock);
+    clinic.setClock(&clock);
+    insurance.setClock(&clock);
+
+    std::vector<std::unique_ptr<PcoThread>> threads;
+    for (auto* s : suppliers) threads.emplace_back(std::make_unique<PcoThread>(&Supplier::run, s));
+    threads.emplace_back(std::make_unique<PcoThread>(&Clinic::run, &clinic));
+    threads.emplace_back(std::make_unique<PcoThread>(&Insurance::run, &insurance));
+
+    for (int day = 0; day < nbDays; ++day) {
+        // Arrivées entre deux journées : la clinique les videra demain
+        clinic.transfer(ItemType::SickPatient, 1 + rand() % arrivalsPerDay);
+        clock.start_next_day();
+        clock.wait_all_done();
+    }
+
+    endService(threads);
+    clock.start_next_day();
+    for (auto& t : threads) t->join();
+
+    Result r{clinic.getAmountPaidToEmployees(EmployeeType::TreatmentSpecialist) /
+             getEmployeeSalary(EmployeeType::TreatmentSpecialist),
+             clinic.getStallDays(), clinic.getPurchaseCalls()};
+    for (auto* s : suppliers) delete s;
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int nbDays   = argc > 1 ? atoi(argv[1]) : 365;
+    int capacity = argc > 2 ? atoi(argv[2]) : 2;
+    int arrivals = argc > 3 ? atoi(argv[3]) : 3;
+
+    const std::vector<std::string> policies = {"on-demand", "sS:2:8", "moving-average:7:4"};
+
+    printf("%d days, capacity %d, up to %d arrivals per day\n", nbDays, capacity, arrivals);
+    printf("%-22s %8s %8s %10s %14s\n", "policy", "treated", "stalls", "buy calls", "calls/patient");
+    for (const auto& policy : policies) {
+        Result r = runPolicy(policy, nbDays, capacity, arrivals);
+        printf("%-22s %8d %8d %10d %14.3f\n", policy.c_str(), r.treated, r.stallDays, r.purchases,
+               r.treated ? static_cast<double>(r.purchases) / r.treated : 0.0);
+    }
+    return 0;
+}
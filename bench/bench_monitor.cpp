@@ -0,0 +1,76 @@
+// bench_monitor.cpp
+// Un moniteur parcourt tous les acteurs d'un grand monde pendant que leurs propriétaires
+// publient leur état : coût d'un parcours par readState() (seqlock) contre getFund()/getStock().
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include <pcosynchro/pcothread.h>
+
+#include "supplier.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int nbActors  = argc > 1 ? atoi(argv[1]) : 100'000;
+    int nbOwners  = argc > 2 ? atoi(argv[2]) : 4;
+    int nbScans   = argc > 3 ? atoi(argv[3]) : 20;
+
+    logger().setVerbosity(0);
+    std::vector<std::unique_ptr<Pharmacy>> actors;
+    actors.reserve(nbActors);
+    for (int i = 0; i < nbActors; ++i) actors.push_back(std::make_unique<Pharmacy>(i, 1000));
+    auto start = Clock::now();
+    for (auto& a : actors) a->publishState();
+    double publishNs = msSince(start) * 1e6 / nbActors;
+
+    // Chaque propriétaire republie sans arrêt l'état de sa part des acteurs
+    std::atomic<bool> done{false};
+    std::vector<std::unique_ptr<PcoThread>> owners;
+    for (int o = 0; o < nbOwners; ++o) {
+        owners.emplace_back(std::make_unique<PcoThread>([&, o]() {
+            while (!done.load(std::memory_order_relaxed)) {
+                for (int i = o; i < nbActors && !done.load(std::memory_order_relaxed); i += nbOwners) {
+                    actors[i]->publishState();
+                }
+            }
+        }));
+    }
+
+    start = Clock::now();
+    long long fundsSeqlock = 0;
+    for (int s = 0; s < nbScans; ++s) {
+        for (auto& a : actors) {
+            ActorState state = a->readState();
+            fundsSeqlock += state.fund + state.stock[static_cast<int>(ItemType::Pill)];
+        }
+    }
+    double seqlockMs = msSince(start) / nbScans;
+
+    start = Clock::now();
+    long long fundsDirect = 0;
+    for (int s = 0; s < nbScans; ++s) {
+        for (auto& a : actors) fundsDirect += a->getFund() + a->getStock()[ItemType::Pill];
+    }
+    double directMs = msSince(start) / nbScans;
+
+    done = true;
+    for (auto& t : owners) t->join();
+
+    printf("%d actors, %d owners publishing\n", nbActors, nbOwners);
+    printf("%-26s %10.2f ms per scan\n", "readState() (seqlock)", seqlockMs);
+    printf("%-26s %10.2f ms per scan\n", "getFund() + getStock()", directMs);
+    printf("%-26s %10.0f ns per actor\n", "publishState()", publishNs);
+    printf("checksums %lld %lld\n", fundsSeqlock, fundsDirect);
+    return 0;
+}
@@ -0,0 +1,103 @@
+// bench_payments.cpp
+// Compare les politiques de paiement de l'assurance sur une simulation complète :
+// patients traités par jour et jours où des cliniques refusent des patients faute d'être payées.
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include <pcosynchro/pcothread.h>
+
+#include "day_clock.h"
+#include "insurance.h"
+#include "payment_scheduler.h"
+#include "topology.h"
+#include "utils.h"
+
+namespace {
+
+struct Result {
+    double treatedPerDay;
+    int waitingClinicDays;  ///< Somme sur les jours des cliniques bloquées en début de journée
+};
+
+Result runPolicy(const std::string& policy, int nbDays, int nbClinics, int capacity) {
+    srand(7);
+
+    auto ambulances = createAmbulances(6, 0);
+    auto suppliers  = createSuppliers(3, 6);
+    auto hospitals  = createHospitals(2, 9);
+    auto clinics    = createClinics(nbClinics, 11);
+    Insurance insurance(11 + nbClinics, INSURANCE_FUND);
+    insurance.setPaymentPolicy(parsePaymentPolicy(policy));
+
+    applyTopology(makeTopology("", static_cast<int>(ambulances.size()), static_cast<int>(suppliers.size()),
+                               static_cast<int>(clinics.size()), static_cast<int>(hospitals.size())),
+                  ambulances, suppliers, clinics, hospitals);
+    for (auto* a : ambulances) a->setInsurance(&insurance);
+    for (auto* h : hospitals)  h->setInsurance(&insurance);
+    for (auto* c : clinics) {
+        c->setInsurance(&insurance);
+        c->setTreatmentCapacity(capacity);
+    }
+
+    DayClock clock(static_cast<int>(ambulances.size() + suppliers.size() + hospitals.size() + clinics.size()) + 1);
+    for (auto* a : ambulances) a->setClock(&clock);
+    for (auto* s : suppliers)  s->setClock(&clock);
+    for (auto* h : hospitals)  h->setClock(&clock);
+    for (auto* c : clinics)    c->setClock(&clock);
+    insurance.setClock(&clock);
+
+    std::vector<std::unique_ptr<PcoThread>> threads;
+    startWorkers(ambulances, threads);
+    startWorkers(suppliers, threads);
+    startWorkers(hospitals, threads);
+    startWorkers(clinics, threads);
+    startWorkers(std::vector<Insurance*>{&insurance}, threads);
+
+    int waitingClinicDays = 0;
+    for (int day = 0; day < nbDays; ++day) {
+        for (auto* c : clinics) waitingClinicDays += c->isWaitingForPayment();
+        clock.start_next_day();
+        clock.wait_all_done();
+    }
+
+    endService(threads);
+    clock.start_next_day();
+    for (auto& t : threads) t->join();
+
+    int treated = 0;
+    for (auto* c : clinics) {
+        treated += c->getAmountPaidToEmployees(EmployeeType::TreatmentSpecialist) /
+                   getEmployeeSalary(EmployeeType::TreatmentSpecialist);
+    }
+
+    for (auto* a : ambulances) delete a;
+    for (auto* s : suppliers)  delete s;
+    for (auto* h : hospitals)  delete h;
+    for (auto* c : clinics)    delete c;
+    return {static_cast<double>(treated) / nbDays, waitingClinicDays};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int nbDays    = argc > 1 ? atoi(argv[1]) : 200;
+    int nbClinics = argc > 2 ? atoi(argv[2]) : 6;
+    int capacity  = argc > 3 ? atoi(argv[3]) : 2;
+
+    logger().setVerbosity(0);
+    const std::vector<std::string> policies = {"fifo", "priority", "priority:0:partial", "priority:100",
+                                               "priority:100:partial"};
+
+    printf("%d days, %d clinics, capacity %d\n", nbDays, nbClinics, capacity);
+    printf("%-22s %14s %14s %10s\n", "policy", "treated/day", "waiting days", "gain");
+    double baseline = 0;
+    for (const auto& policy : policies) {
+        Result r = runPolicy(policy, nbDays, nbClinics, capacity);
+        if (policy == "fifo") baseline = r.treatedPerDay;
+        printf("%-22s %14.3f %14d %9.1f%%\n", policy.c_str(), r.treatedPerDay, r.waitingClinicDays,
+               baseline > 0 ? 100.0 * (r.treatedPerDay / baseline - 1.0) : 0.0);
+    }
+    return 0;
+}
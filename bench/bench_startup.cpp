@@ -0,0 +1,96 @@
+// bench_startup.cpp
+// Mesure le temps jusqu'à la fin du premier jour : construction des acteurs,
+// câblage, démarrage des threads puis une journée complète.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include <pcosynchro/pcothread.h>
+
+#include "day_clock.h"
+#include "insurance.h"
+#include "topology.h"
+#include "utils.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Nombre total d'acteurs, répartis comme une grande simulation régionale
+    int nbActors = argc > 1 ? atoi(argv[1]) : 2000;
+    int regions  = argc > 2 ? atoi(argv[2]) : 8;
+
+    int nbHospitals  = std::max(regions, nbActors / 10);
+    int nbSuppliers  = std::max(2, nbActors / 10);
+    int nbAmbulances = std::max(3, nbActors / 5);
+    int nbClinics    = std::max(1, nbActors - nbHospitals - nbSuppliers - nbAmbulances / 3);
+
+    logger().setVerbosity(0);
+    auto start = Clock::now();
+
+    auto t = Clock::now();
+    auto ambulances = createAmbulances(nbAmbulances, 0);
+    auto suppliers  = createSuppliers(nbSuppliers, nbAmbulances);
+    auto hospitals  = createHospitals(nbHospitals, nbAmbulances + nbSuppliers);
+    auto clinics    = createClinics(nbClinics, nbAmbulances + nbSuppliers + nbHospitals);
+    Insurance insurance(nbAmbulances + nbSuppliers + nbHospitals + nbClinics, INSURANCE_FUND);
+    double constructMs = elapsedMs(t);
+
+    t = Clock::now();
+    Topology topology = makeRegionalTopology(static_cast<int>(ambulances.size()), nbSuppliers, nbClinics,
+                                             nbHospitals, regions, 2, 1);
+    applyTopology(topology, ambulances, suppliers, clinics, hospitals);
+    for (auto* a : ambulances) a->setInsurance(&insurance);
+    for (auto* h : hospitals)  h->setInsurance(&insurance);
+    for (auto* c : clinics)    c->setInsurance(&insurance);
+
+    DayClock clock(static_cast<int>(ambulances.size() + suppliers.size() + hospitals.size() + clinics.size()) + 1);
+    for (auto* a : ambulances) a->setClock(&clock);
+    for (auto* s : suppliers)  s->setClock(&clock);
+    for (auto* h : hospitals)  h->setClock(&clock);
+    for (auto* c : clinics)    c->setClock(&clock);
+    insurance.setClock(&clock);
+    double wireMs = elapsedMs(t);
+
+    t = Clock::now();
+    std::vector<std::unique_ptr<PcoThread>> threads;
+    startWorkers(ambulances, threads);
+    startWorkers(suppliers, threads);
+    startWorkers(hospitals, threads);
+    startWorkers(clinics, threads);
+    startWorkers(std::vector<Insurance*>{&insurance}, threads);
+    double startMs = elapsedMs(t);
+
+    t = Clock::now();
+    clock.start_next_day();
+    clock.wait_all_done();
+    double dayMs = elapsedMs(t);
+    double firstDayMs = elapsedMs(start);
+
+    endService(threads);
+    clock.start_next_day();
+    for (auto& th : threads) th->join();
+
+    printf("%zu actor threads (%zu ambulances, %zu suppliers, %zu hospitals, %zu clinics, 1 insurance)\n",
+           threads.size(), ambulances.size(), suppliers.size(), hospitals.size(), clinics.size());
+    printf("%-14s %10.1f ms\n", "construct", constructMs);
+    printf("%-14s %10.1f ms\n", "wire", wireMs);
+    printf("%-14s %10.1f ms\n", "start threads", startMs);
+    printf("%-14s %10.1f ms\n", "first day", dayMs);
+    printf("%-14s %10.1f ms\n", "time to day 1", firstDayMs);
+
+    for (auto* a : ambulances) delete a;
+    for (auto* s : suppliers)  delete s;
+    for (auto* h : hospitals)  delete h;
+    for (auto* c : clinics)    delete c;
+    return 0;
+}
@@ -0,0 +1,101 @@
+// bench_supplier.cpp
+// Débit des achats chez un seul fournisseur quand plusieurs cliniques commandent en même temps
+// pendant qu'il produit : stock protégé par un mutex contre compteurs atomiques (Supplier::buy).
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <vector>
+#include <pcosynchro/pcomutex.h>
+#include <pcosynchro/pcothread.h>
+
+#include "costs.h"
+#include "supplier.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Achat tel qu'il était fait avant les compteurs : stock dans une map sous le verrou.
+class LockedStock {
+public:
+    int buy(ItemType it, int qty) {
+        mutex.lock();
+        if (stocks[it] < qty) {
+            mutex.unlock();
+            return 0;
+        }
+        stocks[it] -= qty;
+        mutex.unlock();
+        return qty * getCostPerUnit(it);
+    }
+
+    void produce(ItemType it, int qty) {
+        mutex.lock();
+        stocks[it] += qty;
+        mutex.unlock();
+    }
+
+private:
+    std::map<ItemType, int> stocks;
+    PcoMutex mutex;
+};
+
+/// Réassort sans passer par la journée de production.
+class BenchSupplier : public Pharmacy {
+public:
+    using Pharmacy::Pharmacy;
+    void produce(ItemType it, int qty) { stockOf(it).add(qty); }
+};
+
+/// Millions d'appels à buy par seconde, nbBuyers threads et un producteur.
+template<typename Stock>
+double run(Stock& stock, int nbBuyers, int durationMs) {
+    std::atomic<bool> done{false};
+    std::atomic<long long> calls{0};
+
+    std::vector<std::unique_ptr<PcoThread>> threads;
+    threads.emplace_back(std::make_unique<PcoThread>([&]() {
+        while (!done.load(std::memory_order_relaxed)) {
+            stock.produce(ItemType::Pill, 64);
+            PcoThread::usleep(10);
+        }
+    }));
+    for (int b = 0; b < nbBuyers; ++b) {
+        threads.emplace_back(std::make_unique<PcoThread>([&, b]() {
+            long long local = 0;
+            ItemType item = b % 2 ? ItemType::Pill : ItemType::Syringe;
+            for (; !done.load(std::memory_order_relaxed); ++local) stock.buy(item, 1);
+            calls += local;
+        }));
+    }
+    // Les seringues ne sont pas réapprovisionnées : on les fournit d'avance
+    stock.produce(ItemType::Syringe, 1 << 30);
+
+    auto start = Clock::now();
+    PcoThread::usleep(static_cast<uint64_t>(durationMs) * 1000);
+    done = true;
+    for (auto& t : threads) t->join();
+    double s = std::chrono::duration<double>(Clock::now() - start).count();
+    return static_cast<double>(calls.load()) / s / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int durationMs = argc > 1 ? atoi(argv[1]) : 500;
+
+    logger().setVerbosity(0);
+    printf("%d ms per run, one producer\n", durationMs);
+    printf("%7s %15s %15s %8s\n", "buyers", "mutex Mcall/s", "atomic Mcall/s", "speedup");
+    for (int buyers : {1, 4, 16, 32}) {
+        LockedStock locked;
+        BenchSupplier counters(1, 0);
+        double m = run(locked, buyers, durationMs);
+        double a = run(counters, buyers, durationMs);
+        printf("%7d %15.2f %15.2f %8.2f\n", buyers, m, a, a / m);
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+// bench_treatment.cpp
+// Compare le débit de traitement d'une clinique dont les ressources sont un
+// vecteur lu à l'exécution avec celui d'une clinique spécialisée à la compilation.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "clinic.h"
+#include "costs.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Donne accès au traitement et au réassort, sans thread ni fournisseur.
+template<typename Base>
+class BenchClinic : public Base {
+public:
+    template<typename... Args>
+    explicit BenchClinic(Args&&... args) : Base(std::forward<Args>(args)...) {}
+
+    using Base::treatPatients;
+
+    void refill(int patients, int salary) {
+        this->stocks[ItemType::SickPatient] = patients;
+        this->stocks[ItemType::RehabPatient] = 0;
+        for (auto item : this->getResourcesNeeded()) this->setResourceStock(item, patients);
+        this->money = patients * salary;
+    }
+};
+
+/// Nanosecondes par patient, traités par lots de batch.
+template<typename C>
+double run(C& clinic, long long nbPatients, int batch) {
+    const int salary = getEmployeeSalary(EmployeeType::TreatmentSpecialist);
+    const int refillEvery = 100'000;
+
+    long long treated = 0;
+    auto start = Clock::now();
+    while (treated < nbPatients) {
+        clinic.refill(refillEvery, salary);
+        for (int left = refillEvery; left > 0; ) {
+            int n = clinic.treatPatients(batch);
+            if (n == 0) break;
+            left -= n;
+            treated += n;
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return ns / static_cast<double>(treated);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long long nbPatients = argc > 1 ? atoll(argv[1]) : 20'000'000;
+
+    logger().setVerbosity(0);
+    BenchClinic<Clinic> runtime(1, 0, std::vector<ItemType>{ItemType::Pill, ItemType::Thermometer});
+    BenchClinic<Pulmonology> typed(2, 0);
+
+    printf("%lld patients per run\n", nbPatients);
+    printf("%6s %14s %14s %8s\n", "batch", "vector ns/pat", "ClinicT ns/pat", "speedup");
+    for (int batch : {1, 4, 16}) {
+        double vec = run(runtime, nbPatients, batch);
+        double tpl = run(typed, nbPatients, batch);
+        printf("%6d %14.2f %14.2f %8.2f\n", batch, vec, tpl, vec / tpl);
+    }
+    return 0;
+}
@@ -0,0 +1,170 @@
+#ifndef ACTOR_HANDLE_H
+#define ACTOR_HANDLE_H
+
+#include <type_traits>
+#include <variant>
+
+#include "seller.h"
+
+class Ambulance;
+class Hospital;
+class Clinic;
+class Supplier;
+class Insurance;
+
+/**
+ * @brief Operations an actor type really supports; the other overrides of the
+ *        Seller interface only throw std::logic_error.
+ */
+template<typename Actor>
+struct ActorOps;
+
+template<> struct ActorOps<Ambulance> { static constexpr bool transfer = false, buy = false, invoice = false, pay = true; };
+template<> struct ActorOps<Hospital>  { static constexpr bool transfer = true,  buy = false, invoice = false, pay = true; };
+template<> struct ActorOps<Clinic>    { static constexpr bool transfer = true,  buy = false, invoice = false, pay = true; };
+template<> struct ActorOps<Supplier>  { static constexpr bool transfer = false, buy = true,  invoice = false, pay = true; };
+template<> struct ActorOps<Insurance> { static constexpr bool transfer = false, buy = false, invoice = true,  pay = false; };
+
+namespace detail {
+
+/// First type of Actors that Derived inherits from, void if none
+template<typename Derived, typename... Actors>
+struct FirstBase { using type = void; };
+
+template<typename Derived, typename Actor, typename... Rest>
+struct FirstBase<Derived, Actor, Rest...> {
+    using type = std::conditional_t<std::is_base_of_v<Actor, Derived>, Actor,
+                                    typename FirstBase<Derived, Rest...>::type>;
+};
+
+} // namespace detail
+
+/**
+ * @class ActorHandle
+ * @brief Statically typed reference to an actor of one of the given types.
+ *
+ * The supported operations are final in each actor class, so calls on a
+ * concrete actor are made without virtual dispatch and can be inlined;
+ * calling an operation that one of the types does not support does not
+ * compile. Mocks and proxies (tests, phased days) go through the virtual
+ * Seller interface, but only when explicitly wrapped by resolve().
+ */
+template<typename... Actors>
+class ActorHandle {
+public:
+    ActorHandle() : actor(static_cast<Seller*>(nullptr)) {}
+
+    /**
+     * @brief Wraps an actor whose type derives from one of Actors.
+     */
+    template<typename Derived, typename Base = typename detail::FirstBase<Derived, Actors...>::type,
+             std::enable_if_t<!std::is_void_v<Base>, int> = 0>
+    ActorHandle(Derived* a) : actor(static_cast<Base*>(a)) {}
+
+    /**
+     * @brief Finds the concrete type of a Seller once, when wiring actors;
+     *        any other Seller (mock, proxy) keeps the virtual interface.
+     */
+    static ActorHandle resolve(Seller* seller) {
+        ActorHandle handle;
+        handle.actor = seller;
+        (void)((handle.tryAs<Actors>(seller)) || ...);
+        return handle;
+    }
+
+    int transfer(ItemType what, int qty) const {
+        static_assert((ActorOps<Actors>::transfer && ...), "transfer() not supported by every actor type of this handle");
+        return std::visit([&](auto* a) {
+            return a->transfer(what, qty);
+        }, actor);
+    }
+
+    Reservation reserve(ItemType what, int qty) const {
+        static_assert((ActorOps<Actors>::transfer && ...), "reserve() not supported by every actor type of this handle");
+        return std::visit([&](auto* a) {
+            return a->reserve(what, qty);
+        }, actor);
+    }
+
+    int commit(Reservation& token) const {
+        static_assert((ActorOps<Actors>::transfer && ...), "commit() not supported by every actor type of this handle");
+        return std::visit([&](auto* a) {
+            return a->commit(token);
+        }, actor);
+    }
+
+    void abort(Reservation& token) const {
+        static_assert((ActorOps<Actors>::transfer && ...), "abort() not supported by every actor type of this handle");
+        std::visit([&](auto* a) {
+            a->abort(token);
+        }, actor);
+    }
+
+    int buy(ItemType what, int qty) const {
+        static_assert((ActorOps<Actors>::buy && ...), "buy() not supported by every actor type of this handle");
+        return std::visit([&](auto* a) {
+            return a->buy(what, qty);
+        }, actor);
+    }
+
+    void invoice(int bill, Seller* who) const {
+        static_assert((ActorOps<Actors>::invoice && ...), "invoice() not supported by every actor type of this handle");
+        std::visit([&](auto* a) {
+            a->invoice(bill, who);
+        }, actor);
+    }
+
+    void pay(int bill) const {
+        static_assert((ActorOps<Actors>::pay && ...), "pay() not supported by every actor type of this handle");
+        std::visit([&](auto* a) {
+            a->pay(bill);
+        }, actor);
+    }
+
+    /**
+     * @brief Published free capacity of the actor, -1 if unknown.
+     */
+    [[nodiscard]] int freeCapacity() const {
+        return std::visit([](auto* a) { return a->getFreeCapacity(); }, actor);
+    }
+
+    /**
+     * @brief The actor behind the handle, through the virtual interface.
+     */
+    [[nodiscard]] Seller* get() const {
+        return std::visit([](auto* a) -> Seller* { return a; }, actor);
+    }
+
+    /**
+     * @brief The actor as one of Actors, nullptr if it is another one or only
+     *        reachable through the virtual interface.
+     */
+    template<typename Actor>
+    [[nodiscard]] Actor* as() const {
+        auto* typed = std::get_if<Actor*>(&actor);
+        return typed ? *typed : nullptr;
+    }
+
+    [[nodiscard]] bool isVirtual() const { return std::holds_alternative<Seller*>(actor); }
+
+    explicit operator bool() const { return get() != nullptr; }
+
+private:
+    template<typename Actor>
+    bool tryAs(Seller* seller) {
+        auto* typed = dynamic_cast<Actor*>(seller);
+        if (typed) actor = typed;
+        return typed != nullptr;
+    }
+
+    std::variant<Actors*..., Seller*> actor;
+};
+
+/// Receivers of patients: hospitals and clinics
+using PatientReceiver = ActorHandle<Hospital, Clinic>;
+/// Sellers of resources to clinics
+using ResourceSeller = ActorHandle<Supplier>;
+/// Payer of the services of the other actors
+using InsuranceHandle = ActorHandle<Insurance>;
+
+#endif // ACTOR_HANDLE_H
@@ -1,6 +1,8 @@
 #ifndef AMBULANCE_H
 #define AMBULANCE_H
 
+#include "actor_handle.h"
+#include "dispatch.h"
 #include "seller.h"
 
 /**
@@ -14,6 +16,8 @@ class Ambulance : public Seller {
 public:
     /// Allows test classes to access protected/private members
     friend class TestableAmbulance;
+    /// Allows snapshots to save and restore the full state
+    friend class Snapshot;
 
     /**
      * @brief Constructs an Ambulance with a unique ID, initial funds,
@@ -55,7 +59,18 @@ public:
      * @brief Receive a bill paiement (e.g., from insurance).
      * @param bill Bill amount.
      */
-    void pay(int bill) override;
+    void pay(int bill) final;
+
+    /**
+     * @brief Payments, applied without locking on phased days.
+     */
+    int applyIntent(const Intent& intent) override;
+
+    /**
+     * @brief Hands over the patients the hospitals accepted, then invoices
+     *        the insurance once for all of them.
+     */
+    void settleReplies(const std::vector<Intent>& replies) override;
 
 
     // Configuration
@@ -72,6 +87,11 @@ public:
      */
     void setInsurance(Seller* insurance);
 
+    /**
+     * @brief Sets how the hospital of each trip is chosen (by free beds by default).
+     */
+    void setDispatchMode(DispatchMode mode);
+
 
     // Simulation / operational methods
 
@@ -81,6 +101,11 @@ public:
      */
     void run();
 
+    /**
+     * @brief Today while patients are left and the crew can be paid.
+     */
+    int nextWorkDay(int today) override;
+
     /**
      * @brief Returns the current number of patients in the ambulance.
      * @return Number of patients.
@@ -93,19 +118,66 @@ public:
      */
     [[nodiscard]] std::vector<ItemType> getResourcesSupplied() const;
 
+    /**
+     * @brief Number of Seller::transfer() calls made so far.
+     */
+    [[nodiscard]] int getTransferCalls() const { return nbTransferCalls; }
+
+    /**
+     * @brief Patients refused by the hospitals so far.
+     */
+    [[nodiscard]] int getRejectedPatients() const { return nbRejected; }
+
+    [[nodiscard]] LockStats getLockStats() const override { return mutex.stats(); }
+
+    /**
+     * @brief Patients here are counted under PatientHolder::Ambulance.
+     */
+    PatientHolder patientHolder() const final { return PatientHolder::Ambulance; }
+
 protected:
     /**
-     * @brief Sends patients to hospitals according to availability and logic.
+     * @brief Sends today's patients to hospitals according to the dispatch mode,
+     *        then invoices the insurance once for all of them.
      *        Called internally by run().
      */
     void sendPatients();
 
+    /**
+     * @brief Reserves beds, pays the crew and hands the patients over; the
+     *        reservation is aborted if the crew cannot be paid. On phased
+     *        days the crew is paid and the patients are offered to the
+     *        hospital, which answers tomorrow.
+     * @return Patients accepted (always 0 on phased days), -1 if the crew
+     *         could not be paid.
+     */
+    int sendTrip(const PatientReceiver& hospital, int qty);
+
+    /**
+     * @brief Takes the patients a hospital accepted out of the ambulance; the
+     *        others offered are refused for good.
+     */
+    void handOver(const Seller* hospital, int offered, int accepted);
+
+    /**
+     * @brief Backlog: patients still to send.
+     */
+    void fillState(ActorState& state) override;
+
 
     // Protected attributes
 
     std::vector<ItemType> resourcesSupplied;  ///< Types of resources the ambulance carries.
+    int* sickStock;                           ///< Entry of stocks for sick patients, read without a map lookup.
     std::vector<Seller*> hospitals;           ///< Hospitals that can receive patients.
     Seller* insurance{nullptr};               ///< Insurance company for billing.
+    std::vector<PatientReceiver> hospitalHandles; ///< Same hospitals, called without virtual dispatch.
+    InsuranceHandle insuranceHandle;          ///< Same insurance, called without virtual dispatch.
+    DispatchMode dispatchMode{DispatchMode::FreeCapacity}; ///< How hospitals are chosen.
+    int nbTransferCalls{0};                   ///< Transfer calls made (ambulance thread only).
+    int nbRejected{0};                        ///< Patients refused (ambulance thread only).
+    std::deque<PatientHandle> patients;       ///< Tracked patients (only when tracking is enabled).
+    ProfiledMutex mutex;                      ///< Protects stocks and money.
 };
 
 #endif // AMBULANCE_H
@@ -0,0 +1,99 @@
+#ifndef BED_ALLOCATOR_H
+#define BED_ALLOCATOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @class BedAllocator
+ * @brief Free beds of a hospital, claimed and released without a lock.
+ *
+ * Beds are spread over one slab per CPU plus a global pool. A thread claims
+ * from the slab of the CPU it runs on; only when that slab runs dry does it
+ * refill it from the pool, and only when the pool is empty too does it take
+ * beds from the other slabs. Released beds go back to the thread's slab; a
+ * slab grown past its limit spills the excess to the pool, so few free beds
+ * stay on a CPU that no longer admits anyone. Every move is a CAS take
+ * followed by an add: a bed is never handed out twice.
+ *
+ * Between the take and the add of a move, its beds are in neither counter.
+ * Moves are counted, and a claim that comes up short scans again if a move
+ * was in progress or finished during its scan, so it never misses beds that
+ * were only in transit.
+ */
+class BedAllocator {
+public:
+    /**
+     * @param beds Free beds at start, all in the global pool.
+     * @param nbSlabs Number of slabs, clamped to [1, beds]; one per CPU by default.
+     */
+    explicit BedAllocator(int beds, int nbSlabs = defaultSlabCount());
+
+    /**
+     * @brief Claims up to qty beds.
+     * @return Beds claimed, less than qty only when fewer were free at some
+     *         point during the call (other threads may claim concurrently).
+     */
+    int claim(int qty);
+
+    /**
+     * @brief Gives back qty beds.
+     */
+    void release(int qty);
+
+    /**
+     * @brief Free beds, summed over the pool and the slabs. Exact only when no
+     *        claim or release is in progress.
+     */
+    [[nodiscard]] int available() const;
+
+    /**
+     * @brief Empties the slabs and leaves beds free beds, all in the pool.
+     *        Only when no other thread claims or releases (setup, snapshot restore).
+     */
+    void reset(int beds);
+
+    [[nodiscard]] int getSlabCount() const { return nbSlabs; }
+
+    /**
+     * @brief Online CPUs, between 1 and 64.
+     */
+    static int defaultSlabCount();
+
+private:
+    /// Une ligne de cache par slab : les CPU ne se disputent pas le même compteur
+    struct alignas(64) Slab {
+        std::atomic<int> beds{0};
+    };
+
+    [[nodiscard]] int currentSlab() const;
+
+    /**
+     * @brief One pass over the own slab, the pool and the other slabs.
+     * @return Beds taken, at most qty.
+     */
+    int scan(int self, int qty);
+
+    /**
+     * @brief Ends a move between the pool and a slab started by incrementing inTransit.
+     * @param moved Whether beds actually changed counter.
+     */
+    void endMove(bool moved);
+
+    /**
+     * @brief Takes up to qty from a counter without letting it go below 0.
+     */
+    static int takeFrom(std::atomic<int>& counter, int qty);
+
+    alignas(64) std::atomic<int> pool;
+    int nbSlabs;
+    int refill;      ///< Beds moved from the pool to a dry slab beyond the claim.
+    int slabLimit;   ///< Beds above which a release spills the slab back to refill beds.
+    std::unique_ptr<Slab[]> slabs;
+
+    alignas(64) std::atomic<int> inTransit{0};   ///< Moves between the pool and a slab in progress.
+    std::atomic<uint64_t> movesDone{0};          ///< Moves that changed beds of counter, ever.
+};
+
+#endif // BED_ALLOCATOR_H
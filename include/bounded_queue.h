@@ -0,0 +1,147 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace detail {
+
+/**
+ * @brief One slot of a bounded ring. The sequence number tells whether the
+ *        slot is ready to be written (== position) or read (== position + 1).
+ */
+template<typename T>
+struct RingCell {
+    std::atomic<size_t> sequence;
+    T value;
+};
+
+template<typename T>
+void ringInit(RingCell<T>* cells, size_t capacity) {
+    for (size_t i = 0; i < capacity; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template<typename T>
+bool ringPush(RingCell<T>* cells, size_t mask, std::atomic<size_t>& enqueuePos, const T& value) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        RingCell<T>& cell = cells[pos & mask];
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.value = value;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<typename T>
+bool ringPop(RingCell<T>* cells, size_t mask, std::atomic<size_t>& dequeuePos, T& out) {
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    while (true) {
+        RingCell<T>& cell = cells[pos & mask];
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                out = cell.value;
+                cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * @class BoundedQueue
+ * @brief Bounded lock-free ring queue, safe with many producers and many consumers.
+ *
+ * Each cell carries a sequence number telling whether it is ready to be written
+ * or read, so producers and consumers only synchronise on the cell they use.
+ * tryPush() fails when the ring is full, tryPop() when it is empty (or when the
+ * next producer has not finished writing yet). The capacity is rounded up to a
+ * power of two.
+ *
+ * @tparam T Trivially copyable element type.
+ */
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) capacity <<= 1;
+        mask = capacity - 1;
+        cells = std::make_unique<detail::RingCell<T>[]>(capacity);
+        detail::ringInit(cells.get(), capacity);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * @brief Appends a value without blocking.
+     * @return False if the queue is full.
+     */
+    bool tryPush(const T& value) { return detail::ringPush(cells.get(), mask, enqueuePos, value); }
+
+    /**
+     * @brief Removes the oldest value without blocking.
+     * @return False if the queue is empty.
+     */
+    bool tryPop(T& out) { return detail::ringPop(cells.get(), mask, dequeuePos, out); }
+
+    [[nodiscard]] size_t capacity() const { return mask + 1; }
+
+private:
+    std::unique_ptr<detail::RingCell<T>[]> cells;
+    size_t mask{0};
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0};
+};
+
+/**
+ * @class FixedBoundedQueue
+ * @brief Same ring as BoundedQueue with its cells stored inline, so that it
+ *        can be placed in memory shared between processes.
+ *
+ * @tparam T Trivially copyable element type.
+ * @tparam Capacity Number of cells, a power of two.
+ */
+template<typename T, size_t Capacity>
+class FixedBoundedQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::atomic<size_t>::is_always_lock_free, "Shared rings need address-free atomics");
+
+public:
+    FixedBoundedQueue() { detail::ringInit(cells, Capacity); }
+
+    FixedBoundedQueue(const FixedBoundedQueue&) = delete;
+    FixedBoundedQueue& operator=(const FixedBoundedQueue&) = delete;
+
+    bool tryPush(const T& value) { return detail::ringPush(cells, Capacity - 1, enqueuePos, value); }
+
+    bool tryPop(T& out) { return detail::ringPop(cells, Capacity - 1, dequeuePos, out); }
+
+    [[nodiscard]] static constexpr size_t capacity() { return Capacity; }
+
+private:
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0};
+    detail::RingCell<T> cells[Capacity];
+};
+
+#endif // BOUNDED_QUEUE_H
@@ -1,23 +1,42 @@
 #ifndef CLINIC_H
 #define CLINIC_H
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <utility>
 #include <vector>
 #include <pcosynchro/pcomutex.h>
 
+#include "actor_handle.h"
+#include "bounded_queue.h"
+#include "inventory_policy.h"
+#include "journal.h"
+#include "patient.h"
 #include "seller.h"
 #include "supplier.h"
 
+#define CLINIC_QUEUE_CAPACITY 64
+
 /**
  * @brief Represents a Clinic in the healthcare simulation.
  *
  * Inherits from Seller. Handles patient treatment, resource management,
  * billing with suppliers, and interaction with hospitals and insurance.
+ *
+ * Sick patients sent by hospitals go into a bounded lock-free queue that the
+ * clinic drains itself at the start of processNextPatient(); hospitals never
+ * take the clinic's lock. When the queue is full, hospitals keep their patients.
  */
 class Clinic : public Seller
 {
 public:
     /// Allows test classes to access protected/private members
     friend class TestableClinic;
+    /// Allows snapshots to save and restore the full state
+    friend class Snapshot;
 
     /**
      * @brief Constructs a Clinic with a unique ID, initial funds, and required resources.
@@ -36,7 +55,27 @@ public:
      * @param qty Quantity to transfer.
      * @return Amount of Sick Patients accepted in the transfer.
      */
-    int transfer(ItemType what, int qty) override;
+    int transfer(ItemType what, int qty) final;
+
+    /**
+     * @brief Claims room in the arrival queue for Sick Patients, if the clinic
+     *        has funds and no unpaid bills.
+     * @param what Item type to reserve, only SickPatient is accepted.
+     * @param qty Quantity requested.
+     * @return Ticket with the quantity accepted (at most the room left in the queue).
+     */
+    Reservation reserve(ItemType what, int qty) final;
+
+    /**
+     * @brief Pushes the reserved patients into the arrival queue.
+     * @return Patients queued: all those reserved.
+     */
+    int commit(Reservation& token) final;
+
+    /**
+     * @brief Gives the reserved room back to the arrival queue.
+     */
+    void abort(Reservation& token) final;
 
     /**
      * @brief Clinics cannot sell items
@@ -56,7 +95,18 @@ public:
      * @brief Receive a bill paiement (e.g., from insurance).
      * @param bill Bill amount.
      */
-    void pay(int bill) override;
+    void pay(int bill) final;
+
+    /**
+     * @brief Transfers and payments, applied without locking on phased days.
+     */
+    int applyIntent(const Intent& intent) override;
+
+    /**
+     * @brief Hands over the patients the hospitals accepted for rehab and
+     *        stocks the resources the suppliers sold.
+     */
+    void settleReplies(const std::vector<Intent>& replies) override;
 
 
     // Configuration
@@ -74,6 +124,17 @@ public:
      */
     void setInsurance(Seller* insurance);
 
+    /**
+     * @brief Sets how many patients the clinic may treat per day (at least 1).
+     */
+    void setTreatmentCapacity(int capacity);
+
+    /**
+     * @brief Replaces the policy deciding how much of each resource to order.
+     * @param makePolicy Called once per resource needed (on-demand by default).
+     */
+    void setInventoryPolicy(const InventoryPolicyFactory& makePolicy);
+
 
     // Simulation / operational methods
 
@@ -83,6 +144,17 @@ public:
      */
     void run();
 
+    /**
+     * @brief Today while patients have arrived or wait for rehab, a bill can be
+     *        paid, or waiting patients can be treated or resources bought for them.
+     */
+    int nextWorkDay(int today) override;
+
+    /**
+     * @brief True while hospitals cannot send patients: no funds or unpaid suppliers.
+     */
+    bool isWaitingForPayment() const override { return !accepting.load(std::memory_order_acquire); }
+
     /**
      * @brief Returns the cost of treating one patient.
      */
@@ -94,29 +166,69 @@ public:
     int getNumberPatients();
 
     /**
-     * @brief Returns the number of patients waiting for treatment.
+     * @brief Returns the number of patients waiting for treatment, queued ones included.
      */
     int getWaitingPatients();
 
+    [[nodiscard]] LockStats getLockStats() const override { return mutex.stats(); }
+
+    /**
+     * @brief Room left in the arrival queue, 0 while the clinic refuses patients.
+     */
+    int getFreeCapacity() const final {
+        return accepting.load(std::memory_order_acquire) ? arrivalsFree.load(std::memory_order_acquire) : 0;
+    }
+
+    /**
+     * @brief Patients here are counted under PatientHolder::Clinic.
+     */
+    PatientHolder patientHolder() const final { return PatientHolder::Clinic; }
+
+    /**
+     * @brief Returns the total amount still owed to suppliers.
+     */
+    int getUnpaidAmount();
+
+    /**
+     * @brief Resources consumed by each treatment.
+     */
+    const std::vector<ItemType>& getResourcesNeeded() const { return resourcesNeeded; }
+
+    /**
+     * @brief Stock of every item held, resources needed included.
+     */
+    std::map<ItemType, int> getStock() const override;
+
+    /**
+     * @brief Days on which patients waited but the resources in stock treated none of them.
+     */
+    int getStallDays() const { return nbStallDays; }
+
+    /**
+     * @brief Number of Supplier::buy() calls made so far.
+     */
+    int getPurchaseCalls() const { return nbPurchases; }
+
 private:
     // Internal helper methods
 
     /**
-     * @brief Orders missing resources from suppliers.
+     * @brief Chooses a random supplier for a given item, preferring those with stock.
+     * @param item The item type to source.
+     * @return Handle of the selected Supplier, empty if no supplier sells the item.
      */
-    void orderResources();
+    ResourceSeller chooseRandomSupplier(ItemType item);
 
     /**
-     * @brief Checks if clinic has all resources needed to treat one patient.
+     * @brief Units of an item a supplier has in stock: now, or at the end of
+     *        yesterday on phased days.
      */
-    [[nodiscard]] bool hasResourcesForTreatment() const;
+    [[nodiscard]] int supplierStock(const Supplier* supplier, ItemType item) const;
 
     /**
-     * @brief Chooses a random supplier for a given item.
-     * @param item The item type to source.
-     * @return Pointer to the selected Supplier.
+     * @brief Backlog: patients in the arrivals queue; unpaid: bills owed to suppliers.
      */
-    Supplier* chooseRandomSupplier(ItemType item);
+    void fillState(ActorState& state) override;
 
     /**
      * @brief Pays any unpaid bills to suppliers.
@@ -124,60 +236,237 @@ private:
     void payBills();
 
     /**
-     * @brief Processes the next patient if resources and funds allow.
+     * @brief Treats today's batch of patients, ordering resources first if the
+     *        stock cannot cover it.
      */
     void processNextPatient();
 
+    /**
+     * @brief Moves every patient of the arrival queue to the waiting patients.
+     */
+    void drainArrivals();
+
+    /**
+     * @brief Publishes whether hospitals may send patients. Called with the mutex held.
+     */
+    void publishAcceptance();
+
     /**
      * @brief Sends treated patients to rehabilitation facilities (hospitals).
+     *        On phased days they are offered, and the hospital answers tomorrow.
      */
     void sendPatientsToRehab();
 
+    /**
+     * @brief Takes the patients a hospital accepted for rehab out of the
+     *        clinic and invoices their treatment; the others offered are refused.
+     */
+    void handOver(const Seller* hospital, int offered, int accepted);
+
+    /**
+     * @brief Stocks resources bought from a supplier and records the bill to pay.
+     */
+    void receiveResources(Supplier* supplier, ItemType item, int qty);
+
 
     // Attributes
 
     std::vector<Seller*> suppliers;               ///< List of resource suppliers
     std::vector<Seller*> hospitals;               ///< Associated hospitals
     Seller* insurance = nullptr;                  ///< Associated insurance
+    std::vector<PatientReceiver> hospitalHandles; ///< Same hospitals, called without virtual dispatch
+    std::vector<ResourceSeller> supplierHandles;  ///< Same suppliers, called without virtual dispatch
+    InsuranceHandle insuranceHandle;              ///< Same insurance, called without virtual dispatch
 
     std::vector<std::pair<Supplier*, int>> unpaidBills; ///< List of unpaid bills to suppliers
 
     const std::vector<ItemType> resourcesNeeded; ///< Resources required for treatment
+    int treatmentCapacity = 1;                    ///< Maximum number of patients treated per day
+    std::vector<std::unique_ptr<InventoryPolicy>> inventoryPolicies; ///< One policy per resource needed, same order
+
+    int nbStallDays = 0;                          ///< Days stalled by missing resources (clinic thread only)
+    int nbPurchases = 0;                          ///< Supplier::buy() calls (clinic thread only)
+
+    BoundedQueue<PatientHandle> arrivals{CLINIC_QUEUE_CAPACITY}; ///< Sick patients sent by hospitals, not drained yet
+    std::atomic<int> arrivalsFree{CLINIC_QUEUE_CAPACITY};         ///< Room left in arrivals, reservations excluded
+    std::atomic<int> nbArrived{0};                ///< Patients in arrivals
+    int* sickStock;                               ///< Entry of stocks for sick patients, read without a map lookup
+    int* rehabStock;                              ///< Entry of stocks for rehab patients
+    std::atomic<bool> accepting{false};           ///< Funds left and no unpaid bills, read by hospitals
 
-    int queueSick = 0;                            ///< Number of patients waiting for treatment
+    std::deque<PatientHandle> waitingPatients;    ///< Tracked waiting patients (only when tracking is enabled)
+    std::deque<PatientHandle> treatedPatients;    ///< Tracked treated patients waiting for rehab
+
+    ProfiledMutex mutex;                          ///< Protects stocks, money and unpaid bills
 
 protected:
+    /**
+     * @brief Orders resources from suppliers, one buy() per item.
+     */
+    virtual void orderResources();
+
+    /**
+     * @brief Orders one resource: a single buy(), as much as its inventory
+     *        policy asks and the chosen supplier has in stock. On phased days
+     *        the purchase is answered tomorrow, and settleReplies() stocks it.
+     * @param index Position of the resource in resourcesNeeded and inventoryPolicies.
+     * @param stock Entry holding the stock of the resource, updated under the mutex.
+     */
+    void orderResource(size_t index, int& stock);
+
+    /**
+     * @brief Stock of a resource needed, read by the monitoring and snapshot paths.
+     */
+    [[nodiscard]] virtual int getResourceStock(ItemType item) const;
+
+    /**
+     * @brief Sets the stock of a resource needed (snapshot restore, tests).
+     */
+    virtual void setResourceStock(ItemType item, int qty);
+
+    /**
+     * @brief Checks if clinic has all resources needed to treat one patient.
+     */
+    [[nodiscard]] virtual bool hasResourcesForTreatment() const;
+
+    /**
+     * @brief Number of patients the resources in stock can treat.
+     */
+    [[nodiscard]] virtual int treatableWithStock() const;
+
+    /**
+     * @brief Takes the resources of n treatments from the stock. Called with the mutex held.
+     */
+    virtual void consumeResources(int n);
+
     /**
      * @brief Treats a single patient.
      */
     virtual void treatOne();
+
+    /**
+     * @brief Treats as many patients as stock, funds and maxPatients allow, in one step:
+     *        resources are consumed and specialists paid for the whole batch.
+     * @return Number of patients treated.
+     */
+    virtual int treatPatients(int maxPatients);
+
+    /**
+     * @brief Body of treatPatients(), with the stock checks passed in so that
+     *        ClinicT can inline them.
+     * @param treatable Number of treatments the stock covers. Called with the mutex held.
+     * @param consume Takes the resources of n treatments. Called with the mutex held.
+     */
+    template<typename Treatable, typename Consume>
+    int treatBatch(int maxPatients, Treatable&& treatable, Consume&& consume);
 };
 
+template<typename Treatable, typename Consume>
+int Clinic::treatBatch(int maxPatients, Treatable&& treatable, Consume&& consume) {
+    int salary = getEmployeeSalary(EmployeeType::TreatmentSpecialist);
+
+    mutex.lock();
+    int n = std::min({maxPatients, *sickStock, treatable(), money / salary});
+    if (n <= 0) {
+        mutex.unlock();
+        return 0;
+    }
+
+    consume(n);
+    money -= n * salary;
+    nbEmployeesPaid += n;
+    *sickStock -= n;
+    *rehabStock += n;
+    for (int i = 0; i < n; ++i) {
+        patientTracker().advance(waitingPatients, treatedPatients, PatientStage::Treated);
+    }
+    publishAcceptance();
+    mutex.unlock();
+    journal().record(EventType::Salary, uniqueId, -1, ItemType::Nothing, n, n * salary);
+    return n;
+}
+
 
 // Specialized clinic types
 
 /**
- * @brief Pulmonology Clinic specialization.
+ * @brief Clinic whose resources are known at compile time.
+ *
+ * The stock of the resources lives in a fixed array indexed like Items, out
+ * of the stocks map. Treating and ordering are expanded over the pack: the
+ * per-item checks are inlined, with no map lookup, no loop over
+ * resourcesNeeded and no virtual call inside a batch.
  */
-class Pulmonology : public Clinic {
-public:
-    Pulmonology(int uniqueId, int fund);
-};
+template<ItemType... Items>
+class ClinicT : public Clinic {
+    static_assert(sizeof...(Items) > 0, "A clinic needs at least one resource");
 
-/**
- * @brief Cardiology Clinic specialization.
- */
-class Cardiology : public Clinic {
 public:
-    Cardiology(int uniqueId, int fund);
-};
+    ClinicT(int uniqueId, int fund)
+    : Clinic(uniqueId, fund, {Items...}) {
+        // Le stock des ressources est dans resourceStock, pas dans la map
+        (stocks.erase(Items), ...);
+    }
 
-/**
- * @brief Neurology Clinic specialization.
- */
-class Neurology : public Clinic {
-public:
-    Neurology(int uniqueId, int fund);
+protected:
+    void orderResources() final {
+        orderEach(std::make_index_sequence<sizeof...(Items)>{});
+    }
+
+    [[nodiscard]] int getResourceStock(ItemType item) const final {
+        size_t i = indexOf(item);
+        return i < resourceStock.size() ? resourceStock[i] : 0;
+    }
+
+    void setResourceStock(ItemType item, int qty) final {
+        size_t i = indexOf(item);
+        if (i < resourceStock.size()) resourceStock[i] = qty;
+    }
+
+    [[nodiscard]] bool hasResourcesForTreatment() const final {
+        return std::all_of(resourceStock.begin(), resourceStock.end(), [](int qty) { return qty >= 1; });
+    }
+
+    [[nodiscard]] int treatableWithStock() const final { return treatable(); }
+
+    void consumeResources(int n) final { consume(n); }
+
+    void treatOne() final { ClinicT::treatPatients(1); }
+
+    int treatPatients(int maxPatients) final {
+        return treatBatch(maxPatients, [this] { return treatable(); }, [this](int n) { consume(n); });
+    }
+
+private:
+    static constexpr std::array<ItemType, sizeof...(Items)> ITEMS{Items...};
+
+    static constexpr size_t indexOf(ItemType item) {
+        size_t i = 0;
+        while (i < ITEMS.size() && ITEMS[i] != item) ++i;
+        return i;
+    }
+
+    template<size_t... I>
+    void orderEach(std::index_sequence<I...>) {
+        (orderResource(I, resourceStock[I]), ...);
+    }
+
+    int treatable() const {
+        return *std::min_element(resourceStock.begin(), resourceStock.end());
+    }
+
+    void consume(int n) {
+        for (int& qty : resourceStock) qty -= n;
+    }
+
+    std::array<int, sizeof...(Items)> resourceStock{}; ///< Stock of each resource, in the order of Items
 };
 
+/// Pulmonology Clinic specialization.
+using Pulmonology = ClinicT<ItemType::Pill, ItemType::Thermometer>;
+/// Cardiology Clinic specialization.
+using Cardiology = ClinicT<ItemType::Syringe, ItemType::Stethoscope>;
+/// Neurology Clinic specialization.
+using Neurology = ClinicT<ItemType::Pill, ItemType::Scalpel>;
+
 #endif /* CLINIC_H */
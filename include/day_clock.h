@@ -1,49 +1,160 @@
 #ifndef DAY_CLOCK_H
 #define DAY_CLOCK_H
 
-#include <pcosynchro/pcosemaphore.h>
+#include <pcosynchro/pcoconditionvariable.h>
+#include <pcosynchro/pcomutex.h>
 #include <atomic>
+#include <chrono>
+#include <functional>
 
+#include "wait_histogram.h"
+
+class Seller;
+
+/**
+ * @brief Day barrier between the main thread and the actor threads.
+ *
+ * Workers wait for a day to be started, run it, then wait until every other
+ * participant is done too. A worker can neither start a day before the main
+ * thread started it, nor leave a day before it is over: a fast worker never
+ * runs the next day in place of a slow one.
+ */
 class DayClock {
 public:
     DayClock(int participants)
-        : participants(participants),
-        start_sem(0), done_sem(0), done_sem2(0), day(0) {}
+        : participants(participants), day(0) {}
 
-    void start_next_day() {
-        for (int i = 0; i < participants; ++i) {
-            start_sem.release();
-        }
+    virtual ~DayClock() = default;
+
+    virtual void start_next_day() {
+        mutex.lock();
+        ++started;
+        dayStarted.notifyAll();
+        mutex.unlock();
     }
 
-    void wait_all_done() {
-        for (int i = 0; i < participants; ++i) {
-            done_sem.acquire();
-        }
-        for (int i = 0; i < participants; ++i) {
-            done_sem2.release();
-        }
+    virtual void wait_all_done() {
+        mutex.lock();
+        while (arrived < participants) allArrived.wait(&mutex);
+        arrived = 0;
         ++day;
+        dayOver.notifyAll();
+        mutex.unlock();
+    }
+
+    virtual void worker_wait_day_start() {
+        mutex.lock();
+        while (started <= day) dayStarted.wait(&mutex);
+        mutex.unlock();
+    }
+
+    /**
+     * @brief Same as worker_wait_day_start(), for clocks that only wake the
+     *        actors having work today.
+     * @param who Actor run by the calling thread.
+     */
+    virtual void worker_wait_day_start(Seller* /*who*/) {
+        worker_wait_day_start();
     }
 
-    void worker_wait_day_start() {
-        start_sem.acquire();
+    virtual void worker_end_day() {
+        auto start = std::chrono::steady_clock::now();
+        mutex.lock();
+        int today = day;
+        if (++arrived == participants) allArrived.notifyOne();
+        while (day == today) dayOver.wait(&mutex);
+        mutex.unlock();
+        barrierWaits.add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count()));
     }
 
-    void worker_end_day() {
-        done_sem.release();
-        done_sem2.acquire();
+    /**
+     * @brief Barrier between two phases of a day: returns once every worker
+     *        reached it, and the phase step, if any, ran.
+     */
+    virtual void worker_phase_barrier() {
+        mutex.lock();
+        int phase = phases;
+        if (++inPhase == participants) {
+            // Personne ne quitte la barrière avant la fin de l'étape
+            if (phaseStep) phaseStep();
+            inPhase = 0;
+            ++phases;
+            phaseOver.notifyAll();
+        }
+        while (phases == phase) phaseOver.wait(&mutex);
+        mutex.unlock();
+    }
+
+    /**
+     * @brief Sets a step run once per phase barrier, by the last worker to
+     *        reach it, while the others wait. Only before the workers start.
+     */
+    void set_phase_step(std::function<void()> step) {
+        phaseStep = std::move(step);
+    }
+
+    /**
+     * @brief Wakes every worker once more, after they were asked to stop.
+     */
+    virtual void release_workers() {
+        start_next_day();
     }
 
     [[nodiscard]] int current_day() const {
-        return day.load(); 
+        return day.load();
+    }
+
+    /**
+     * @brief Time workers waited at the end of a day for the others, read without locking.
+     *        Only filled by clocks that make workers wait there.
+     */
+    [[nodiscard]] const WaitHistogram& getBarrierWaits() const {
+        return barrierWaits;
+    }
+
+    /**
+     * @brief First day of this run: 0, or the day a snapshot was restored at.
+     */
+    [[nodiscard]] int first_day() const {
+        return firstDay;
+    }
+
+    // Only between two days, e.g. when restoring a snapshot
+    void set_current_day(int d) {
+        mutex.lock();
+        day = d;
+        started = d;
+        firstDay = d;
+        mutex.unlock();
+    }
+
+protected:
+    WaitHistogram barrierWaits;
+
+    /// Called by subclasses that synchronise days by other means
+    void advance_day() {
+        ++day;
+    }
+
+    /// Called by subclasses that jump over days
+    void jump_to_day(int d) {
+        day = d;
     }
 
 private:
     const int participants;
-    PcoSemaphore start_sem;
-    PcoSemaphore done_sem;
-    PcoSemaphore done_sem2;
+    PcoMutex mutex;
+    PcoConditionVariable dayStarted;
+    PcoConditionVariable allArrived;
+    PcoConditionVariable dayOver;
+    PcoConditionVariable phaseOver;
+    int started{0};  ///< Number of days started by the main thread
+    int arrived{0};  ///< Workers done with the current day
+    int firstDay{0};
+    int inPhase{0};  ///< Workers waiting at the phase barrier
+    int phases{0};   ///< Number of phase barriers passed
+    std::function<void()> phaseStep;  ///< Run by the last worker at each phase barrier
     std::atomic<int> day;
 };
 
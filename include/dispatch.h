@@ -0,0 +1,47 @@
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief How an ambulance chooses where to take its patients.
+ */
+enum class DispatchMode {
+    Random,        ///< One random hospital, whatever its free beds.
+    FreeCapacity   ///< Patients split in proportion to the published free beds.
+};
+
+/**
+ * @brief Parses "random" or "capacity".
+ * @throws std::invalid_argument On an unknown mode.
+ */
+DispatchMode parseDispatchMode(const std::string& description);
+
+/**
+ * @brief One transfer call of a dispatch plan.
+ */
+struct Trip {
+    size_t target;  ///< Index of the hospital in the list given to planTrips().
+    int qty;        ///< Patients sent.
+};
+
+/**
+ * @brief Splits patients over hospitals in proportion to their free capacity.
+ *
+ * Each hospital gets the integer part of its share of the patients; the
+ * patients left go one each to the hospitals with the largest remainders
+ * (largest remainder method), ties going to the hospital with the most room,
+ * then to the first one. No hospital gets more than its free capacity, and
+ * patients beyond the total free capacity are not planned. Hospitals whose
+ * share rounds to 0 get no trip; the others get one each, so a day may need
+ * up to one trip per hospital.
+ *
+ * @param patients Patients to send.
+ * @param freeCapacity Free capacity of each hospital; a negative value means
+ *        unknown, and is taken as room for every patient.
+ * @return One trip per hospital receiving patients, in the order of freeCapacity.
+ */
+std::vector<Trip> planTrips(int patients, const std::vector<int>& freeCapacity);
+
+#endif // DISPATCH_H
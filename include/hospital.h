@@ -1,10 +1,16 @@
 #ifndef HOSPITAL_H
 #define HOSPITAL_H
 
+#include <atomic>
 #include <vector>
 #include <pcosynchro/pcomutex.h>
+#include "actor_handle.h"
+#include "bed_allocator.h"
+#include "bounded_queue.h"
 #include "seller.h"
 
+#define REHAB_DURATION_DAYS 5
+
 /**
  * @class Hospital
  * @brief Represents a hospital that receives and treats patients coming from ambulances or clinics.
@@ -12,10 +18,15 @@
  * The Hospital class inherits from Seller and models a healthcare unit capable of admitting
  * patients (both sick and in rehabilitation), managing available beds, and coordinating with
  * clinics and insurance entities. It also handles the internal economic logic such as paying staff.
+ *
+ * Rehab patients sent by clinics go into a bounded lock-free queue, sized to the
+ * number of beds, that the hospital drains itself at the start of updateRehab().
  */
 class Hospital : public Seller {
 public:
     friend class TestableHospital;
+    /// Allows snapshots to save and restore the full state
+    friend class Snapshot;
 
     /**
      * @brief Constructs a Hospital instance.
@@ -32,7 +43,30 @@ public:
      * @param qty Quantity of patients to transfer.
      * @return Number of patients accepted by the hospital.
      */
-    int transfer(ItemType what, int qty) override;
+    int transfer(ItemType what, int qty) final;
+
+    /**
+     * @brief Claims up to qty free beds for incoming patients.
+     *
+     * Beds are taken from a lock-free counter; sick patients are only
+     * accepted while the hospital still has funds.
+     * @param what SickPatient or RehabPatient, anything else is refused.
+     * @param qty Number of beds requested.
+     * @return Ticket holding the beds actually claimed.
+     */
+    Reservation reserve(ItemType what, int qty) final;
+
+    /**
+     * @brief Admits the patients of a reservation. Rehab patients are queued
+     *        and get their timer when updateRehab() drains them.
+     * @return Patients admitted: all those reserved.
+     */
+    int commit(Reservation& token) final;
+
+    /**
+     * @brief Gives the beds of a reservation back to the free pool.
+     */
+    void abort(Reservation& token) final;
 
     /**
      * @brief Hospital do not sell resources.
@@ -54,7 +88,19 @@ public:
      * @brief Receives a payment (e.g., from an insurance company).
      * @param bill Amount of the payment.
      */
-    void pay(int bill) override;
+    void pay(int bill) final;
+
+    /**
+     * @brief Transfers and payments, applied without locking on phased days:
+     *        sick patients are admitted at once, rehab patients start their
+     *        rehabilitation at the next updateRehab().
+     */
+    int applyIntent(const Intent& intent) override;
+
+    /**
+     * @brief Hands over the sick patients the clinics accepted.
+     */
+    void settleReplies(const std::vector<Intent>& replies) override;
 
     /**
      * @brief Defines the list of associated clinics to which the hospital
@@ -75,6 +121,21 @@ public:
      */
     int getNumberPatients();
 
+    [[nodiscard]] LockStats getLockStats() const override { return mutex.stats(); }
+
+    /**
+     * @brief Beds neither occupied nor reserved, published for ambulance dispatch;
+     *        0 while the hospital has no funds, since it then refuses sick patients.
+     */
+    int getFreeCapacity() const final {
+        return hasFunds.load(std::memory_order_acquire) ? beds.available() : 0;
+    }
+
+    /**
+     * @brief Patients here are counted under PatientHolder::Hospital.
+     */
+    PatientHolder patientHolder() const final { return PatientHolder::Hospital; }
+
     /**
      * @brief Main operational routine for the hospital.
      *
@@ -84,30 +145,69 @@ public:
      */
     void run();
 
+    /**
+     * @brief Today while there are patients to send or staff to pay, otherwise
+     *        the day of the next end of rehabilitation.
+     */
+    int nextWorkDay(int today) override;
+
 private:
     /**
      * @brief Transfers recovered or stable patients to associated clinics.
+     *        On phased days they are offered, and the clinic answers tomorrow.
      */
     void transferSickPatientsToClinic();
 
+    /**
+     * @brief Takes the patients a clinic accepted out of the hospital, frees
+     *        their beds and invoices their stay; the others offered are refused.
+     */
+    void handOver(const Seller* clinic, int offered, int accepted);
+
     /**
      * @brief Updates rehabilitation status of patients, decrementing remaining days.
      *        Frees beds when rehabilitation is complete.
+     * @param days Days elapsed since the previous update.
      */
-    void updateRehab();
+    void updateRehab(int days = 1);
 
     /**
      * @brief Handles continuous operational costs such as paying nursing staff.
      */
     void payNursingStaff();
 
+    /**
+     * @brief Backlog: sick patients waiting for a clinic and rehab patients not yet admitted.
+     */
+    void fillState(ActorState& state) override;
+
 private:
     std::vector<Seller*> clinics;  ///< Clinics associated with this hospital.
     Seller* insurance = nullptr;   ///< Linked insurance provider.
+    std::vector<PatientReceiver> clinicHandles; ///< Same clinics, called without virtual dispatch.
+    InsuranceHandle insuranceHandle;            ///< Same insurance, called without virtual dispatch.
 
     int maxBeds;                   ///< Maximum number of patients the hospital can accommodate.
     int nbNursingStaff;            ///< Number of nursing staff employed.
     int nbFreed = 0;               ///< Number of patients who have completed treatment and left the hospital.
+    int* sickStock;                ///< Entry of stocks for sick patients, read without a map lookup.
+    int* rehabStock;               ///< Entry of stocks for rehab patients.
+
+    BedAllocator beds;             ///< Beds neither occupied nor reserved.
+    std::atomic<bool> hasFunds;    ///< Mirror of money > 0, written under the mutex.
+    /// One rehab patient: its remaining days and, when tracked, its record.
+    struct RehabTimer {
+        int daysLeft;
+        PatientHandle patient;     ///< NO_PATIENT when tracking is off or the patient has no record.
+    };
+    std::vector<RehabTimer> rehabTimers; ///< One entry per rehab patient.
+
+    std::deque<PatientHandle> sickPatients;  ///< Tracked sick patients (only when tracking is enabled).
+
+    BoundedQueue<PatientHandle> rehabArrivals; ///< Rehab patients sent by clinics, not drained yet.
+    std::atomic<int> nbRehabArrived{0};        ///< Patients in rehabArrivals.
+
+    ProfiledMutex mutex;           ///< Protects stocks, money and rehab timers.
 };
 
 #endif // HOSPITAL_H
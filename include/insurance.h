@@ -2,6 +2,7 @@
 #define INSURANCE_H
 
 #include <pcosynchro/pcomutex.h>
+#include "payment_scheduler.h"
 #include "seller.h"
 
 /**
@@ -15,6 +16,8 @@
 class Insurance : public Seller {
 public:
     friend class TestableInsurance;
+    /// Allows snapshots to save and restore the full state
+    friend class Snapshot;
 
     /**
      * @brief Constructs an Insurance instance.
@@ -56,7 +59,13 @@ public:
      * @param bill Amount of the bill.
      * @param who Pointer to the Seller (hospital or clinic) who issued the invoice.
      */
-    void invoice(int bill, Seller* who) override;
+    void invoice(int bill, Seller* who) final;
+
+    /**
+     * @brief Invoices, applied without locking on phased days. The beneficiary
+     *        is the proxy of the provider, so that its payment is deferred too.
+     */
+    int applyIntent(const Intent& intent) override;
 
     /**
      * @brief Main execution loop of the insurance entity.
@@ -67,25 +76,68 @@ public:
      */
     void run();
 
+    /**
+     * @brief Day on which the contributions received since the last run cover
+     *        the oldest unpaid invoice; no work without invoices.
+     *
+     * Contributions of the days skipped are received at once on the next run.
+     */
+    int nextWorkDay(int today) override;
+
+    /**
+     * @brief Returns the total amount of invoices not paid yet.
+     */
+    int getUnpaidAmount();
+
+    [[nodiscard]] LockStats getLockStats() const override { return mutex.stats(); }
+
+    /**
+     * @brief Sets the order, partial payments and default credit limit of payments.
+     */
+    void setPaymentPolicy(const PaymentPolicy& policy);
+
+    /**
+     * @brief Overdraft the insurance may run to pay the invoices of one provider.
+     */
+    void setCreditLimit(const Seller* who, int limit);
+
+    /**
+     * @brief Overdraft allowed for one provider, its own or the policy's.
+     */
+    int getCreditLimit(const Seller* who);
+
+    /**
+     * @brief Overdraft one provider can still be paid with, given the credit
+     *        drawn for it and not repaid yet.
+     */
+    int getCreditLeft(const Seller* who);
+
 private:
     /**
      * @brief Simulates the reception of periodic insurance contributions.
      *
      * This function increases the available funds, representing
      * the income from insured individuals or institutions.
+     * @param days Days of contributions to receive.
      */
-    void receiveContributions();
+    void receiveContributions(int days = 1);
 
     /**
      * @brief Processes and pays pending bills from healthcare providers.
      *
-     * Iterates over the list of unpaid invoices, deducts the corresponding
-     * amounts from available funds, and sends payments to the respective Sellers.
+     * Pays the invoices in the order of the payment scheduler while funds and
+     * credit allow, and sends payments to the respective Sellers.
      */
     void payBills();
 
+    /**
+     * @brief Unpaid: invoices not paid yet.
+     */
+    void fillState(ActorState& state) override;
+
 private:
-    std::vector<std::pair<Seller*, int>> unpaidBills; ///< List of healthcare providers (Sellers) awaiting payment and their corresponding bill amounts.
+    PaymentScheduler unpaidBills;                     ///< Invoices of healthcare providers awaiting payment, in payment order.
+    ProfiledMutex mutex;                              ///< Protects money and unpaid bills.
 };
 
 #endif // INSURANCE_H
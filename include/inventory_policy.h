@@ -0,0 +1,95 @@
+#ifndef INVENTORY_POLICY_H
+#define INVENTORY_POLICY_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+
+/**
+ * @brief What a clinic knows about one resource when it decides to order.
+ */
+struct InventoryState {
+    int stock;      ///< Units in stock.
+    int waiting;    ///< Patients waiting for treatment (arrival queue included).
+    int capacity;   ///< Patients the clinic may treat per day.
+};
+
+/**
+ * @class InventoryPolicy
+ * @brief Decides how many units of one resource a clinic buys.
+ *
+ * A clinic keeps one policy instance per resource it needs. It asks
+ * orderQuantity() each day it has patients, and reports at the end of every
+ * day how many units were consumed.
+ */
+class InventoryPolicy {
+public:
+    virtual ~InventoryPolicy() = default;
+
+    /**
+     * @brief Number of units to buy now, 0 for none.
+     */
+    virtual int orderQuantity(const InventoryState& state) = 0;
+
+    /**
+     * @brief Units consumed during the day that just ended.
+     */
+    virtual void recordDay(int /*consumed*/) {}
+};
+
+/// Builds a fresh policy for each resource of a clinic.
+using InventoryPolicyFactory = std::function<std::unique_ptr<InventoryPolicy>()>;
+
+/**
+ * @brief Buys exactly what today's batch is missing (the original behaviour).
+ */
+class OnDemandPolicy : public InventoryPolicy {
+public:
+    int orderQuantity(const InventoryState& state) override;
+};
+
+/**
+ * @brief (s, S) policy: once the stock left after today's batch falls to the
+ *        reorder point s or below, refill it up to S.
+ */
+class ReorderPointPolicy : public InventoryPolicy {
+public:
+    ReorderPointPolicy(int reorderPoint, int orderUpTo);
+    int orderQuantity(const InventoryState& state) override;
+
+private:
+    int reorderPoint;
+    int orderUpTo;
+};
+
+/**
+ * @brief Keeps enough stock for today's batch plus coverDays of average
+ *        consumption, measured over the last window days.
+ */
+class MovingAverageDemandPolicy : public InventoryPolicy {
+public:
+    MovingAverageDemandPolicy(int window, int coverDays);
+    int orderQuantity(const InventoryState& state) override;
+    void recordDay(int consumed) override;
+
+    /**
+     * @brief Average consumption per day over the window.
+     */
+    [[nodiscard]] double averageDemand() const;
+
+private:
+    size_t window;
+    int coverDays;
+    std::deque<int> history;
+    int sum = 0;
+};
+
+/**
+ * @brief Builds a factory from a textual description: "on-demand",
+ *        "sS:s:S" or "moving-average:window:cover".
+ * @throws std::invalid_argument If the description is not recognised.
+ */
+InventoryPolicyFactory parseInventoryPolicy(const std::string& description);
+
+#endif // INVENTORY_POLICY_H
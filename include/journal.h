@@ -0,0 +1,184 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <pcosynchro/pcomutex.h>
+
+#include "seller.h"
+
+/**
+ * @brief Kind of event recorded in the journal.
+ */
+enum class EventType : uint8_t {
+    Initial,       ///< Starting state of an actor: amount = funds, qty = patients.
+    Transfer,      ///< qty patients of type item moved from -> to.
+    Buy,           ///< to bought qty items from from, amount = bill (paid later).
+    Invoice,       ///< from invoiced to (the insurance) for amount.
+    Pay,           ///< from paid amount to to.
+    Salary,        ///< from paid amount to its employees.
+    Contribution   ///< to (the insurance) received amount from insured people.
+};
+
+/**
+ * @brief Fixed-size binary journal record (32 bytes).
+ */
+struct JournalEvent {
+    uint64_t timestamp;  ///< Steady clock, in nanoseconds.
+    int32_t day;         ///< Simulation day the event belongs to.
+    int32_t from;        ///< Unique id of the emitting actor (-1 if none).
+    int32_t to;          ///< Unique id of the receiving actor (-1 if none).
+    int32_t qty;         ///< Number of items or patients.
+    int32_t amount;      ///< Money involved.
+    EventType type;
+    ItemType item;
+    uint16_t padding;
+};
+
+/**
+ * @brief Header at the start of every journal segment file.
+ */
+struct JournalSegmentHeader {
+    char magic[8];       ///< "PCOJRNL".
+    uint32_t version;
+    uint32_t eventSize;  ///< sizeof(JournalEvent) of the writer.
+    uint64_t count;      ///< Number of valid events following the header.
+    uint8_t reserved[40];
+};
+
+/**
+ * @class JournalSegments
+ * @brief Every segment of a journal directory, mapped read-only until destruction.
+ */
+class JournalSegments {
+public:
+    /// Events of one segment, in timestamp order.
+    struct Segment {
+        const JournalEvent* events;
+        uint64_t count;
+    };
+
+    /**
+     * @throws std::runtime_error If a segment is unreadable or corrupt.
+     */
+    explicit JournalSegments(const std::string& directory);
+    ~JournalSegments();
+
+    JournalSegments(const JournalSegments&) = delete;
+    JournalSegments& operator=(const JournalSegments&) = delete;
+
+    [[nodiscard]] const std::vector<Segment>& all() const { return segments; }
+
+private:
+    std::vector<Segment> segments;
+    std::vector<std::pair<void*, size_t>> mappings;
+};
+
+/**
+ * @class Journal
+ * @brief Append-only audit trail of transfers, purchases, invoices and payments.
+ *
+ * Every thread appends fixed-size records to its own memory-mapped segment file,
+ * so recording never takes a lock. Segments are merged by timestamp when the
+ * journal is replayed. When the journal is not open, record() returns at once.
+ */
+class Journal {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    Journal();
+    ~Journal();
+
+    /**
+     * @brief Starts journaling into a directory (created if needed, old segments removed).
+     * @throws std::runtime_error If the directory cannot be used.
+     */
+    void open(const std::string& directory);
+
+    /**
+     * @brief Flushes and truncates every segment, then stops journaling.
+     *        Must only be called once no thread records anymore.
+     */
+    void close();
+
+    [[nodiscard]] bool isOpen() const { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Sets the day stamped on the next records (called between two days).
+     */
+    void setDay(int d) { day.store(d, std::memory_order_relaxed); }
+
+    /**
+     * @brief Appends one event to the calling thread's segment.
+     */
+    void record(EventType type, int from, int to, ItemType item, int qty, int amount);
+
+    /**
+     * @brief Streams every event of a journal directory in timestamp order.
+     *
+     * The visitor is inlined into the merge loop, which reads the mapped
+     * segments in place and allocates nothing per event.
+     * @param directory Directory written by open()/close().
+     * @param visit Called once per event with a const JournalEvent&.
+     * @throws std::runtime_error If a segment is corrupt.
+     */
+    template<typename Visit>
+    static void replay(const std::string& directory, Visit&& visit);
+
+private:
+    struct Segment;
+
+    /**
+     * @brief Returns the segment of the calling thread, creating it on first use.
+     */
+    Segment* localSegment();
+
+    std::atomic<bool> enabled{false};
+    std::atomic<int> day{0};
+    std::atomic<uint64_t> generation{0};   ///< Identifies this opening, invalidates stale thread-local segments.
+    std::string directory;
+    std::vector<std::unique_ptr<Segment>> segments;
+    PcoMutex mutex;                        ///< Protects segments (registration only).
+};
+
+template<typename Visit>
+void Journal::replay(const std::string& directory, Visit&& visit) {
+    JournalSegments input(directory);
+    const auto& segments = input.all();
+
+    // Fusion k-voies sur un tas de têtes de segment, chacun déjà trié par horodatage
+    using Head = std::pair<uint64_t, size_t>;
+    std::vector<uint64_t> next(segments.size(), 0);
+    std::vector<Head> heads;
+    heads.reserve(segments.size());
+    for (size_t i = 0; i < segments.size(); ++i) {
+        if (segments[i].count > 0) heads.emplace_back(segments[i].events[0].timestamp, i);
+    }
+    std::make_heap(heads.begin(), heads.end(), std::greater<>());
+
+    while (!heads.empty()) {
+        std::pop_heap(heads.begin(), heads.end(), std::greater<>());
+        size_t i = heads.back().second;
+        const JournalSegments::Segment& segment = segments[i];
+        visit(segment.events[next[i]]);
+        if (++next[i] < segment.count) {
+            heads.back() = {segment.events[next[i]].timestamp, i};
+            std::push_heap(heads.begin(), heads.end(), std::greater<>());
+        } else {
+            heads.pop_back();
+        }
+    }
+}
+
+/**
+ * @brief Returns the global journal of the simulation.
+ */
+Journal& journal();
+
+#endif // JOURNAL_H
@@ -0,0 +1,68 @@
+#ifndef LOCK_STATS_H
+#define LOCK_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <pcosynchro/pcomutex.h>
+
+/**
+ * @brief How often a mutex was taken and how often callers had to wait for it.
+ */
+struct LockStats {
+    uint64_t acquisitions{0};
+    uint64_t contended{0};   ///< Acquisitions that found the mutex held.
+    uint64_t waitNs{0};      ///< Time spent waiting in contended acquisitions.
+};
+
+/**
+ * @class ProfiledMutex
+ * @brief PcoMutex that counts its contended acquisitions.
+ *
+ * lock() first tries the mutex; only when that fails does it read the clock
+ * and block. Counters are updated once the mutex is held, so each is written
+ * by one thread at a time with plain relaxed stores: an uncontended lock()
+ * costs one trylock more than a PcoMutex. stats() may be called from any
+ * thread without taking the mutex.
+ */
+class ProfiledMutex {
+public:
+    void lock() {
+        if (mutex.trylock()) {
+            bump(acquisitions, 1);
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        mutex.lock();
+        auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        bump(acquisitions, 1);
+        bump(contended, 1);
+        bump(waitNs, static_cast<uint64_t>(waited.count()));
+    }
+
+    bool trylock() {
+        if (!mutex.trylock()) return false;
+        bump(acquisitions, 1);
+        return true;
+    }
+
+    void unlock() { mutex.unlock(); }
+
+    [[nodiscard]] LockStats stats() const {
+        return {acquisitions.load(std::memory_order_relaxed), contended.load(std::memory_order_relaxed),
+                waitNs.load(std::memory_order_relaxed)};
+    }
+
+private:
+    /// Appelé avec le mutex tenu : pas besoin d'une opération atomique de lecture-écriture
+    static void bump(std::atomic<uint64_t>& counter, uint64_t by) {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    PcoMutex mutex;
+    std::atomic<uint64_t> acquisitions{0};
+    std::atomic<uint64_t> contended{0};
+    std::atomic<uint64_t> waitNs{0};
+};
+
+#endif // LOCK_STATS_H
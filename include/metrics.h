@@ -0,0 +1,99 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <pcosynchro/pcoconditionvariable.h>
+#include <pcosynchro/pcomutex.h>
+#include <pcosynchro/pcothread.h>
+
+#include "ambulance.h"
+#include "clinic.h"
+#include "hospital.h"
+#include "insurance.h"
+#include "population.h"
+#include "supplier.h"
+
+/**
+ * @brief Aggregates sampled at the end of one simulated day.
+ */
+struct DayMetrics {
+    int64_t day;
+    int64_t patients[static_cast<int>(PatientHolder::Nothing)];  ///< Per holder type.
+    int64_t fundAmbulances;
+    int64_t fundSuppliers;
+    int64_t fundClinics;
+    int64_t fundHospitals;
+    int64_t fundInsurances;
+    int64_t rejectedPatients;  ///< Patients refused by a transfer during the day.
+    int64_t unpaidBacklog;     ///< Amount still owed by clinics and insurances.
+    int64_t supplierStock;     ///< Items in stock over all suppliers.
+};
+
+/**
+ * @class MetricsExporter
+ * @brief Samples per-day aggregates and streams them to a file from a background thread.
+ *
+ * sampleDay() only reads the states the actors published and queues one
+ * DayMetrics; formatting and disk writes happen on the writer thread. Files
+ * ending in ".csv" are written as CSV with a header line, one row per day.
+ * Anything else is a columnar binary file written when the exporter stops:
+ * the "PCOMETR" magic, the number of columns (uint32), a zero uint32, the
+ * number of days (uint64), then one contiguous block of int64 per column.
+ */
+class MetricsExporter {
+public:
+    /**
+     * @brief Opens the output file and starts the writer thread.
+     * @throws std::runtime_error If the file cannot be created.
+     */
+    MetricsExporter(const std::string& path,
+                    std::vector<Ambulance*> ambulances,
+                    std::vector<Supplier*> suppliers,
+                    std::vector<Clinic*> clinics,
+                    std::vector<Hospital*> hospitals,
+                    std::vector<Insurance*> insurances);
+
+    /**
+     * @brief Flushes every queued sample and stops the writer thread.
+     */
+    ~MetricsExporter();
+
+    /**
+     * @brief Samples the states published by the actors at a day boundary.
+     */
+    void sampleDay(int day);
+
+private:
+    /**
+     * @brief Writer thread: drains the queue until stopped.
+     */
+    void writeLoop();
+
+    void writeHeader();
+    void writeRow(const DayMetrics& m);
+    void writeColumns();
+
+    std::vector<Ambulance*> ambulances;
+    std::vector<Supplier*> suppliers;
+    std::vector<Clinic*> clinics;
+    std::vector<Hospital*> hospitals;
+    std::vector<Insurance*> insurances;
+
+    std::ofstream out;
+    bool csv;
+    long long lastRejected{0};
+    std::vector<std::vector<int64_t>> columns;   ///< Binary output, kept until the exporter stops.
+
+    std::vector<DayMetrics> pending;   ///< Samples not yet written.
+    bool stopping{false};
+    PcoMutex mutex;
+    PcoConditionVariable hasWork;
+    std::unique_ptr<PcoThread> writer;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,173 @@
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <sys/types.h>
+
+#include "bounded_queue.h"
+#include "day_clock.h"
+#include "phases.h"
+
+/**
+ * @brief An intent crossing from one process to another, with the index of
+ *        the outbox it left. A negative sender ends the batch of an exchange.
+ */
+struct RemoteIntent {
+    int32_t sender;
+    Intent intent;
+};
+
+/// One-way ring between two processes, in shared memory.
+using RemoteChannel = FixedBoundedQueue<RemoteIntent, 1 << 10>;
+
+/**
+ * @class Partition
+ * @brief Splits the actors of a phased simulation across local processes
+ *        sharing one anonymous mapping.
+ *
+ * The actors are built identically in every process, before forkProcesses();
+ * actor i then only runs in process i % getCount(), the others staying inert
+ * copies. What the processes share:
+ * - one ring per ordered pair of processes, carrying the intents and the
+ *   replies addressed to actors of the other process (exchange());
+ * - the double-buffered states read by the decide phase (PhasedDay::setPartition);
+ * - a barrier met by one thread of each process (meet());
+ * - the final state of each actor, for the report of the first process.
+ *
+ * Intents are received into the outbox of their sender, so that grouping them
+ * by target gives the same order as in a single process: a seeded run gives
+ * the same results whatever the number of processes.
+ */
+class Partition {
+public:
+    /**
+     * @param nbPartitions Number of processes, at least 1.
+     * @param nbActors Number of actors given to the PhasedDay.
+     * @throws std::invalid_argument If nbPartitions is out of [1, nbActors].
+     * @throws std::runtime_error If the shared mapping cannot be created.
+     */
+    Partition(int nbPartitions, int nbActors);
+    ~Partition();
+
+    Partition(const Partition&) = delete;
+    Partition& operator=(const Partition&) = delete;
+
+    [[nodiscard]] int getCount() const { return nbPartitions; }
+
+    [[nodiscard]] int getActorCount() const { return nbActors; }
+
+    /// Index of the calling process, 0 for the first one.
+    [[nodiscard]] int getIndex() const { return self; }
+
+    /// Whether the calling process is the first one, which prints the report.
+    [[nodiscard]] bool isMain() const { return self == 0; }
+
+    /// Whether actor (an index of the PhasedDay) runs in the calling process.
+    [[nodiscard]] bool isLocal(int actor) const { return actor % nbPartitions == self; }
+
+    /**
+     * @brief Forks one process for each other partition; returns in all of
+     *        them. Before any thread is started. A child is killed if the
+     *        first process dies.
+     * @throws std::runtime_error If fork() fails.
+     */
+    void forkProcesses();
+
+    /**
+     * @brief Waits for the other processes to exit. First process only.
+     * @throws std::runtime_error If one of them failed.
+     */
+    void join();
+
+    /**
+     * @brief Sends the intents of boxes addressed to other processes, and
+     *        appends to the box of each remote sender what it sent to this
+     *        process. Returns once every process sent its batch.
+     *
+     * Rings never need to hold a whole batch: a process keeps draining its
+     * incoming rings while its outgoing ones are full.
+     * @param boxes One box per sender, indexed as in the PhasedDay.
+     * @throws std::runtime_error If another process stopped.
+     */
+    void exchange(std::vector<std::vector<Intent>>& boxes);
+
+    /**
+     * @brief Barrier met by one thread of each process.
+     * @throws std::runtime_error If another process stopped.
+     */
+    void meet();
+
+    /**
+     * @brief Whether any process passes true; meets the others twice.
+     */
+    bool any(bool local);
+
+    /**
+     * @brief One of the two state buffers, one entry per actor.
+     */
+    ActorState* stateBuffer(int which);
+
+    /**
+     * @brief Records the final state of a local actor.
+     */
+    void setFinalState(int actor, const ActorState& state);
+
+    /**
+     * @brief Final state of an actor, once join() returned.
+     */
+    [[nodiscard]] const ActorState& getFinalState(int actor) const;
+
+private:
+    /**
+     * @brief Ring from process from to process to.
+     */
+    RemoteChannel& channel(int from, int to) { return channels[from * nbPartitions + to]; }
+
+    /**
+     * @brief Throws if another process stopped. Only the first process can
+     *        tell; the others are killed with it.
+     */
+    void checkPeers();
+
+    int nbPartitions;
+    int nbActors;
+    int self{0};
+    std::vector<pid_t> children;
+
+    // Dans le segment partagé
+    void* mapping{nullptr};
+    size_t mappedSize{0};
+    std::atomic<uint32_t>* arrived{nullptr};     ///< Processes at the barrier
+    std::atomic<uint32_t>* generation{nullptr};  ///< Barriers passed, waited on with a futex
+    std::atomic<int32_t>* flags{nullptr};        ///< One per process, for any()
+    RemoteChannel* channels{nullptr};            ///< nbPartitions x nbPartitions, the diagonal unused
+    ActorState* states{nullptr};                 ///< Two buffers of nbActors
+    ActorState* finals{nullptr};                 ///< nbActors
+};
+
+/**
+ * @class SharedDayClock
+ * @brief DayClock of one process of a partitioned simulation.
+ *
+ * Workers meet the main thread of their own process as with a DayClock; the
+ * main threads of all processes then meet at the shared barrier once their
+ * day is over, so no process starts a day before every other one ended the
+ * previous day. The phase barrier is crossed by the phase step itself, which
+ * exchanges the replies with the other processes.
+ */
+class SharedDayClock : public DayClock {
+public:
+    /**
+     * @param participants Workers of this process.
+     */
+    SharedDayClock(int participants, Partition* partition);
+
+    void wait_all_done() override;
+
+private:
+    Partition* partition;
+};
+
+#endif // PARTITION_H
@@ -0,0 +1,179 @@
+#ifndef PATIENT_H
+#define PATIENT_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <vector>
+
+/**
+ * @brief Steps of a patient's journey through the system, in order.
+ */
+enum class PatientStage {
+    Ambulance,  ///< Picked up by an ambulance.
+    Hospital,   ///< Admitted in a hospital, waiting for a clinic.
+    Clinic,     ///< Waiting in a clinic.
+    Treated,    ///< Treated, waiting for a rehab bed.
+    Rehab,      ///< In rehabilitation at a hospital.
+    Freed,      ///< Rehab finished, left the system.
+    Nothing
+};
+
+/// Index of a patient record in the pool.
+using PatientHandle = uint32_t;
+
+constexpr PatientHandle NO_PATIENT = UINT32_MAX;
+constexpr int NB_PATIENT_STAGES = static_cast<int>(PatientStage::Nothing);
+
+/**
+ * @brief One tracked patient.
+ */
+struct PatientRecord {
+    uint32_t id;                          ///< Unique patient number.
+    int32_t owner;                        ///< Unique id of the actor holding the patient.
+    int32_t stageDay[NB_PATIENT_STAGES];  ///< Day each stage was reached (-1 if not yet).
+    std::atomic<PatientHandle> nextFree;  ///< Free list link while the record is unused.
+};
+
+/**
+ * @class PatientPool
+ * @brief Lock-free slab allocator of patient records.
+ *
+ * Records live in fixed-size slabs allocated on demand and never moved, so a
+ * handle stays valid until released. Released records go on a lock-free stack
+ * whose head carries a tag against ABA.
+ */
+class PatientPool {
+public:
+    static constexpr uint32_t SLAB_SIZE = 4096;
+    static constexpr uint32_t MAX_SLABS = 1024;
+
+    PatientPool() = default;
+    ~PatientPool();
+
+    PatientPool(const PatientPool&) = delete;
+    PatientPool& operator=(const PatientPool&) = delete;
+
+    /**
+     * @brief Returns a fresh record handle.
+     * @throws std::runtime_error When the pool is exhausted.
+     */
+    PatientHandle allocate();
+
+    /**
+     * @brief Gives a record back to the pool.
+     */
+    void release(PatientHandle handle);
+
+    PatientRecord& operator[](PatientHandle handle) {
+        return slabs[handle / SLAB_SIZE].load(std::memory_order_acquire)[handle % SLAB_SIZE];
+    }
+
+private:
+    static constexpr uint64_t indexOf(uint64_t head) { return head & 0xffffffffu; }
+    static constexpr uint64_t tagOf(uint64_t head) { return head >> 32; }
+
+    std::atomic<PatientRecord*> slabs[MAX_SLABS]{};
+    std::atomic<uint32_t> nextUnused{0};             ///< Records never handed out yet start here.
+    std::atomic<uint64_t> freeHead{NO_PATIENT};      ///< Tag (high 32 bits) and index of the free stack.
+};
+
+/**
+ * @class PatientTracker
+ * @brief Optional per-patient tracking with end-to-end latency histograms.
+ *
+ * When enabled, every patient gets a record from the pool and actors keep the
+ * handles of the patients they hold next to their integer stocks. A transfer
+ * moves handles through a thread-local outbox: the sender puts handles in with
+ * send(), the receiver takes the accepted ones in its commit() with receive(),
+ * and the sender gets the refused ones back with takeBack(). This works because
+ * transfer() runs on the sender's thread.
+ *
+ * When disabled (the default), every call returns at once.
+ */
+class PatientTracker {
+public:
+    static constexpr int NB_BUCKETS = 128;  ///< One bucket per day, the last one collects the rest.
+
+    void enable() { enabled.store(true); }
+    void disable() { enabled.store(false); }
+    [[nodiscard]] bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Sets the day stamped on stage changes (called between two days).
+     */
+    void setDay(int d) { day.store(d, std::memory_order_relaxed); }
+
+    /**
+     * @brief Creates qty patients held by an actor, at a given stage.
+     */
+    void admit(std::deque<PatientHandle>& to, int qty, PatientStage stage, int owner);
+
+    /**
+     * @brief Marks the front patient of a queue as having reached a new stage
+     *        and moves it to another queue of the same actor.
+     */
+    void advance(std::deque<PatientHandle>& from, std::deque<PatientHandle>& to, PatientStage stage);
+
+    /**
+     * @brief Moves qty patients from the front of a queue into the thread's outbox.
+     */
+    void send(std::deque<PatientHandle>& from, int qty);
+
+    /**
+     * @brief Takes qty patients from the thread's outbox into a receiver's queue.
+     */
+    void receive(std::deque<PatientHandle>& to, int qty, PatientStage stage, int owner);
+
+    /**
+     * @brief Takes the next patient from the thread's outbox, for receivers that
+     *        queue patients one by one.
+     * @return The patient, or NO_PATIENT when tracking is off or the outbox is empty.
+     */
+    PatientHandle receiveOne(PatientStage stage, int owner);
+
+    /**
+     * @brief Puts the patients left in the outbox back at the front of the sender's queue.
+     */
+    void takeBack(std::deque<PatientHandle>& from);
+
+    /**
+     * @brief Patients leave the system: latencies are recorded and records released.
+     */
+    void discharge(const std::vector<PatientHandle>& handles);
+
+    /**
+     * @brief Number of patients discharged so far.
+     */
+    [[nodiscard]] long long dischargedCount() const;
+
+    /**
+     * @brief Prints count, mean and percentiles of each stage latency, in days.
+     */
+    void printReport(std::ostream& out) const;
+
+private:
+    struct Histogram {
+        std::atomic<uint64_t> buckets[NB_BUCKETS]{};
+        void add(int days);
+        [[nodiscard]] uint64_t count() const;
+        [[nodiscard]] int percentile(double p) const;
+        [[nodiscard]] double mean() const;
+    };
+
+    void mark(PatientHandle h, PatientStage stage, int owner);
+
+    std::atomic<bool> enabled{false};
+    std::atomic<int> day{0};
+    std::atomic<uint32_t> nextId{0};
+    PatientPool pool;
+    Histogram stageLatency[NB_PATIENT_STAGES];  ///< [s]: days from stage s-1 to s, [0]: from pickup to freed.
+};
+
+/**
+ * @brief Returns the global patient tracker of the simulation.
+ */
+PatientTracker& patientTracker();
+
+#endif // PATIENT_H
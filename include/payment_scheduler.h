@@ -0,0 +1,162 @@
+#ifndef PAYMENT_SCHEDULER_H
+#define PAYMENT_SCHEDULER_H
+
+#include <deque>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+class Seller;
+
+/**
+ * @brief How the insurance chooses which invoices to pay with the funds it has.
+ */
+struct PaymentPolicy {
+    bool prioritizeWaiting{false}; ///< Providers refusing work until paid go first, smallest bill first.
+    bool partialPayments{false};   ///< Pays what the funds allow of a bill that cannot be paid in full.
+    int creditLimit{0};            ///< Overdraft the insurance may run for each provider.
+};
+
+/**
+ * @brief Parses "fifo" or "priority[:CREDIT[:partial]]".
+ * @throws std::invalid_argument On an unknown description.
+ */
+PaymentPolicy parsePaymentPolicy(const std::string& description);
+
+/**
+ * @brief A payment to make, or a bill still owed.
+ */
+struct Payment {
+    Seller* who;
+    int amount;
+};
+
+/**
+ * @class PaymentScheduler
+ * @brief Queue of the invoices received by the insurance, in payment order.
+ *
+ * Each provider keeps its own invoices in arrival order; providers are ranked
+ * in an ordered set by the head of their queue. By default bills are paid in
+ * arrival order. With PaymentPolicy::prioritizeWaiting, providers waiting for
+ * a payment before taking work again (Seller::isWaitingForPayment()) come
+ * first, the one with the smallest bill first; the others follow in arrival
+ * order, so no bill of a working provider is delayed by later ones. Adding or
+ * paying a bill costs O(log n). Not thread-safe: the insurance holds its mutex.
+ *
+ * The credit a provider was paid with stays drawn until the funds of the
+ * insurance come back above the overdraft: draws are repaid oldest first, and
+ * a provider is never paid beyond its limit minus what it still has drawn.
+ */
+class PaymentScheduler {
+public:
+    explicit PaymentScheduler(PaymentPolicy policy = {});
+
+    void setPolicy(const PaymentPolicy& policy);
+    [[nodiscard]] const PaymentPolicy& getPolicy() const { return policy; }
+
+    /**
+     * @brief Overrides the credit limit of the policy for one provider.
+     */
+    void setCreditLimit(const Seller* who, int limit);
+    [[nodiscard]] int getCreditLimit(const Seller* who) const;
+
+    /**
+     * @brief Providers given their own limit by setCreditLimit(), by unique id.
+     */
+    [[nodiscard]] std::vector<std::pair<const Seller*, int>> getCreditLimits() const;
+
+    /**
+     * @brief Removes the limits of setCreditLimit(): every provider gets the policy's again.
+     */
+    void clearCreditLimits() { creditLimits.clear(); }
+
+    /**
+     * @brief Credit drawn to pay providers and not repaid yet, oldest first.
+     */
+    [[nodiscard]] std::vector<Payment> getOverdrafts() const;
+
+    /**
+     * @brief Records credit drawn for who, after the others (snapshot restore).
+     */
+    void addOverdraft(Seller* who, int amount);
+
+    /**
+     * @brief Credit left to pay who with, once the draws the funds cover are repaid.
+     */
+    [[nodiscard]] int getCreditLeft(const Seller* who, int money) const;
+
+    /**
+     * @brief Queues an invoice of who.
+     */
+    void add(Seller* who, int amount);
+
+    /**
+     * @brief Reads again which providers wait for a payment. Their flag is an
+     *        atomic read: no lock of the provider is taken.
+     */
+    void refreshPriorities();
+
+    /**
+     * @brief Takes the next payment the funds allow, removing it from the queue.
+     * @param money Funds of the insurance, which may go below 0 by the credit
+     *        left to the provider paid.
+     * @return Nothing when the first bill in order cannot be paid.
+     */
+    std::optional<Payment> next(int money);
+
+    /**
+     * @brief Days of income after which some bill can be paid: 0 if one can be
+     *        paid now, -1 if none ever can (no bills). Never later than the
+     *        first payment.
+     */
+    [[nodiscard]] int daysUntilPayable(int money, int incomePerDay) const;
+
+    [[nodiscard]] bool empty() const { return queue.empty(); }
+    [[nodiscard]] int getUnpaidAmount() const { return unpaid; }
+
+    /**
+     * @brief Bills still owed, in arrival order, partly paid ones with what is left.
+     */
+    [[nodiscard]] std::vector<Payment> pending() const;
+
+    /**
+     * @brief Drops every bill and every overdraft.
+     */
+    void clear();
+
+private:
+    struct Bill {
+        long long seq;
+        int amount;
+    };
+
+    struct Account {
+        std::deque<Bill> bills;
+        bool waiting{false};
+    };
+
+    /// (rank, size, arrival, provider): rank 0 for waiting providers
+    using Key = std::tuple<int, int, long long, Seller*>;
+
+    [[nodiscard]] Key keyOf(Seller* who, const Account& account) const;
+    void rebuild();
+
+    /**
+     * @brief Repays the oldest draws with what money no longer owes.
+     */
+    void settleOverdrafts(int money);
+
+    PaymentPolicy policy;
+    std::unordered_map<Seller*, Account> accounts;  ///< Providers with bills owed
+    std::unordered_map<const Seller*, int> creditLimits;
+    std::set<Key> queue;                            ///< One key per provider with bills owed
+    std::deque<Payment> overdrafts;                 ///< Credit drawn and not repaid, oldest first
+    int overdrawn{0};                               ///< Sum of overdrafts
+    long long nextSeq{0};
+    int unpaid{0};
+};
+
+#endif // PAYMENT_SCHEDULER_H
@@ -0,0 +1,242 @@
+#ifndef PHASES_H
+#define PHASES_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "seller.h"
+
+/**
+ * @brief A call emitted during a day, applied by its target the next day, or
+ *        the reply of that target to a transfer or a purchase.
+ */
+struct Intent {
+    enum class Op : uint8_t {
+        Transfer,  ///< Patients offered to the target.
+        Buy,       ///< Resources asked to a supplier.
+        Invoice,
+        Pay,
+        Accepted,  ///< Reply to a transfer.
+        Sold       ///< Reply to a purchase.
+    };
+
+    Op op;
+    ItemType item;  ///< Items of a transfer, a purchase or their reply; Nothing otherwise.
+    int from;       ///< Index of the sender, of the beneficiary of an invoice; -1 for a payment.
+    int to;         ///< Index of the receiving actor.
+    int qty;        ///< Items offered or asked, repeated in the reply.
+    int amount;     ///< Money of an invoice or a payment; items accepted or sold in a reply.
+};
+
+class PhasedDay;
+class Partition;
+
+/**
+ * @class DeferredSeller
+ * @brief Stands for an actor during the decide phase: invoices and payments
+ *        become intents in the outbox of the calling thread, and what is read
+ *        about the actor is its state of the end of yesterday.
+ *
+ * transfer() and buy() need an immediate answer and throw: they are posted
+ * with PhasedDay::request() and answered by a reply.
+ */
+class DeferredSeller : public Seller {
+public:
+    DeferredSeller(Seller* target, int index, PhasedDay* day);
+
+    int transfer(ItemType, int) override {
+        throw std::logic_error("DeferredSeller::transfer() not supported");
+    }
+
+    int buy(ItemType, int) override {
+        throw std::logic_error("DeferredSeller::buy() not supported");
+    }
+
+    void invoice(int bill, Seller* who) override;
+
+    void pay(int bill) override;
+
+    /**
+     * @brief Flag published by the actor yesterday: payers rank the proxy as
+     *        they would have ranked the actor at the end of that day.
+     */
+    bool isWaitingForPayment() const override;
+
+    /**
+     * @brief Free capacity published by the actor yesterday.
+     */
+    int getFreeCapacity() const override;
+
+private:
+    Seller* target;
+    int index;
+    PhasedDay* day;
+};
+
+/**
+ * @class PhasedDay
+ * @brief Days in which actors never call each other: every call becomes an
+ *        intent, applied by the thread of its target the next day.
+ *
+ * A day has three phases, each actor running them on its own thread:
+ * - apply: the actor applies its inbox, the intents sent to it yesterday, in
+ *   actor order. It answers transfers and purchases with a reply.
+ * - settle: after the phase barrier of the DayClock, the actor settles the
+ *   replies to its own requests of yesterday (patients handed over, resources
+ *   received).
+ * - decide: the actor runs its day. What it reads about the others is their
+ *   state at the end of yesterday, from a read-only buffer; what it does to
+ *   them goes to its own outbox.
+ *
+ * The states are double-buffered: each actor writes its own entry of the back
+ * buffer when it publishes its state, the others read the front buffer, and
+ * the buffers are swapped between two days, together with the intents. The
+ * last worker to reach the phase barrier routes the replies. No buffer is
+ * ever written by one thread while another reads it: actors apply intents
+ * without taking any lock, the lock an actor still takes while settling or
+ * deciding is only ever taken by its own thread, and a seeded run does not
+ * depend on thread timing.
+ *
+ * Patients offered stay counted by their sender until the reply: none are
+ * in flight at the end of a day.
+ *
+ * The actors can also be split across processes (setPartition): each process
+ * then only applies and settles the boxes of its own actors.
+ */
+class PhasedDay {
+public:
+    /**
+     * @param actors Every actor of the simulation, the ones only reached through
+     *        invoices and payments included.
+     */
+    explicit PhasedDay(const std::vector<Seller*>& actors);
+
+    /**
+     * @brief Splits the actors across the processes of partition: intents and
+     *        replies to actors of other processes cross its rings, and states
+     *        are read from its shared buffers. Before the first publication.
+     * @throws std::invalid_argument If partition was made for another number of actors.
+     */
+    void setPartition(Partition* partition);
+
+    /**
+     * @brief Whether the actor at index runs in this process: always, unless
+     *        the actors are split across processes.
+     */
+    [[nodiscard]] bool isLocal(int index) const;
+
+    /**
+     * @brief Proxy turning invoices and payments to target into intents.
+     * @throws std::out_of_range If target was not given to the constructor.
+     */
+    Seller* deferred(Seller* target);
+
+    /**
+     * @brief Makes the calling thread write its intents to the outbox of self.
+     */
+    void bindOutbox(Seller* self);
+
+    /**
+     * @brief Adds an intent to the outbox of the calling thread. Threads that
+     *        are not actors (tests, main thread) share a locked outbox.
+     */
+    void post(const Intent& intent);
+
+    /**
+     * @brief Posts a transfer or a purchase, answered by a reply to from the next day.
+     * @throws std::out_of_range If one of the actors is unknown.
+     */
+    void request(Intent::Op op, const Seller* from, const Seller* to, ItemType what, int qty);
+
+    /**
+     * @brief Index of a registered actor.
+     * @throws std::out_of_range If the actor is unknown.
+     */
+    int indexOf(const Seller* actor) const { return indices.at(actor); }
+
+    /**
+     * @brief Registered actor at an index.
+     */
+    Seller* actorAt(int index) const { return actors[static_cast<size_t>(index)]; }
+
+    /**
+     * @brief State of an actor (or of its proxy) at the end of yesterday.
+     * @throws std::out_of_range If the actor is unknown.
+     */
+    const ActorState& previous(const Seller* actor) const {
+        return states[front][indexOf(actor)];
+    }
+
+    /**
+     * @brief Writes the state of an actor to the back buffer, read by the
+     *        others once the buffers are swapped. From the actor's thread, or
+     *        from the main thread between two days.
+     */
+    void publish(const Seller* actor, const ActorState& state);
+
+    /**
+     * @brief Groups yesterday's outboxes by target into the inboxes and swaps
+     *        the state buffers. Main thread only, between two days.
+     */
+    void swapBuffers();
+
+    /**
+     * @brief Applies the inbox of an actor, from its own thread.
+     * @return Number of intents applied.
+     */
+    int applyInbox(Seller* self);
+
+    /**
+     * @brief Groups the replies of the apply phase by sender. Run by the last
+     *        worker at the phase barrier (see DayClock::set_phase_step).
+     */
+    void routeReplies();
+
+    /**
+     * @brief Settles the replies to the requests of an actor, from its own thread.
+     * @return Number of replies settled.
+     */
+    int settleReplies(Seller* self);
+
+    /**
+     * @brief Applies and settles everything still pending, once the workers are
+     *        stopped. With processes, in all of them at once.
+     */
+    void applyAll();
+
+    /**
+     * @brief Number of intents emitted since the start, replies included.
+     */
+    [[nodiscard]] long long getIntentCount() const { return nbIntents; }
+
+private:
+    using Boxes = std::vector<std::vector<Intent>>;
+
+    /**
+     * @brief Moves every intent of from to the box of its target in to, in the
+     *        order of from: a counting sort on the target.
+     */
+    void route(Boxes& from, Boxes& to);
+
+    std::vector<Seller*> actors;
+    std::unordered_map<const Seller*, int> indices;
+    std::vector<std::unique_ptr<DeferredSeller>> proxies;
+
+    Boxes outboxes;       ///< One per actor, plus the shared one last
+    Boxes inboxes;        ///< One per actor
+    Boxes replyOutboxes;  ///< Replies written by each actor during the apply phase
+    Boxes replyInboxes;   ///< Replies to the requests of each actor
+    PcoMutex sharedOutboxMutex;
+    long long nbIntents{0};
+
+    Partition* partition{nullptr};
+
+    std::vector<ActorState> ownStates;  ///< Both buffers, unless they are shared between processes
+    std::array<ActorState*, 2> states;  ///< Front and back buffers, one entry per actor
+    int front{0};                       ///< Buffer read today
+};
+
+#endif // PHASES_H
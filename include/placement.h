@@ -0,0 +1,101 @@
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "seller.h"
+
+/**
+ * @brief A NUMA node and the CPUs attached to it.
+ */
+struct NumaNode {
+    int id;
+    std::vector<int> cpus;
+};
+
+/**
+ * @brief Parses a kernel CPU list such as "0-3,8,10-11".
+ * @throws std::invalid_argument If the list is malformed.
+ */
+std::vector<int> parseCpuList(const std::string& list);
+
+/**
+ * @brief Reads the NUMA nodes that have CPUs from a sysfs node directory.
+ *
+ * Falls back to a single node holding every online CPU when the directory
+ * cannot be read (no NUMA support, containers).
+ */
+std::vector<NumaNode> readNumaNodes(const std::string& root = "/sys/devices/system/node");
+
+/**
+ * @class Placement
+ * @brief Decides on which NUMA node each actor runs and pins actor threads there.
+ *
+ * Actors that call each other constantly (a hospital and its clinics) are
+ * placed as one group on the least loaded node. While enabled, every call
+ * between two actors is counted as same-node or cross-node so that the
+ * placement can be checked. Actors are placed before threads start; the
+ * placement is read-only afterwards.
+ */
+class Placement {
+public:
+    void setNodes(std::vector<NumaNode> nodes);
+    [[nodiscard]] const std::vector<NumaNode>& getNodes() const { return nodes; }
+
+    void enable() { enabled.store(true, std::memory_order_relaxed); }
+    [[nodiscard]] bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Places a group of actors together on the node with the fewest actors.
+     * @return Index of the chosen node.
+     */
+    int placeGroup(const std::vector<Seller*>& group);
+
+    /**
+     * @brief Places one actor on a given node index.
+     */
+    void place(const Seller* seller, int node);
+
+    /**
+     * @brief Node index of an actor, -1 if it was not placed.
+     */
+    [[nodiscard]] int nodeOf(const Seller* seller) const;
+
+    /**
+     * @brief Binds the calling thread to the CPUs of the actor's node.
+     * @return False if the actor is not placed or the kernel refused.
+     */
+    bool pinCurrentThread(const Seller* seller);
+
+    /**
+     * @brief Counts a call from the current thread's actor to callee.
+     */
+    void noteCall(const Seller* callee);
+
+    [[nodiscard]] long long sameNodeCalls() const { return sameNode.load(); }
+    [[nodiscard]] long long crossNodeCalls() const { return crossNode.load(); }
+
+    /**
+     * @brief Prints the nodes, the actors per node and the call counts.
+     */
+    void printReport(std::ostream& out) const;
+
+private:
+    std::vector<NumaNode> nodes;
+    std::vector<int> load;                       ///< Actors placed per node.
+    std::unordered_map<const Seller*, int> nodeBySeller;
+    std::atomic<bool> enabled{false};
+    std::atomic<long long> sameNode{0};
+    std::atomic<long long> crossNode{0};
+};
+
+/**
+ * @brief Global placement, disabled by default.
+ */
+Placement& placement();
+
+#endif // PLACEMENT_H
@@ -0,0 +1,107 @@
+#ifndef POPULATION_H
+#define POPULATION_H
+
+#include <atomic>
+#include <vector>
+
+class Seller;
+
+/**
+ * @brief Kind of actor currently holding a patient.
+ */
+enum class PatientHolder {
+    Ambulance,  ///< Waiting in an ambulance.
+    Hospital,   ///< Admitted in a hospital (sick or rehab).
+    Clinic,     ///< In a clinic (waiting or treated).
+    Freed,      ///< Rehab finished, left the system.
+    Nothing
+};
+
+/**
+ * @brief Holder type whose counter disagrees with the states published by its actors.
+ */
+struct PopulationMismatch {
+    PatientHolder holder;
+    long long counted;    ///< Value of the counter.
+    long long published;  ///< Sum over the published states of the actors.
+};
+
+/**
+ * @class PopulationCounter
+ * @brief Global patient counters per holder type, kept up to date on every transfer.
+ *
+ * Each thread writes into its own cache-line aligned shard with relaxed atomics,
+ * so updates never contend. Reading sums all shards and is meant to be done at
+ * day boundaries, when no transfer is in flight.
+ */
+class PopulationCounter {
+public:
+    /**
+     * @brief Adds delta patients to the given holder type.
+     */
+    void add(PatientHolder holder, int delta);
+
+    /**
+     * @brief Moves qty patients from one holder type to another.
+     */
+    void move(PatientHolder from, PatientHolder to, int qty);
+
+    /**
+     * @brief Counts qty patients refused by a transfer (they stay with the sender).
+     */
+    void reject(int qty);
+
+    /**
+     * @brief Returns the number of patients refused since the start (or the last reset).
+     */
+    [[nodiscard]] long long rejected() const;
+
+    /**
+     * @brief Returns the number of patients held by a given holder type.
+     */
+    [[nodiscard]] long long count(PatientHolder holder) const;
+
+    /**
+     * @brief Returns the number of patients over all holder types.
+     */
+    [[nodiscard]] long long total() const;
+
+    /**
+     * @brief Compares each holder type's counter with the patients published
+     *        by the actors of that type, freed patients with those published by hospitals.
+     *
+     * Meant for day boundaries, once every actor has published its current state:
+     * a stock changed without its counter, or the reverse, shows up here.
+     * @param actors All the actors of the simulation.
+     * @return One entry per holder type that disagrees, empty when all agree.
+     */
+    [[nodiscard]] std::vector<PopulationMismatch> crossCheck(const std::vector<Seller*>& actors) const;
+
+    /**
+     * @brief Resets all counters to zero (only when no thread updates them).
+     */
+    void reset();
+
+private:
+    static constexpr int NB_SHARDS  = 64;
+    static constexpr int NB_HOLDERS = static_cast<int>(PatientHolder::Nothing);
+
+    struct alignas(64) Shard {
+        std::atomic<long long> counts[NB_HOLDERS]{};
+        std::atomic<long long> rejected{0};
+    };
+
+    /**
+     * @brief Returns the shard assigned to the calling thread.
+     */
+    Shard& localShard();
+
+    Shard shards[NB_SHARDS];
+};
+
+/**
+ * @brief Returns the global population counter of the simulation.
+ */
+PopulationCounter& population();
+
+#endif // POPULATION_H
@@ -1,13 +1,17 @@
 #ifndef SELLER_H
 #define SELLER_H
 
+#include <array>
 #include <string>
+#include <string_view>
 #include <map>
 #include <vector>
 #include <stdexcept>
 #include <iostream>
 #include <cassert>
 #include <algorithm>
+#include <limits>
+#include <random>
 
 #include <pcosynchro/pcologger.h>
 #include <pcosynchro/pcomutex.h>
@@ -15,7 +19,15 @@
 #include <pcosynchro/pcothread.h>
 
 #include "costs.h"
+#include "lock_stats.h"
+#include "seqlock.h"
 #include "day_clock.h"
+#include "patient.h"
+#include "population.h"
+
+class PhasedDay;
+class Seller;
+struct Intent;
 
 /**
  * @brief Represents the different types of "items" managed or exchanged by sellers.
@@ -53,13 +65,158 @@ enum class ServiceType {
 };
 
 
+/**
+ * @brief Ticket handed out by Seller::reserve().
+ *
+ * Holds capacity on the receiving Seller until the sender either commits
+ * or aborts it. A ticket with qty() == 0 means the reservation was refused.
+ *
+ * Tickets can be moved but not copied, and only their owner can settle them.
+ * Settling closes a ticket, and the moved-from ticket is closed too, so the
+ * capacity of a reservation is handed over or given back exactly once. A
+ * ticket still open when it is destroyed or overwritten (exception, early
+ * return) is aborted with its owner.
+ */
+class Reservation {
+public:
+    /// A closed ticket, owned by no one.
+    Reservation() = default;
+
+    Reservation(Reservation&& other) noexcept
+        : owner(other.owner), id(other.id), item(other.item), reserved(other.reserved) {
+        other.id = 0;
+        other.reserved = 0;
+    }
+
+    /// Aborts the open ticket held so far, then takes over other.
+    Reservation& operator=(Reservation&& other) noexcept;
+
+    ~Reservation();
+
+    Reservation(const Reservation&) = delete;
+    Reservation& operator=(const Reservation&) = delete;
+
+    [[nodiscard]] ItemType what() const { return item; }
+
+    /// Quantity actually reserved (may be less than asked), 0 once settled.
+    [[nodiscard]] int qty() const { return reserved; }
+
+    /// Unique among all tickets, 0 once settled.
+    [[nodiscard]] uint64_t getId() const { return id; }
+
+    /// True until the ticket is committed or aborted.
+    [[nodiscard]] bool isOpen() const { return id != 0; }
+
+private:
+    friend class Seller;
+
+    Reservation(Seller* owner, uint64_t id, ItemType what, int qty)
+        : owner(owner), id(id), item(what), reserved(qty) {}
+
+    /// Gives the capacity of an open ticket back to its owner.
+    void settle() noexcept;
+
+    Seller* owner{nullptr};
+    uint64_t id{0};
+    ItemType item{ItemType::Nothing};
+    int reserved{0};
+};
+
+/**
+ * @brief What an actor publishes about itself for monitoring, read without locking.
+ */
+struct ActorState {
+    static constexpr int NB_ITEMS = static_cast<int>(ItemType::Nothing);
+
+    int32_t day;            ///< Day of the publication.
+    int32_t fund;
+    int32_t employeesPaid;
+    int32_t backlog;        ///< Work waiting for the actor (patients, batches in progress); see each actor.
+    int32_t unpaid;         ///< Amount this actor still owes.
+    int32_t patients;       ///< Patients held, counted under patientHolder(); 0 for the others.
+    int32_t freed;          ///< Patients that left the system from this actor (hospitals).
+    int32_t freeCapacity;   ///< Patients it could take, -1 if it does not publish it (see Seller::getFreeCapacity).
+    int32_t waiting;        ///< 1 while it refuses work until it is paid (see Seller::isWaitingForPayment).
+    int32_t stock[NB_ITEMS];
+};
+
+
 // Global helper functions
 
-int getCostPerUnit(ItemType item);
-int getCostPerService(ServiceType claim);
-std::string getItemName(ItemType item);
-EmployeeType getEmployeeThatProduces(ItemType item);
-int getEmployeeSalary(EmployeeType employee);
+/**
+ * @brief Cost and metadata of an item type.
+ */
+struct ItemInfo {
+    int costPerUnit;          ///< Price paid to a supplier for one unit.
+    EmployeeType producer;    ///< Employee paid to produce one unit.
+    std::string_view name;
+};
+
+/// Indexed by ItemType
+inline constexpr std::array<ItemInfo, static_cast<size_t>(ItemType::Nothing) + 1> ITEM_TABLE = {{
+    {0,                EmployeeType::Supplier,            "Sick Patient"},
+    {0,                EmployeeType::TreatmentSpecialist, "Rehab Patient"},
+    {SYRINGUE_COST,    EmployeeType::Supplier,            "Syringe"},
+    {PILL_COST,        EmployeeType::Supplier,            "Pill"},
+    {SCALPEL_COST,     EmployeeType::Supplier,            "Scalpel"},
+    {THERMOMETER_COST, EmployeeType::Supplier,            "Thermometer"},
+    {STETHOSCOPE_COST, EmployeeType::Supplier,            "Stethoscope"},
+    {0,                EmployeeType::Nothing,             "Nothing"},
+}};
+
+/// Indexed by EmployeeType
+inline constexpr std::array<int, static_cast<size_t>(EmployeeType::Nothing) + 1> SALARY_TABLE = {
+    SUPPLIER_COST, NURSE_COST, NURSE_COST, DOCTOR_COST, 0
+};
+
+/// Indexed by ServiceType
+inline constexpr std::array<int, static_cast<size_t>(ServiceType::Rehab) + 1> SERVICE_COST_TABLE = {
+    TRANSFER_COST, PRETREATMENT_COST, TREATMENT_COST, REHAB_COST
+};
+
+constexpr int getCostPerUnit(ItemType item) {
+    auto i = static_cast<size_t>(item);
+    return i < ITEM_TABLE.size() ? ITEM_TABLE[i].costPerUnit : 0;
+}
+
+constexpr int getCostPerService(ServiceType claim) {
+    auto i = static_cast<size_t>(claim);
+    return i < SERVICE_COST_TABLE.size() ? SERVICE_COST_TABLE[i] : 0;
+}
+
+constexpr std::string_view getItemName(ItemType item) {
+    auto i = static_cast<size_t>(item);
+    return i < ITEM_TABLE.size() ? ITEM_TABLE[i].name : "???";
+}
+
+constexpr EmployeeType getEmployeeThatProduces(ItemType item) {
+    auto i = static_cast<size_t>(item);
+    return i < ITEM_TABLE.size() ? ITEM_TABLE[i].producer : EmployeeType::Nothing;
+}
+
+constexpr int getEmployeeSalary(EmployeeType employee) {
+    auto i = static_cast<size_t>(employee);
+    return i < SALARY_TABLE.size() ? SALARY_TABLE[i] : 0;
+}
+
+/**
+ * @brief Price of a whole order, in one pass over the cost table.
+ * @param order Quantity of each item line; an item may appear on several lines.
+ */
+inline int getOrderCost(const std::vector<std::pair<ItemType, int>>& order) {
+    int total = 0;
+    for (const auto& [item, qty] : order) total += qty * getCostPerUnit(item);
+    return total;
+}
+
+/**
+ * @brief Price of one unit of each item.
+ */
+inline int getOrderCost(const std::vector<ItemType>& items) {
+    int total = 0;
+    for (auto item : items) total += getCostPerUnit(item);
+    return total;
+}
 
 /**
  * @brief Abstract base class representing an economic actor (clinic, supplier, etc.)
@@ -67,14 +224,15 @@ int getEmployeeSalary(EmployeeType employee);
  */
 class Seller {
 public:
+    /// Allows snapshots to save and restore the full state
+    friend class Snapshot;
+
     /**
      * @brief Constructs a Seller with initial funds and unique identifier.
      * @param money Initial amount of money available.
      * @param uniqueId Unique identifier for this seller instance.
      */
-    Seller(int money, int uniqueId) : money(money), uniqueId(uniqueId) {
-        logger().setVerbosity(1);
-    }
+    Seller(int money, int uniqueId) : money(money), uniqueId(uniqueId), rng(seededEngine(uniqueId)) {}
 
     virtual ~Seller() = default;
 
@@ -111,6 +269,67 @@ public:
     virtual void pay(int bill) = 0;
 
 
+    // Phased days
+
+    /**
+     * @brief Applies a call received yesterday: a transfer, a purchase, an
+     *        invoice or a payment. Called by PhasedDay, on the thread of this
+     *        Seller, while no other thread touches it.
+     *
+     * The default forwards to transfer(), buy(), invoice() and pay(); actors
+     * override it to update their state without taking their lock.
+     * @return Items accepted (transfer) or sold (purchase), 0 for the others.
+     * @throws std::logic_error For a reply, which is settled by settleReplies().
+     */
+    virtual int applyIntent(const Intent& intent);
+
+    /**
+     * @brief Settles the replies to the transfers and purchases this Seller
+     *        requested yesterday, on its own thread. Invoices it sends from
+     *        there are applied tomorrow.
+     * @param replies In the order of the requests, grouped by target.
+     * @throws std::logic_error Unless overridden, since only actors that
+     *         request something get replies.
+     */
+    virtual void settleReplies(const std::vector<Intent>& replies);
+
+
+    // Two-phase transfer protocol
+
+    /**
+     * @brief First phase of a transfer: sets aside room for up to qty items.
+     *
+     * Only the receiver's own state is touched, so a sender never needs to hold
+     * its lock while calling this (no lock-order inversion between sellers).
+     * Sellers that do not reserve capacity (mocks, proxies) promise the whole
+     * quantity and decide in commit(), through transfer().
+     * @param what Item type to reserve room for.
+     * @param qty Quantity the sender would like to transfer.
+     * @return Ticket with the quantity actually reserved.
+     */
+    virtual Reservation reserve(ItemType what, int qty) { return issue(what, qty); }
+
+    /**
+     * @brief Second phase: the reserved items are handed over to this Seller.
+     * @param token Open ticket returned by reserve() of this Seller; closed on return.
+     * @return Items handed over: the quantity reserved, or for sellers that do
+     *         not reserve capacity what transfer() accepts.
+     * @throws std::logic_error If the ticket is closed or belongs to another Seller.
+     */
+    virtual int commit(Reservation& token) {
+        ItemType what = token.what();
+        int qty = redeem(token);
+        return qty > 0 ? transfer(what, qty) : 0;
+    }
+
+    /**
+     * @brief Cancels a reservation and gives its capacity back.
+     * @param token Open ticket returned by reserve() of this Seller; closed on return.
+     * @throws std::logic_error If the ticket is closed or belongs to another Seller.
+     */
+    virtual void abort(Reservation& token) { redeem(token); }
+
+
     // Utility functions
 
     /**
@@ -123,7 +342,7 @@ public:
     /**
      * @brief Returns a copy of the current stock.
      */
-    std::map<ItemType, int> getStock() const { return stocks; }
+    virtual std::map<ItemType, int> getStock() const { return stocks; }
 
     /**
      * @brief Returns the current funds of this Seller.
@@ -135,19 +354,36 @@ public:
      */
     [[nodiscard]] int getUniqueId() const { return uniqueId; }
 
+    /**
+     * @brief Sets the simulation seed. Each actor built afterwards seeds its own
+     *        engine from it and its unique id, so the draws of an actor do not
+     *        depend on the other actors nor on the threads.
+     */
+    static void setRandomSeed(uint32_t seed);
+
     /**
      * @brief Selects a random Seller from a list.
      * @param sellers List of available sellers.
      * @return Pointer to the randomly chosen Seller.
      */
-    static Seller* chooseRandomSeller(std::vector<Seller*>& sellers);
+    Seller* chooseRandomSeller(std::vector<Seller*>& sellers);
+
+    /// Returned by chooseRandomIndex() for an empty list.
+    static constexpr size_t NO_INDEX = static_cast<size_t>(-1);
+
+    /**
+     * @brief Selects a random index in [0, n), e.g. in a list of actor handles.
+     * @param n Size of the list.
+     * @return NO_INDEX when the list is empty.
+     */
+    size_t chooseRandomIndex(size_t n);
 
     /**
      * @brief Selects a random item from a map of available items.
      * @param itemsForSale Map of items and quantities.
      * @return The randomly chosen item type.
      */
-    static ItemType chooseRandomItem(std::map<ItemType, int>& itemsForSale);
+    ItemType chooseRandomItem(std::map<ItemType, int>& itemsForSale);
 
     /**
      * @brief Selects a random item currently in this Seller's stock.
@@ -160,6 +396,67 @@ public:
      */
     void setClock(DayClock* c) { clock = c; }
 
+    /**
+     * @brief Runs this actor in phased days: every call it makes to another
+     *        actor is applied the next day.
+     */
+    void setPhases(PhasedDay* p) { phases = p; }
+
+    /// Returned by nextWorkDay() when only another actor can give work again
+    static constexpr int NO_WORK_DAY = std::numeric_limits<int>::max();
+
+    /**
+     * @brief First day, from today on, on which running this actor changes something.
+     *
+     * Asked between two days by the time-warp clock, which only wakes the actors
+     * having work. Answering today is always correct; a later day must be exact,
+     * calls from other actors being taken into account at the next day boundary.
+     * @param today Next day to be run.
+     */
+    virtual int nextWorkDay(int today) { return today; }
+
+    /**
+     * @brief Whether this actor refuses work until it is paid. Read by payers
+     *        without taking any lock, so it must only load atomics.
+     */
+    virtual bool isWaitingForPayment() const { return false; }
+
+    /**
+     * @brief Patients this actor could take now, read by senders without taking
+     *        any lock; -1 when the actor does not publish it.
+     */
+    virtual int getFreeCapacity() const { return -1; }
+
+    /**
+     * @brief Population counter under which the patients of this actor are
+     *        counted, PatientHolder::Nothing when it holds none.
+     */
+    virtual PatientHolder patientHolder() const { return PatientHolder::Nothing; }
+
+    /**
+     * @brief Publishes the current state for monitors. Called by the thread
+     *        running the actor, once at the end of each day it runs, or by the
+     *        main thread while no actor thread runs.
+     */
+    void publishState();
+
+    /**
+     * @brief Last state published, read without any lock and never torn.
+     *        All zero, with getStateVersion() == 0, before the first one.
+     */
+    [[nodiscard]] ActorState readState() const { return published.read(); }
+
+    /**
+     * @brief Number of states published so far.
+     */
+    [[nodiscard]] uint64_t getStateVersion() const { return published.version(); }
+
+    /**
+     * @brief Counters of the actor's mutex, read without locking; all zero
+     *        for actors without one.
+     */
+    [[nodiscard]] virtual LockStats getLockStats() const { return {}; }
+
 protected:
     // ─────────────────────────────────────────────
     // Protected attributes
@@ -170,6 +467,104 @@ protected:
     int uniqueId;                    ///< Unique identifier for this seller.
     int nbEmployeesPaid{0};          ///< Total number of employees paid.
     DayClock* clock{nullptr};        ///< Pointer to the simulation clock.
+    int lastRunDay{-1};              ///< Last day run, -1 before the first one.
+    PhasedDay* phases{nullptr};      ///< Intent buffers and yesterday's states, with phased days only.
+    SeqLock<ActorState> published;   ///< State for monitors, written by publishState() only.
+    std::mt19937 rng;                ///< Random draws of this actor, used by its own thread only.
+
+    /**
+     * @brief Fills the state to publish: funds, employees paid and the stocks
+     *        map. Actors with a lock override it to read under that lock.
+     */
+    virtual void fillState(ActorState& state);
+
+    /**
+     * @brief With phased days: applies the intents received yesterday, waits
+     *        for every actor to do the same, then directs today's intents to
+     *        the outbox of this actor and settles the replies to its requests
+     *        of yesterday. Nothing without phased days.
+     */
+    void applyIntents();
+
+    /**
+     * @brief Seller to address a one-way call (invoice, payment) to: target
+     *        itself, or its proxy with phased days.
+     */
+    Seller* oneWay(Seller* target);
+
+    /**
+     * @brief Opens a ticket owned by this Seller, for reserve().
+     */
+    Reservation issue(ItemType what, int qty) {
+        uint64_t id = reservationIds.next != reservationIds.end ? reservationIds.next++ : reservationIds.refill();
+        return Reservation(this, id, what, std::max(0, qty));
+    }
+
+    /**
+     * @brief Closes a ticket being committed or aborted.
+     * @return The quantity it reserved.
+     * @throws std::logic_error If the ticket is closed or belongs to another Seller.
+     */
+    int redeem(Reservation& token) const {
+        if (!token.isOpen() || token.owner != this) rejectRedeem(token);
+        int qty = token.reserved;
+        token.id = 0;
+        token.reserved = 0;
+        return qty;
+    }
+
+private:
+    /// Ticket ids of one thread, taken by blocks from a global counter.
+    struct ReservationIds {
+        static constexpr uint64_t BLOCK = 1 << 16;
+        uint64_t next{0};
+        uint64_t end{0};
+        uint64_t refill();
+    };
+    static thread_local ReservationIds reservationIds;
+
+    [[noreturn]] void rejectRedeem(const Reservation& token) const;
+
+    /**
+     * @brief Engine seeded from the simulation seed and the id of an actor.
+     */
+    static std::mt19937 seededEngine(int uniqueId);
+
+    static uint32_t randomSeed;
+
+protected:
+    /**
+     * @brief Records that the actor runs the current day.
+     * @return Days since its previous run: 1, unless the time-warp clock skipped days.
+     */
+    int enterDay();
+
+    /**
+     * @brief Last day run, or the day before the first one if the actor has not run yet.
+     */
+    [[nodiscard]] int lastDayRun() const {
+        return lastRunDay >= 0 ? lastRunDay : (clock ? clock->first_day() : 0) - 1;
+    }
 };
 
+inline void Reservation::settle() noexcept {
+    if (isOpen()) owner->abort(*this);
+}
+
+inline Reservation& Reservation::operator=(Reservation&& other) noexcept {
+    if (this == &other) return *this;
+    settle();
+    owner = other.owner;
+    id = other.id;
+    item = other.item;
+    reserved = other.reserved;
+    other.id = 0;
+    other.reserved = 0;
+    return *this;
+}
+
+inline Reservation::~Reservation() {
+    settle();
+}
+
 #endif // SELLER_H
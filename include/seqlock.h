@@ -0,0 +1,86 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @class SeqLock
+ * @brief A value published by one writer and read by any number of readers,
+ *        none of them ever taking a lock.
+ *
+ * The writer makes the sequence odd, stores the value word by word and makes
+ * the sequence even again; a reader copies the words and retries if the
+ * sequence was odd or changed meanwhile. Readers never write shared memory,
+ * so reading does not disturb the writer's cache lines beyond sharing them.
+ * Words are relaxed atomics, which keeps a torn read free of data races.
+ * Until the first publication readers get all-zero bytes.
+ *
+ * @tparam T Trivially copyable, its size a multiple of 4 bytes.
+ */
+template<typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock values are copied word by word");
+    static_assert(sizeof(T) % sizeof(uint32_t) == 0, "SeqLock values are made of 32-bit words");
+
+public:
+    SeqLock() = default;
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * @brief Publishes a new value. Only one thread may publish at a time.
+     */
+    void publish(const T& value) {
+        uint32_t raw[NB_WORDS];
+        std::memcpy(raw, &value, sizeof(T));
+
+        uint64_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < NB_WORDS; ++i) words[i].store(raw[i], std::memory_order_relaxed);
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief One attempt at reading the value.
+     * @return False if a publication was in progress; out is then unspecified.
+     */
+    bool tryRead(T& out) const {
+        uint64_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) return false;
+
+        uint32_t raw[NB_WORDS];
+        for (size_t i = 0; i < NB_WORDS; ++i) raw[i] = words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != before) return false;
+
+        std::memcpy(&out, raw, sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief Reads a consistent value, retrying while a publication is in progress.
+     */
+    T read() const {
+        T out;
+        while (!tryRead(out)) {}
+        return out;
+    }
+
+    /**
+     * @brief Number of publications so far.
+     */
+    [[nodiscard]] uint64_t version() const { return sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t NB_WORDS = sizeof(T) / sizeof(uint32_t);
+
+    std::atomic<uint64_t> sequence{0};
+    std::array<std::atomic<uint32_t>, NB_WORDS> words{};
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,50 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include <vector>
+
+#include "seller.h"
+
+/**
+ * @class Snapshot
+ * @brief Saves and restores the full simulation state to a compact binary file.
+ *
+ * The file is a fixed header followed by one fixed-size record per actor and a
+ * pool of 32-bit integers (topology links, unpaid bills, rehab timers, random
+ * engines, credit limits and overdrafts). Records are read in place from a
+ * memory mapping.
+ *
+ * Snapshots must be taken and restored between two days, when no actor thread
+ * is working. Actors are matched by unique id, so the world being restored must
+ * be built with the same configuration as the one that was saved.
+ *
+ * The random engine of every actor is saved, so a restored actor continues
+ * the sequence of draws it would have made.
+ */
+class Snapshot {
+public:
+    /// Bumped whenever the record layout changes.
+    static constexpr unsigned VERSION = 5;
+
+    /**
+     * @brief Writes the state of every actor to a file, atomically replaced and
+     *        flushed to disk (file and directory) before returning.
+     * @param path Destination file.
+     * @param sellers Every actor of the simulation.
+     * @param day Current simulation day.
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    static void save(const std::string& path, const std::vector<Seller*>& sellers, int day);
+
+    /**
+     * @brief Restores the state of every actor from a file.
+     * @param path Snapshot file.
+     * @param sellers Every actor of the simulation, already built.
+     * @return The simulation day stored in the snapshot.
+     * @throws std::runtime_error If the file is missing, corrupt or does not match the actors.
+     */
+    static int restore(const std::string& path, const std::vector<Seller*>& sellers);
+};
+
+#endif // SNAPSHOT_H
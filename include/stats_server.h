@@ -0,0 +1,81 @@
+#ifndef STATS_SERVER_H
+#define STATS_SERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <pcosynchro/pcothread.h>
+
+#include "day_clock.h"
+#include "seller.h"
+
+/**
+ * @brief Actors of one type, reported together.
+ */
+struct StatsGroup {
+    std::string name;             ///< e.g. "clinic", used as key prefix.
+    std::vector<Seller*> actors;
+};
+
+/**
+ * @class StatsServer
+ * @brief Serves live statistics of a running simulation on a Unix-domain socket.
+ *
+ * Each client that connects receives one report, as "key value" lines, and
+ * the connection is closed. The report is built from lock-free sources only:
+ * the states the actors publish (Seller::readState()), the population
+ * counters, the day clock and the actors' mutex counters, so a client never
+ * slows the simulation down beyond the cache misses of reading them.
+ */
+class StatsServer {
+public:
+    /**
+     * @brief Binds the socket (replacing a stale file at path) and starts serving.
+     * @throws std::runtime_error If the socket cannot be created.
+     */
+    StatsServer(const std::string& path, std::vector<StatsGroup> groups, const DayClock& clock);
+
+    /**
+     * @brief Stops serving and removes the socket file.
+     */
+    ~StatsServer();
+
+    StatsServer(const StatsServer&) = delete;
+    StatsServer& operator=(const StatsServer&) = delete;
+
+    /**
+     * @brief The report a client receives now.
+     */
+    [[nodiscard]] std::string report() const;
+
+    /**
+     * @brief Client side: connects to a server and returns its report.
+     * @throws std::runtime_error If nothing listens at path.
+     */
+    static std::string query(const std::string& path);
+
+    /// Actors listed in the report with the most contended mutex
+    static constexpr int NB_HOT_LOCKS = 5;
+
+private:
+    /**
+     * @brief Server thread: accepts clients until stopped.
+     */
+    void serveLoop();
+
+    std::string path;
+    std::vector<StatsGroup> groups;
+    const DayClock& clock;
+
+    std::chrono::steady_clock::time_point start;
+    int startDay;
+    long long startFreed;
+
+    int listenFd{-1};
+    std::atomic<bool> stopping{false};
+    std::unique_ptr<PcoThread> server;
+};
+
+#endif // STATS_SERVER_H
@@ -0,0 +1,63 @@
+#ifndef STOCK_COUNTER_H
+#define STOCK_COUNTER_H
+
+#include <algorithm>
+#include <atomic>
+
+/**
+ * @brief What a take does when fewer units than asked are in stock.
+ */
+enum class Fill {
+    AllOrNothing,  ///< Takes nothing.
+    Partial        ///< Takes what is there.
+};
+
+/**
+ * @class StockCounter
+ * @brief Units of one item, taken and added without a lock.
+ *
+ * Takes are a compare-and-swap loop that never lets the count go below 0;
+ * additions are a release fetch_add, so a buyer whose take succeeds also sees
+ * everything the producer wrote before publishing the units.
+ */
+class StockCounter {
+public:
+    StockCounter() = default;
+    StockCounter(const StockCounter&) = delete;
+    StockCounter& operator=(const StockCounter&) = delete;
+
+    /**
+     * @brief Removes up to qty units.
+     * @return Units taken: qty or 0 with Fill::AllOrNothing, between 0 and qty
+     *         with Fill::Partial.
+     */
+    int tryTake(int qty, Fill fill = Fill::AllOrNothing) {
+        if (qty <= 0) return 0;
+        int current = units.load(std::memory_order_relaxed);
+        int taken;
+        do {
+            taken = fill == Fill::Partial ? std::min(qty, current) : (current >= qty ? qty : 0);
+            if (taken <= 0) return 0;
+        } while (!units.compare_exchange_weak(current, current - taken,
+                                              std::memory_order_acq_rel, std::memory_order_relaxed));
+        return taken;
+    }
+
+    /**
+     * @brief Publishes qty new units.
+     */
+    void add(int qty) { units.fetch_add(qty, std::memory_order_release); }
+
+    [[nodiscard]] int load() const { return units.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Overwrites the count. Only for setup and snapshot restore, when no
+     *        other thread takes or adds.
+     */
+    void store(int qty) { units.store(qty, std::memory_order_release); }
+
+private:
+    std::atomic<int> units{0};
+};
+
+#endif // STOCK_COUNTER_H
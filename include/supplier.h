@@ -1,10 +1,31 @@
 #ifndef SUPPLIER_H
 #define SUPPLIER_H
 
+#include <array>
+#include <atomic>
+#include <deque>
 #include <pcosynchro/pcomutex.h>
 
 #include "costs.h"
 #include "seller.h"
+#include "stock_counter.h"
+
+/**
+ * @brief How one item is manufactured: units per batch and days before they are in stock.
+ */
+struct ProductionPlan {
+    int batchSize{1};
+    int leadTimeDays{0};
+};
+
+/**
+ * @brief A batch being manufactured.
+ */
+struct ProductionBatch {
+    ItemType item;
+    int qty;
+    int daysLeft;
+};
 
 /**
  * @class Supplier
@@ -15,10 +36,18 @@
  * - Produces resources over time.
  * - Sells resources upon request from clinics.
  * - Manages its finances and available stock safely in a concurrent environment.
+ *
+ * Production runs as a pipeline: each day the supplier starts one batch of a
+ * random item (paying one employee per unit) and the work in progress moves
+ * one day closer to the stock. The stock itself is one StockCounter per item,
+ * not the Seller::stocks map: buyers take units with a compare-and-swap and
+ * never wait for the supplier's lock, which only guards money and production.
  */
 class Supplier : public Seller {
 public:
     friend class TestableSupplier;
+    /// Allows snapshots to save and restore the full state
+    friend class Snapshot;
 
     /**
      * @brief Constructs a Supplier entity.
@@ -39,14 +68,15 @@ public:
     /**
      * @brief Handles a purchase request from another Seller (e.g., clinic).
      *
-     * Deducts the purchased items from the supplier’s stock and
-     * returns the bill to the buyer.
+     * Takes all the purchased items from the supplier’s stock, or none, without
+     * locking, and returns the bill to the buyer. Money only moves when the
+     * buyer pays the bill, so the stock and the funds need no common lock.
      *
      * @param it The type of item being purchased.
      * @param qty The quantity requested.
-     * @return The total cost of the transaction.
+     * @return The total cost of the transaction, 0 if not enough is in stock.
      */
-    int buy(ItemType it, int qty) override;
+    int buy(ItemType it, int qty) final;
 
     /**
      * @brief Disabled: Suppliers do not receive invoices.
@@ -64,7 +94,12 @@ public:
      *
      * @param bill The amount of money received.
      */
-    void pay(int bill) override;
+    void pay(int bill) final;
+
+    /**
+     * @brief Purchases and payments, applied without locking on phased days.
+     */
+    int applyIntent(const Intent& intent) override;
 
     /**
      * @brief Main execution loop of the supplier.
@@ -76,6 +111,12 @@ public:
      */
     void run();
 
+    /**
+     * @brief Today while some item can be paid for, otherwise the day the
+     *        next batch of the work in progress is finished.
+     */
+    int nextWorkDay(int today) override;
+
     /**
      * @brief Computes the total material cost produced so far.
      * @return The cumulative cost associated with production.
@@ -89,6 +130,35 @@ public:
      */
     [[nodiscard]] bool sellsResource(ItemType item) const;
 
+    /**
+     * @brief Sets the batch size and lead time used to manufacture an item.
+     *        By default one unit is made per day and is in stock immediately.
+     */
+    void setProductionPlan(ItemType item, ProductionPlan plan);
+
+    /**
+     * @brief Units of an item in stock, read without locking.
+     */
+    [[nodiscard]] int getAvailable(ItemType item) const;
+
+    /**
+     * @brief Stock of every item supplied, read from the counters.
+     */
+    std::map<ItemType, int> getStock() const override;
+
+    /**
+     * @brief Number of units currently being manufactured.
+     */
+    int getWorkInProgress();
+
+    [[nodiscard]] LockStats getLockStats() const override { return mutex.stats(); }
+
+protected:
+    /**
+     * @brief Counter holding the stock of an item.
+     */
+    StockCounter& stockOf(ItemType item) { return stock[static_cast<size_t>(item)]; }
+
 private:
     /**
      * @brief Attempts to produce a random resource from the supplier’s product list.
@@ -99,8 +169,25 @@ private:
      */
     void attemptToProduceResource();
 
+    /**
+     * @brief Moves the work in progress some days ahead; finished batches go to stock.
+     * @param days Days elapsed since the previous advance.
+     */
+    void advanceProduction(int days = 1);
+
+    /**
+     * @brief Stocks from the counters; backlog: units being manufactured.
+     */
+    void fillState(ActorState& state) override;
+
 private:
     std::vector<ItemType> resourcesSupplied; ///< List of resource types the supplier can produce.
+    std::map<ItemType, ProductionPlan> plans;///< Batch size and lead time per item.
+    std::deque<ProductionBatch> workInProgress; ///< Batches started and not yet in stock.
+
+    std::array<StockCounter, static_cast<size_t>(ItemType::Nothing)> stock; ///< Units in stock per item.
+
+    ProfiledMutex mutex;                     ///< Protects money, plans and work in progress.
 };
 
 
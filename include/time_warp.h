@@ -0,0 +1,101 @@
+#ifndef TIME_WARP_H
+#define TIME_WARP_H
+
+#include <unordered_map>
+#include <vector>
+#include <pcosynchro/pcoconditionvariable.h>
+#include <pcosynchro/pcomutex.h>
+
+#include "day_clock.h"
+#include "seller.h"
+
+/**
+ * @class TimeWarpClock
+ * @brief DayClock that only runs the days on which some actor has work, and
+ *        only wakes the actors having work on that day.
+ *
+ * Between two days the main thread asks every actor its next day with work
+ * (Seller::nextWorkDay) and jumps straight to the earliest one. Actors with
+ * nothing to do stay blocked and do not take part in the barrier; the days
+ * they skip are accounted for on their next run (Seller::enterDay). The last
+ * day of the run wakes every actor, so that all of them catch up before the
+ * final balance.
+ */
+class TimeWarpClock : public DayClock {
+public:
+    /**
+     * @param actors Every actor run by a worker thread of this clock.
+     * @param lastDay Number of days of the run: day lastDay - 1 is the last one.
+     */
+    TimeWarpClock(const std::vector<Seller*>& actors, int lastDay);
+
+    using DayClock::worker_wait_day_start;
+
+    /**
+     * @brief Jumps to the next day with work and picks the actors to wake on it,
+     *        without waking them yet. Only between two days.
+     * @return The day that start_next_day() will start.
+     */
+    int skip_to_next_work_day();
+
+    /**
+     * @brief Wakes the actors having work on the next day with work (skipping
+     *        to it first, unless skip_to_next_work_day() already did).
+     */
+    void start_next_day() override;
+
+    /**
+     * @brief Waits for the actors woken today only.
+     */
+    void wait_all_done() override;
+
+    /**
+     * @throws std::logic_error Always: this clock needs to know the waiting actor.
+     */
+    void worker_wait_day_start() override;
+
+    void worker_wait_day_start(Seller* who) override;
+    void worker_end_day() override;
+
+    /**
+     * @throws std::logic_error Always: sleeping actors cannot meet at a phase barrier.
+     */
+    void worker_phase_barrier() override;
+
+    /**
+     * @brief Wakes every actor, whether it has work or not, so that it sees its stop request.
+     */
+    void release_workers() override;
+
+    /**
+     * @brief Days actually run since the start.
+     */
+    [[nodiscard]] int getDaysRun() const { return daysRun; }
+
+    /**
+     * @brief Days on which an actor stayed asleep, summed over the actors.
+     */
+    [[nodiscard]] long long getIdleActorDays() const { return idleActorDays; }
+
+private:
+    std::vector<Seller*> actors;
+    std::unordered_map<const Seller*, size_t> indexOf;
+    const int lastDay;
+
+    PcoMutex mutex;
+    PcoConditionVariable dayStarted;
+    PcoConditionVariable allArrived;
+
+    std::vector<char> due;       ///< Actors woken for the current day
+    std::vector<int> lastWake;   ///< Generation of the last day each actor was woken for
+    int generation{0};           ///< Number of days started
+    int nbDue{0};                ///< Actors woken for the current day
+    int arrived{0};              ///< Actors done with the current day
+    bool releasing{false};
+    bool planned{false};         ///< Next day already chosen by skip_to_next_work_day()
+
+    int daysRun{0};
+    long long idleActorDays{0};
+};
+
+#endif // TIME_WARP_H
@@ -0,0 +1,86 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ambulance.h"
+#include "clinic.h"
+#include "hospital.h"
+#include "supplier.h"
+
+/**
+ * @brief Who talks to whom, as indices into the actor vectors of each kind.
+ *
+ * Built once at startup by one of the generators or loaded from a file, then
+ * applied to the actors. Everything is linear in the number of edges.
+ */
+struct Topology {
+    int nbAmbulances{0};
+    int nbSuppliers{0};
+    int nbClinics{0};
+    int nbHospitals{0};
+
+    std::vector<std::vector<int>> ambulanceHospitals; ///< Hospitals each ambulance brings patients to.
+    std::vector<std::vector<int>> hospitalClinics;    ///< Clinics each hospital sends sick patients to.
+    std::vector<std::vector<int>> clinicHospitals;    ///< Hospitals each clinic sends rehab patients to.
+    std::vector<std::vector<int>> clinicSuppliers;    ///< Suppliers each clinic buys from.
+
+    /**
+     * @brief Total number of edges.
+     */
+    [[nodiscard]] size_t nbLinks() const;
+};
+
+/**
+ * @brief The historical wiring: every ambulance and clinic sees every hospital,
+ *        every clinic sees every supplier, and clinics are split evenly between
+ *        hospitals, the leftovers being shared by all of them.
+ */
+Topology makeAllToAllTopology(int nbAmbulances, int nbSuppliers, int nbClinics, int nbHospitals);
+
+/**
+ * @brief Regional graph: actors of each kind are split into contiguous regions.
+ *
+ * Ambulances reach fanOut hospitals of their region, each clinic belongs to one
+ * hospital of its region and sends rehab patients to fanOut hospitals of the
+ * region, and buys from fanOut consecutive suppliers (at least two, so that
+ * both supplier kinds are reached). Generation runs in parallel and is
+ * deterministic for a given seed.
+ * @throws std::invalid_argument If regions or fanOut are not positive, or a
+ *         region would have no hospital.
+ */
+Topology makeRegionalTopology(int nbAmbulances, int nbSuppliers, int nbClinics, int nbHospitals,
+                              int regions, int fanOut, uint32_t seed);
+
+/**
+ * @brief Writes a topology as text: a header line with the actor counts, then
+ *        one line per actor with links: "<kind> <index> <target>...".
+ */
+void saveTopology(const std::string& path, const Topology& topology);
+
+/**
+ * @brief Reads a file written by saveTopology() (or by hand).
+ * @throws std::runtime_error If the file is missing or malformed, or an
+ *         ambulance has no hospital.
+ */
+Topology loadTopology(const std::string& path);
+
+/**
+ * @brief Builds a topology from a command line description:
+ *        "all-to-all", "regional:REGIONS:FANOUT[:SEED]" or a file path.
+ */
+Topology makeTopology(const std::string& description, int nbAmbulances, int nbSuppliers,
+                      int nbClinics, int nbHospitals);
+
+/**
+ * @brief Wires the actors, in parallel.
+ * @throws std::runtime_error If the actor counts differ from the topology, an
+ *         ambulance has no hospital, or a clinic cannot buy one of the resources it needs.
+ */
+void applyTopology(const Topology& topology,
+                   const std::vector<Ambulance*>& ambulances, const std::vector<Supplier*>& suppliers,
+                   const std::vector<Clinic*>& clinics, const std::vector<Hospital*>& hospitals);
+
+#endif // TOPOLOGY_H
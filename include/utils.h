@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <iostream>
+#include <functional>
 #include <pcosynchro/pcothread.h>
 #include <pcosynchro/pcosemaphore.h>
 #include <memory>
@@ -12,6 +13,7 @@
 #include "hospital.h"
 #include "seller.h"
 #include "ambulance.h"
+#include "placement.h"
 
 #define SUPPLIER_FUND 200
 #define CLINICS_FUND 300
@@ -35,6 +37,32 @@
  */
 void endService(const std::vector<std::unique_ptr<PcoThread>>& threads);
 
+/**
+ * @brief Runs fn(i) for i in [0, n), split in contiguous chunks over a few threads.
+ * @param minChunk Smallest number of indices worth a thread of its own.
+ */
+void parallelFor(int n, const std::function<void(int)>& fn, int minChunk = 4096);
+
+/**
+ * @brief Starts one worker thread per actor, appended to threads.
+ *
+ * The threads are created in parallel from a few launcher threads. Each worker
+ * first pins itself to the NUMA node of its actor (no effect without --numa).
+ */
+template<typename Actor>
+void startWorkers(const std::vector<Actor*>& actors, std::vector<std::unique_ptr<PcoThread>>& threads) {
+    size_t first = threads.size();
+    threads.resize(first + actors.size());
+    parallelFor(static_cast<int>(actors.size()), [&](int i) {
+        Actor* actor = actors[i];
+        threads[first + i] = std::make_unique<PcoThread>([actor] {
+            placement().pinCurrentThread(actor);
+            actor->run();
+        });
+    }, 256);
+}
+
+// Les acteurs sont construits en parallèle, directement à leur place dans le vecteur
 std::vector<Ambulance*> createAmbulances(int nbAmbulances, int idStart);
 std::vector<Supplier*> createSuppliers(int nbSuppliers, int idStart);
 std::vector<Clinic*> createClinics(int nbClinics, int idStart);
@@ -0,0 +1,53 @@
+#ifndef WAIT_HISTOGRAM_H
+#define WAIT_HISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class WaitHistogram
+ * @brief Wait times in power-of-two microsecond buckets, recorded and read without locking.
+ *
+ * Bucket b counts waits below 2^b µs (bucket 0: below 1 µs); percentiles are
+ * the upper bound of their bucket, so they are exact within a factor of 2.
+ */
+class WaitHistogram {
+public:
+    static constexpr int NB_BUCKETS = 40;
+
+    void add(uint64_t ns) {
+        uint64_t us = ns / 1000;
+        int bucket = 0;
+        while (us > 0 && bucket < NB_BUCKETS - 1) {
+            us >>= 1;
+            ++bucket;
+        }
+        buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint64_t count() const {
+        uint64_t total = 0;
+        for (const auto& b : buckets) total += b.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    /**
+     * @brief Upper bound, in µs, of the bucket holding the p-th wait; 0 without waits.
+     */
+    [[nodiscard]] uint64_t percentileUs(double p) const {
+        uint64_t total = count();
+        if (total == 0) return 0;
+        auto target = static_cast<uint64_t>(p * static_cast<double>(total - 1));
+        uint64_t seen = 0;
+        for (int b = 0; b < NB_BUCKETS; ++b) {
+            seen += buckets[b].load(std::memory_order_relaxed);
+            if (seen > target) return uint64_t{1} << b;
+        }
+        return uint64_t{1} << (NB_BUCKETS - 1);
+    }
+
+private:
+    std::atomic<uint64_t> buckets[NB_BUCKETS]{};
+};
+
+#endif // WAIT_HISTOGRAM_H
@@ -1,6 +1,12 @@
 // ambulance.cpp
 #include "ambulance.h"
+#include "clinic.h"
 #include "costs.h"
+#include "hospital.h"
+#include "insurance.h"
+#include "journal.h"
+#include "phases.h"
+#include "placement.h"
 #include <pcosynchro/pcothread.h>
 
 
@@ -11,17 +17,22 @@ Ambulance::Ambulance(int id, int fund,
     for (auto it : resourcesSupplied) {
         stocks[it] = initialStocks.count(it) ? initialStocks[it] : 0;
     }
+    sickStock = &stocks[ItemType::SickPatient];
+    population().add(PatientHolder::Ambulance, *sickStock);
+    patientTracker().admit(patients, stocks[ItemType::SickPatient], PatientStage::Ambulance, uniqueId);
 }
 
 void Ambulance::run() {
     logger() << "Ambulance " <<  uniqueId << " starting with fund " << money << std::endl;
 
     while (true) {
-        clock->worker_wait_day_start();
+        clock->worker_wait_day_start(this);
         if (PcoThread::thisThread()->stopRequested()) break;
+        applyIntents();
 
         sendPatients();
 
+        publishState();
         clock->worker_end_day();
     }
 
@@ -29,29 +40,145 @@ void Ambulance::run() {
 }
 
 void Ambulance::sendPatients() {
-    // Choisir un hôpital au hasard
-    auto* hospital = chooseRandomSeller(hospitals);
+    // Aucun hôpital câblé : les patients restent dans l'ambulance
+    if (hospitalHandles.empty()) return;
+
     // Déterminer le nombre de patients à envoyer
-    int nbPatientsToTransfer = 1 + rand() % 5;
+    int nbPatientsToTransfer = std::uniform_int_distribution<int>(1, 5)(rng);
+    mutex.lock();
+    nbPatientsToTransfer = std::min(nbPatientsToTransfer, stocks[ItemType::SickPatient]);
+    mutex.unlock();
+    if (nbPatientsToTransfer == 0) return;
+
+    std::vector<Trip> trips;
+    if (dispatchMode == DispatchMode::Random) {
+        // Un hôpital au hasard, qu'il ait de la place ou non
+        trips.push_back({chooseRandomIndex(hospitalHandles.size()), nbPatientsToTransfer});
+    } else {
+        // Lits libres publiés par les hôpitaux, lus sans verrou ; ceux d'hier en journées à phases
+        std::vector<int> freeBeds(hospitalHandles.size());
+        for (size_t i = 0; i < hospitalHandles.size(); ++i) {
+            freeBeds[i] = phases ? phases->previous(hospitals[i]).freeCapacity : hospitalHandles[i].freeCapacity();
+        }
+        trips = planTrips(nbPatientsToTransfer, freeBeds);
+    }
 
-    // TODO
+    int delivered = 0;
+    for (const auto& trip : trips) {
+        int accepted = sendTrip(hospitalHandles[trip.target], trip.qty);
+        if (accepted < 0) break;
+        delivered += accepted;
+    }
+    if (delivered == 0) return;
 
+    // Une seule facture pour tous les trajets du jour
+    placement().noteCall(insurance);
+    insuranceHandle.invoice(delivered * getCostPerService(ServiceType::Transport), this);
 }
 
-void Ambulance::pay(int bill) {
+int Ambulance::sendTrip(const PatientReceiver& hospital, int qty) {
+    int salary = getEmployeeSalary(EmployeeType::EmergencyStaff);
 
-    // TODO
+    // Lits réservés d'abord, aucun verrou tenu pendant les appels à l'hôpital ;
+    // en journées à phases, l'hôpital ne répondra que demain
+    placement().noteCall(hospital.get());
+    Reservation beds = phases ? Reservation() : hospital.reserve(ItemType::SickPatient, qty);
+
+    // Payer l'équipe d'urgence avant le trajet ; sans argent, pas de trajet et les lits sont rendus
+    mutex.lock();
+    if (money < salary) {
+        mutex.unlock();
+        if (beds.isOpen()) hospital.abort(beds);
+        return -1;
+    }
+    money -= salary;
+    ++nbEmployeesPaid;
+    mutex.unlock();
+    journal().record(EventType::Salary, uniqueId, -1, ItemType::Nothing, 1, salary);
+
+    ++nbTransferCalls;
+    if (phases) {
+        // Les patients restent dans l'ambulance jusqu'à la réponse
+        phases->request(Intent::Op::Transfer, this, hospital.get(), ItemType::SickPatient, qty);
+        return 0;
+    }
 
+    patientTracker().send(patients, qty);
+    int accepted = hospital.commit(beds);
+    patientTracker().takeBack(patients);
+    handOver(hospital.get(), qty, accepted);
+    return accepted;
+}
+
+void Ambulance::handOver(const Seller* hospital, int offered, int accepted) {
+    population().reject(offered - accepted);
+    nbRejected += offered - accepted;
+    if (accepted == 0) return;
+
+    mutex.lock();
+    stocks[ItemType::SickPatient] -= accepted;
+    mutex.unlock();
+    population().add(PatientHolder::Ambulance, -accepted);
+    journal().record(EventType::Transfer, uniqueId, hospital->getUniqueId(), ItemType::SickPatient, accepted, 0);
+}
+
+int Ambulance::applyIntent(const Intent& intent) {
+    if (intent.op != Intent::Op::Pay) return Seller::applyIntent(intent);
+    // Seul ce thread touche l'ambulance pendant l'application : pas de verrou
+    money += intent.amount;
+    return 0;
+}
+
+void Ambulance::settleReplies(const std::vector<Intent>& replies) {
+    int delivered = 0;
+    for (const auto& reply : replies) {
+        handOver(phases->actorAt(reply.from), reply.qty, reply.amount);
+        delivered += reply.amount;
+    }
+    if (delivered == 0) return;
+
+    // Une seule facture pour tous les trajets de la veille
+    placement().noteCall(insurance);
+    insuranceHandle.invoice(delivered * getCostPerService(ServiceType::Transport), this);
+}
+
+void Ambulance::pay(int bill) {
+    mutex.lock();
+    money += bill;
+    mutex.unlock();
+}
+
+void Ambulance::fillState(ActorState& state) {
+    mutex.lock();
+    Seller::fillState(state);
+    state.backlog = *sickStock;
+    state.patients = *sickStock;
+    mutex.unlock();
 }
 
 void Ambulance::setHospitals(std::vector<Seller*> h) {
     hospitals = std::move(h);
+    hospitalHandles.clear();
+    for (auto* hospital : hospitals) hospitalHandles.push_back(PatientReceiver::resolve(hospital));
+}
+
+void Ambulance::setDispatchMode(DispatchMode mode) {
+    dispatchMode = mode;
 }
 
 void Ambulance::setInsurance(Seller* ins) { 
-    insurance = ins; 
+    insurance = ins;
+    insuranceHandle = InsuranceHandle::resolve(ins);
+}
+
+int Ambulance::nextWorkDay(int today) {
+    mutex.lock();
+    bool busy = stocks[ItemType::SickPatient] > 0 && money >= getEmployeeSalary(EmployeeType::EmergencyStaff);
+    mutex.unlock();
+    // Les patients ne reviennent jamais : seul un paiement peut redonner du travail
+    return busy ? today : NO_WORK_DAY;
 }
 
 int Ambulance::getNumberPatients() {
-    return stocks[ItemType::SickPatient];
+    return *sickStock;
 }
@@ -0,0 +1,103 @@
+#include "bed_allocator.h"
+
+#include <algorithm>
+#include <sched.h>
+#include <thread>
+
+BedAllocator::BedAllocator(int beds, int nbSlabs)
+    : pool(std::max(0, beds)),
+      nbSlabs(std::clamp(nbSlabs, 1, std::max(1, beds))),
+      refill(std::max(1, beds / (2 * this->nbSlabs))),
+      slabLimit(4 * refill),
+      slabs(std::make_unique<Slab[]>(static_cast<size_t>(this->nbSlabs))) {}
+
+int BedAllocator::defaultSlabCount() {
+    return std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, 64);
+}
+
+int BedAllocator::currentSlab() const {
+    int cpu = sched_getcpu();
+    return cpu < 0 ? 0 : cpu % nbSlabs;
+}
+
+int BedAllocator::takeFrom(std::atomic<int>& counter, int qty) {
+    int current = counter.load(std::memory_order_relaxed);
+    int taken;
+    do {
+        taken = std::min(qty, current);
+        if (taken <= 0) return 0;
+    } while (!counter.compare_exchange_weak(current, current - taken,
+                                            std::memory_order_acq_rel, std::memory_order_relaxed));
+    return taken;
+}
+
+int BedAllocator::claim(int qty) {
+    if (qty <= 0) return 0;
+    // Un seul CPU : le pool suffit, rien à répartir
+    if (nbSlabs == 1) return takeFrom(pool, qty);
+
+    int self = currentSlab();
+    int taken = 0;
+    while (true) {
+        uint64_t before = movesDone.load();
+        taken += scan(self, qty - taken);
+        if (taken == qty) return taken;
+        // Court : on ne conclut que si aucun lit n'était en transit pendant le parcours
+        if (inTransit.load() == 0 && movesDone.load() == before) return taken;
+    }
+}
+
+int BedAllocator::scan(int self, int qty) {
+    Slab& own = slabs[self];
+    int taken = takeFrom(own.beds, qty);
+    if (taken == qty) return taken;
+
+    // Slab à sec : on le recharge depuis le pool, un peu plus que le manque
+    int missing = qty - taken;
+    inTransit.fetch_add(1);
+    int got = takeFrom(pool, missing + refill);
+    int used = std::min(got, missing);
+    taken += used;
+    if (got > used) own.beds.fetch_add(got - used, std::memory_order_release);
+    endMove(got > used);
+
+    // Pool vide aussi : seul cas où l'on touche aux slabs des autres CPU
+    for (int i = 1; taken < qty && i < nbSlabs; ++i) {
+        taken += takeFrom(slabs[(self + i) % nbSlabs].beds, qty - taken);
+    }
+    return taken;
+}
+
+void BedAllocator::endMove(bool moved) {
+    if (moved) movesDone.fetch_add(1);
+    inTransit.fetch_sub(1);
+}
+
+void BedAllocator::release(int qty) {
+    if (qty <= 0) return;
+    if (nbSlabs == 1) {
+        pool.fetch_add(qty, std::memory_order_release);
+        return;
+    }
+
+    Slab& own = slabs[currentSlab()];
+    int now = own.beds.fetch_add(qty, std::memory_order_release) + qty;
+    if (now > slabLimit) {
+        // On redescend à refill et non à la limite : un seul déversement pour plusieurs sorties
+        inTransit.fetch_add(1);
+        int spill = takeFrom(own.beds, now - refill);
+        if (spill > 0) pool.fetch_add(spill, std::memory_order_release);
+        endMove(spill > 0);
+    }
+}
+
+int BedAllocator::available() const {
+    int total = pool.load(std::memory_order_acquire);
+    for (int i = 0; i < nbSlabs; ++i) total += slabs[i].beds.load(std::memory_order_acquire);
+    return total;
+}
+
+void BedAllocator::reset(int beds) {
+    for (int i = 0; i < nbSlabs; ++i) slabs[i].beds.store(0, std::memory_order_relaxed);
+    pool.store(std::max(0, beds), std::memory_order_release);
+}
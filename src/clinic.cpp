@@ -1,25 +1,35 @@
 #include "clinic.h"
 #include "costs.h"
+#include "hospital.h"
+#include "insurance.h"
+#include "journal.h"
+#include "phases.h"
+#include "placement.h"
 #include <pcosynchro/pcothread.h>
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <random>
 
 Clinic::Clinic(int id, int fund, std::vector<ItemType> resourcesNeeded)
 : Seller(fund, id), resourcesNeeded(std::move(resourcesNeeded)) {
     for (auto it : this->resourcesNeeded) {
         stocks[it] = 0;
+        inventoryPolicies.push_back(std::make_unique<OnDemandPolicy>());
     }
 
-    stocks[ItemType::SickPatient] = 0;
-    stocks[ItemType::RehabPatient] = 0;
+    sickStock  = &(stocks[ItemType::SickPatient] = 0);
+    rehabStock = &(stocks[ItemType::RehabPatient] = 0);
+    publishAcceptance();
 }
 
 void Clinic::run() {
     logger() << "Clinic " <<  uniqueId << " starting with fund " << money << std::endl;
 
     while (true) {
-        clock->worker_wait_day_start();
+        clock->worker_wait_day_start(this);
         if (PcoThread::thisThread()->stopRequested()) break;
+        applyIntents();
 
         // Essayer de traiter le prochain patient
         processNextPatient();
@@ -30,6 +40,7 @@ void Clinic::run() {
         // Payer les factures en retard
         payBills();
 
+        publishState();
         clock->worker_end_day();
     }
 
@@ -38,79 +49,327 @@ void Clinic::run() {
 
 
 int Clinic::transfer(ItemType what, int qty) {
+    Reservation token = reserve(what, qty);
+    return commit(token);
+}
+
+Reservation Clinic::reserve(ItemType what, int qty) {
+    if (what != ItemType::SickPatient || qty <= 0) return issue(what, 0);
+    if (!accepting.load(std::memory_order_acquire)) return issue(what, 0);
+
+    int free = arrivalsFree.load();
+    int taken;
+    do {
+        taken = std::min(qty, free);
+        if (taken <= 0) return issue(what, 0);
+    } while (!arrivalsFree.compare_exchange_weak(free, free - taken));
+
+    return issue(what, taken);
+}
+
+int Clinic::commit(Reservation& token) {
+    int qty = redeem(token);
+    if (qty <= 0) return 0;
+
+    // La place a été réservée : le push ne peut pas échouer
+    for (int i = 0; i < qty; ++i) {
+        arrivals.tryPush(patientTracker().receiveOne(PatientStage::Clinic, uniqueId));
+    }
+    nbArrived.fetch_add(qty);
+    population().add(PatientHolder::Clinic, qty);
+    return qty;
+}
 
-    // TODO
+void Clinic::abort(Reservation& token) {
+    int qty = redeem(token);
+    if (qty > 0) arrivalsFree.fetch_add(qty);
+}
+
+void Clinic::drainArrivals() {
+    int arrived = 0;
+    PatientHandle h;
 
+    mutex.lock();
+    while (arrivals.tryPop(h)) {
+        ++arrived;
+        if (h != NO_PATIENT) waitingPatients.push_back(h);
+    }
+    stocks[ItemType::SickPatient] += arrived;
+    mutex.unlock();
+
+    if (arrived == 0) return;
+    nbArrived.fetch_sub(arrived);
+    arrivalsFree.fetch_add(arrived);
+}
+
+void Clinic::publishAcceptance() {
+    accepting.store(money > 0 && unpaidBills.empty(), std::memory_order_release);
+}
+
+int Clinic::treatableWithStock() const {
+    int n = std::numeric_limits<int>::max();
+    for (auto item : resourcesNeeded) {
+        auto it = stocks.find(item);
+        n = std::min(n, it == stocks.end() ? 0 : it->second);
+    }
+    return n;
 }
 
 bool Clinic::hasResourcesForTreatment() const {
+    for (auto item : resourcesNeeded) {
+        auto it = stocks.find(item);
+        if (it == stocks.end() || it->second < 1) return false;
+    }
+    return true;
+}
 
-    // TODO
+void Clinic::consumeResources(int n) {
+    for (auto item : resourcesNeeded) {
+        stocks[item] -= n;
+    }
+}
 
+int Clinic::getResourceStock(ItemType item) const {
+    auto it = stocks.find(item);
+    return it == stocks.end() ? 0 : it->second;
 }
 
-void Clinic::payBills() {
+void Clinic::setResourceStock(ItemType item, int qty) {
+    stocks[item] = qty;
+}
 
-    // TODO
-    
+std::map<ItemType, int> Clinic::getStock() const {
+    auto out = Seller::getStock();
+    for (auto item : resourcesNeeded) out[item] = getResourceStock(item);
+    return out;
+}
+
+void Clinic::payBills() {
+    mutex.lock();
+    while (!unpaidBills.empty() && money >= unpaidBills.front().second) {
+        auto [supplier, bill] = unpaidBills.front();
+        unpaidBills.erase(unpaidBills.begin());
+        money -= bill;
+
+        // Le fournisseur est payé sans tenir notre verrou
+        mutex.unlock();
+        placement().noteCall(supplier);
+        oneWay(supplier)->pay(bill);
+        journal().record(EventType::Pay, uniqueId, supplier->getUniqueId(), ItemType::Nothing, 0, bill);
+        mutex.lock();
+    }
+    publishAcceptance();
+    mutex.unlock();
 }
 
 void Clinic::processNextPatient() {
+    drainArrivals();
+
+    mutex.lock();
+    int batch = std::min(stocks[ItemType::SickPatient], treatmentCapacity);
+    mutex.unlock();
 
-    // TODO
+    int treated = 0;
+    if (batch > 0) {
+        orderResources();
+        treated = treatPatients(batch);
+
+        mutex.lock();
+        if (treated < batch && treatableWithStock() == 0) ++nbStallDays;
+        mutex.unlock();
+    }
 
+    // Chaque patient traité consomme une unité de chaque ressource
+    for (auto& policy : inventoryPolicies) {
+        policy->recordDay(treated);
+    }
 }
 
 void Clinic::sendPatientsToRehab() {
+    if (hospitals.empty()) return;
+
+    mutex.lock();
+    int nbRehab = stocks[ItemType::RehabPatient];
+    patientTracker().send(treatedPatients, nbRehab);
+    mutex.unlock();
+
+    if (nbRehab == 0) return;
+
+    // L'hôpital est appelé sans tenir notre verrou : pas de cycle clinique <-> hôpital
+    const auto& hospital = hospitalHandles[chooseRandomIndex(hospitalHandles.size())];
+    placement().noteCall(hospital.get());
+    if (phases) {
+        // Les patients restent ici jusqu'à la réponse de l'hôpital, demain
+        phases->request(Intent::Op::Transfer, this, hospital.get(), ItemType::RehabPatient, nbRehab);
+        return;
+    }
+    int accepted = hospital.transfer(ItemType::RehabPatient, nbRehab);
+    handOver(hospital.get(), nbRehab, accepted);
+}
+
+void Clinic::handOver(const Seller* hospital, int offered, int accepted) {
+    population().reject(offered - accepted);
 
-    // TODO
+    mutex.lock();
+    stocks[ItemType::RehabPatient] -= accepted;
+    patientTracker().takeBack(treatedPatients);
+    mutex.unlock();
 
+    if (accepted == 0) return;
+
+    population().add(PatientHolder::Clinic, -accepted);
+    journal().record(EventType::Transfer, uniqueId, hospital->getUniqueId(), ItemType::RehabPatient, accepted, 0);
+
+    placement().noteCall(insurance);
+    insuranceHandle.invoice(accepted * getCostPerService(ServiceType::Treatment), this);
 }
 
 void Clinic::orderResources() {
+    for (size_t i = 0; i < resourcesNeeded.size(); ++i) {
+        orderResource(i, stocks[resourcesNeeded[i]]);
+    }
+}
 
-    // TODO
-
+void Clinic::orderResource(size_t index, int& stock) {
+    ItemType item = resourcesNeeded[index];
+
+    mutex.lock();
+    InventoryState state{stock, *sickStock + nbArrived.load(), treatmentCapacity};
+    int wanted = inventoryPolicies[index]->orderQuantity(state);
+    mutex.unlock();
+    if (wanted <= 0) return;
+
+    ResourceSeller supplier = chooseRandomSupplier(item);
+    if (!supplier) return;
+    Supplier* seller = supplier.as<Supplier>();
+
+    // Une seule commande par ressource, bornée par le stock du fournisseur :
+    // si un autre client passe avant nous, elle est refusée et on réessaiera demain
+    wanted = std::min(wanted, supplierStock(seller, item));
+    if (wanted <= 0) return;
+
+    placement().noteCall(seller);
+    ++nbPurchases;
+    if (phases) {
+        phases->request(Intent::Op::Buy, this, seller, item, wanted);
+        return;
+    }
+    int bill = supplier.buy(item, wanted);
+    if (bill == 0) return;
+
+    mutex.lock();
+    stock += wanted;
+    unpaidBills.emplace_back(seller, bill);
+    publishAcceptance();
+    mutex.unlock();
+    journal().record(EventType::Buy, seller->getUniqueId(), uniqueId, item, wanted, bill);
 }
 
-void Clinic::treatOne() {
+void Clinic::receiveResources(Supplier* supplier, ItemType item, int qty) {
+    int bill = qty * getCostPerUnit(item);
 
-    // TODO
+    mutex.lock();
+    setResourceStock(item, getResourceStock(item) + qty);
+    unpaidBills.emplace_back(supplier, bill);
+    publishAcceptance();
+    mutex.unlock();
+    journal().record(EventType::Buy, supplier->getUniqueId(), uniqueId, item, qty, bill);
+}
 
+int Clinic::applyIntent(const Intent& intent) {
+    switch (intent.op) {
+    case Intent::Op::Transfer:
+        // Réservation et file d'arrivée sont déjà sans verrou
+        return transfer(intent.item, intent.qty);
+    case Intent::Op::Pay:
+        // Seul ce thread touche la clinique pendant l'application : pas de verrou
+        money += intent.amount;
+        publishAcceptance();
+        return 0;
+    default:
+        return Seller::applyIntent(intent);
+    }
 }
 
-void Clinic::pay(int bill) {
+void Clinic::settleReplies(const std::vector<Intent>& replies) {
+    for (const auto& reply : replies) {
+        Seller* from = phases->actorAt(reply.from);
+        if (reply.op == Intent::Op::Accepted) {
+            handOver(from, reply.qty, reply.amount);
+        } else if (reply.amount > 0) {
+            // Les fournisseurs câblés sont tous des Supplier (setHospitalsAndSuppliers)
+            receiveResources(static_cast<Supplier*>(from), reply.item, reply.amount);
+        }
+    }
+}
 
-    // TODO
+void Clinic::treatOne() {
+    treatPatients(1);
+}
+
+int Clinic::treatPatients(int maxPatients) {
+    return treatBatch(maxPatients, [this] { return treatableWithStock(); }, [this](int n) { consumeResources(n); });
+}
 
+void Clinic::pay(int bill) {
+    mutex.lock();
+    money += bill;
+    publishAcceptance();
+    mutex.unlock();
 }
 
-Supplier *Clinic::chooseRandomSupplier(ItemType item) {
-    std::vector<Supplier*> availableSuppliers;
+ResourceSeller Clinic::chooseRandomSupplier(ItemType item) {
+    std::vector<const ResourceSeller*> availableSuppliers;
+    std::vector<const ResourceSeller*> stockedSuppliers;
 
-    // Sélectionner les Suppliers qui ont la ressource recherchée
-    for (Seller* seller : suppliers) {
-        auto* sup = dynamic_cast<Supplier*>(seller);
+    // Sélectionner les Suppliers qui ont la ressource recherchée,
+    // en préférant ceux qui en ont en stock (compteurs lus sans verrou)
+    for (const auto& handle : supplierHandles) {
+        Supplier* sup = handle.as<Supplier>();
         if (sup->sellsResource(item)) {
-            availableSuppliers.push_back(sup);
+            availableSuppliers.push_back(&handle);
+            if (supplierStock(sup, item) > 0) stockedSuppliers.push_back(&handle);
         }
     }
+    if (!stockedSuppliers.empty()) availableSuppliers.swap(stockedSuppliers);
 
     // Choisir aléatoirement un Supplier dans la liste
-    assert(availableSuppliers.size());
-    std::vector<Supplier*> out;
-    std::sample(availableSuppliers.begin(), availableSuppliers.end(), std::back_inserter(out),
-            1, std::mt19937{std::random_device{}()});
-    return out.front();
+    size_t chosen = chooseRandomIndex(availableSuppliers.size());
+    return chosen == NO_INDEX ? ResourceSeller{} : *availableSuppliers[chosen];
+}
+
+int Clinic::supplierStock(const Supplier* supplier, ItemType item) const {
+    return phases ? phases->previous(supplier).stock[static_cast<int>(item)] : supplier->getAvailable(item);
 }
 
 void Clinic::setHospitalsAndSuppliers(std::vector<Seller*> hospitals, std::vector<Seller*> suppliers) {
     this->hospitals = hospitals;
     this->suppliers = suppliers;
+    hospitalHandles.clear();
+    for (auto* hospital : hospitals) hospitalHandles.push_back(PatientReceiver::resolve(hospital));
+    // Les factures impayées gardent le Supplier : pas de proxy possible ici
+    supplierHandles.clear();
+    for (auto* supplier : suppliers) {
+        supplierHandles.push_back(ResourceSeller::resolve(supplier));
+        if (supplierHandles.back().isVirtual()) {
+            throw std::invalid_argument("Clinic: seller " + std::to_string(supplier->getUniqueId()) + " is not a Supplier");
+        }
+    }
 }
 
 void Clinic::setInsurance(Seller* ins) { 
-    insurance = ins; 
+    insurance = ins;
+    insuranceHandle = InsuranceHandle::resolve(ins);
+}
+
+void Clinic::setTreatmentCapacity(int capacity) {
+    treatmentCapacity = std::max(1, capacity);
+}
+
+void Clinic::setInventoryPolicy(const InventoryPolicyFactory& makePolicy) {
+    for (auto& policy : inventoryPolicies) {
+        policy = makePolicy();
+    }
 }
 
 
@@ -119,18 +378,48 @@ int Clinic::getTreatmentCost() {
 }
 
 int Clinic::getWaitingPatients() {
-    return stocks[ItemType::SickPatient];
+    return stocks[ItemType::SickPatient] + nbArrived.load();
 }
 
-int Clinic::getNumberPatients() {
-    return stocks[ItemType::SickPatient] + stocks[ItemType::RehabPatient];
+int Clinic::getUnpaidAmount() {
+    mutex.lock();
+    int total = 0;
+    for (const auto& bill : unpaidBills) total += bill.second;
+    mutex.unlock();
+    return total;
 }
 
-Pulmonology::Pulmonology(int uniqueId, int fund) :
-    Clinic::Clinic(uniqueId, fund, {ItemType::Pill, ItemType::Thermometer}) {}
+void Clinic::fillState(ActorState& state) {
+    mutex.lock();
+    Seller::fillState(state);
+    for (auto item : resourcesNeeded) state.stock[static_cast<int>(item)] = getResourceStock(item);
+    state.backlog = nbArrived.load();
+    state.patients = *sickStock + *rehabStock + nbArrived.load();
+    for (const auto& bill : unpaidBills) state.unpaid += bill.second;
+    mutex.unlock();
+}
 
-Cardiology::Cardiology(int uniqueId, int fund) :
-    Clinic::Clinic(uniqueId, fund, {ItemType::Syringe, ItemType::Stethoscope}) {}
+int Clinic::nextWorkDay(int today) {
+    int salary = getEmployeeSalary(EmployeeType::TreatmentSpecialist);
+
+    mutex.lock();
+    bool waiting = stocks[ItemType::SickPatient] > 0;
+    bool busy = nbArrived.load() > 0 || stocks[ItemType::RehabPatient] > 0 ||
+                (!unpaidBills.empty() && money >= unpaidBills.front().second) ||
+                (waiting && treatableWithStock() > 0 && money >= salary);
+    mutex.unlock();
+
+    // Sinon, des patients en attente ne débloquent rien tant qu'aucun fournisseur n'a de stock
+    for (const auto& handle : supplierHandles) {
+        if (busy || !waiting) break;
+        Supplier* sup = handle.as<Supplier>();
+        for (auto item : resourcesNeeded) {
+            busy = busy || (sup->sellsResource(item) && sup->getAvailable(item) > 0);
+        }
+    }
+    return busy ? today : NO_WORK_DAY;
+}
 
-Neurology::Neurology(int uniqueId, int fund) :
-    Clinic::Clinic(uniqueId, fund, {ItemType::Pill, ItemType::Scalpel}) {}
+int Clinic::getNumberPatients() {
+    return *sickStock + *rehabStock + nbArrived.load();
+}
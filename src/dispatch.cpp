@@ -0,0 +1,44 @@
+#include "dispatch.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+DispatchMode parseDispatchMode(const std::string& description) {
+    if (description == "random") return DispatchMode::Random;
+    if (description == "capacity") return DispatchMode::FreeCapacity;
+    throw std::invalid_argument("Bad dispatch mode: " + description);
+}
+
+std::vector<Trip> planTrips(int patients, const std::vector<int>& freeCapacity) {
+    std::vector<long long> room(freeCapacity.size());
+    long long total = 0;
+    for (size_t i = 0; i < freeCapacity.size(); ++i) {
+        room[i] = freeCapacity[i] < 0 ? patients : freeCapacity[i];
+        total += room[i];
+    }
+
+    long long toSend = std::min<long long>(patients, total);
+    if (toSend <= 0) return {};
+
+    // Part entière de chaque hôpital, puis un patient de plus aux plus grands restes
+    std::vector<int> qty(room.size());
+    std::vector<size_t> byRemainder(room.size());
+    long long left = toSend;
+    for (size_t i = 0; i < room.size(); ++i) {
+        qty[i] = static_cast<int>(toSend * room[i] / total);
+        left -= qty[i];
+        byRemainder[i] = i;
+    }
+    std::stable_sort(byRemainder.begin(), byRemainder.end(), [&](size_t a, size_t b) {
+        long long ra = toSend * room[a] % total;
+        long long rb = toSend * room[b] % total;
+        return ra != rb ? ra > rb : room[a] > room[b];
+    });
+    for (size_t k = 0; k < static_cast<size_t>(left); ++k) ++qty[byRemainder[k]];
+
+    std::vector<Trip> trips;
+    for (size_t i = 0; i < qty.size(); ++i) {
+        if (qty[i] > 0) trips.push_back({i, qty[i]});
+    }
+    return trips;
+}
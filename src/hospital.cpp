@@ -1,25 +1,35 @@
 // hospital.cpp
 #include "hospital.h"
+#include "clinic.h"
 #include "costs.h"
+#include "insurance.h"
+#include "journal.h"
+#include "phases.h"
+#include "placement.h"
 #include <pcosynchro/pcothread.h>
 
 Hospital::Hospital(int id, int fund, int maxBeds)
-: Seller(fund, id), maxBeds(maxBeds), nbNursingStaff(maxBeds) {
-    stocks[ItemType::SickPatient] = 0;
-    stocks[ItemType::RehabPatient] = 0;
+: Seller(fund, id), maxBeds(maxBeds), nbNursingStaff(maxBeds), beds(maxBeds), hasFunds(fund > 0),
+  rehabArrivals(static_cast<size_t>(std::max(maxBeds, 1))) {
+    sickStock  = &(stocks[ItemType::SickPatient] = 0);
+    rehabStock = &(stocks[ItemType::RehabPatient] = 0);
 }
 
 void Hospital::run() {
     logger() << "Hospital " <<  uniqueId << " starting with fund " << money << ", maxBeds " << maxBeds << std::endl;
 
     while (true) {
-        clock->worker_wait_day_start();
+        clock->worker_wait_day_start(this);
         if (PcoThread::thisThread()->stopRequested()) break;
+        applyIntents();
+
+        int days = enterDay();
 
         transferSickPatientsToClinic();
-        updateRehab();
+        updateRehab(days);
         payNursingStaff();
 
+        publishState();
         clock->worker_end_day();
     }
 
@@ -27,43 +37,209 @@ void Hospital::run() {
 }
 
 void Hospital::transferSickPatientsToClinic() {
+    if (clinics.empty()) return;
+
+    mutex.lock();
+    int nbSick = stocks[ItemType::SickPatient];
+    patientTracker().send(sickPatients, nbSick);
+    mutex.unlock();
+
+    if (nbSick == 0) return;
+
+    // La clinique est appelée sans tenir notre verrou : pas de cycle hôpital <-> clinique
+    const auto& clinic = clinicHandles[chooseRandomIndex(clinicHandles.size())];
+    placement().noteCall(clinic.get());
+    if (phases) {
+        // Les patients restent ici jusqu'à la réponse de la clinique, demain
+        phases->request(Intent::Op::Transfer, this, clinic.get(), ItemType::SickPatient, nbSick);
+        return;
+    }
+    int accepted = clinic.transfer(ItemType::SickPatient, nbSick);
+    handOver(clinic.get(), nbSick, accepted);
+}
+
+void Hospital::handOver(const Seller* clinic, int offered, int accepted) {
+    population().reject(offered - accepted);
 
-    // TODO
+    mutex.lock();
+    stocks[ItemType::SickPatient] -= accepted;
+    patientTracker().takeBack(sickPatients);
+    mutex.unlock();
 
+    if (accepted == 0) return;
+
+    beds.release(accepted);
+    population().add(PatientHolder::Hospital, -accepted);
+    journal().record(EventType::Transfer, uniqueId, clinic->getUniqueId(), ItemType::SickPatient, accepted, 0);
+
+    placement().noteCall(insurance);
+    insuranceHandle.invoice(accepted * getCostPerService(ServiceType::PreTreatmentStay), this);
 }
 
-void Hospital::updateRehab() {
+void Hospital::settleReplies(const std::vector<Intent>& replies) {
+    for (const auto& reply : replies) handOver(phases->actorAt(reply.from), reply.qty, reply.amount);
+}
 
-    // TODO
+void Hospital::updateRehab(int days) {
+    std::vector<PatientHandle> discharged;
 
+    mutex.lock();
+    // Les patients arrivés depuis hier commencent leur réhabilitation
+    int arrived = 0;
+    PatientHandle h;
+    while (rehabArrivals.tryPop(h)) {
+        ++arrived;
+        rehabTimers.push_back({REHAB_DURATION_DAYS, h});
+    }
+    stocks[ItemType::RehabPatient] += arrived;
+    nbRehabArrived.fetch_sub(arrived);
+
+    size_t kept = 0;
+    for (size_t i = 0; i < rehabTimers.size(); ++i) {
+        rehabTimers[i].daysLeft -= days;
+        if (rehabTimers[i].daysLeft > 0) {
+            rehabTimers[kept++] = rehabTimers[i];
+        } else if (rehabTimers[i].patient != NO_PATIENT) {
+            discharged.push_back(rehabTimers[i].patient);
+        }
+    }
+    int freed = static_cast<int>(rehabTimers.size() - kept);
+    rehabTimers.resize(kept);
+    stocks[ItemType::RehabPatient] -= freed;
+    nbFreed += freed;
+    mutex.unlock();
+
+    if (freed == 0) return;
+
+    patientTracker().discharge(discharged);
+
+    beds.release(freed);
+    population().move(PatientHolder::Hospital, PatientHolder::Freed, freed);
+    placement().noteCall(insurance);
+    insuranceHandle.invoice(freed * getCostPerService(ServiceType::Rehab), this);
 }
 
 void Hospital::payNursingStaff() {
+    int salaries = nbNursingStaff * getEmployeeSalary(EmployeeType::NursingStaff);
+
+    mutex.lock();
+    bool paid = money >= salaries;
+    if (paid) {
+        money -= salaries;
+        nbEmployeesPaid += nbNursingStaff;
+        hasFunds.store(money > 0, std::memory_order_release);
+    }
+    mutex.unlock();
 
-    // TODO
-
+    if (paid) journal().record(EventType::Salary, uniqueId, -1, ItemType::Nothing, nbNursingStaff, salaries);
 }
 
 void Hospital::pay(int bill) {
+    mutex.lock();
+    money += bill;
+    hasFunds.store(money > 0, std::memory_order_release);
+    mutex.unlock();
+}
 
-    // TODO
+void Hospital::fillState(ActorState& state) {
+    mutex.lock();
+    Seller::fillState(state);
+    state.backlog = *sickStock + nbRehabArrived.load();
+    state.patients = *sickStock + *rehabStock + nbRehabArrived.load();
+    state.freed = nbFreed;
+    mutex.unlock();
+}
 
+int Hospital::applyIntent(const Intent& intent) {
+    // Seul ce thread touche l'hôpital pendant l'application : pas de verrou
+    if (intent.op == Intent::Op::Pay) {
+        money += intent.amount;
+        hasFunds.store(money > 0, std::memory_order_release);
+        return 0;
+    }
+    if (intent.op != Intent::Op::Transfer) return Seller::applyIntent(intent);
+
+    ItemType what = intent.item;
+    if ((what != ItemType::SickPatient && what != ItemType::RehabPatient) || intent.qty <= 0) return 0;
+    if (what == ItemType::SickPatient && money <= 0) return 0;
+
+    int accepted = beds.claim(intent.qty);
+    if (what == ItemType::RehabPatient) {
+        // Même durée que les patients tirés de la file par updateRehab(), qui les décomptera aujourd'hui
+        rehabTimers.insert(rehabTimers.end(), static_cast<size_t>(accepted), RehabTimer{REHAB_DURATION_DAYS, NO_PATIENT});
+        *rehabStock += accepted;
+    } else {
+        *sickStock += accepted;
+    }
+    population().add(PatientHolder::Hospital, accepted);
+    return accepted;
 }
 
 int Hospital::transfer(ItemType what, int qty) {
-    
-    // TODO
+    Reservation token = reserve(what, qty);
+    return commit(token);
+}
 
+Reservation Hospital::reserve(ItemType what, int qty) {
+    if ((what != ItemType::SickPatient && what != ItemType::RehabPatient) || qty <= 0) {
+        return issue(what, 0);
+    }
+
+    // Fonds et lits lus sans verrou : une admission ne croise jamais le mutex
+    if (what == ItemType::SickPatient && !hasFunds.load(std::memory_order_acquire)) return issue(what, 0);
+
+    return issue(what, beds.claim(qty));
+}
+
+int Hospital::commit(Reservation& token) {
+    ItemType what = token.what();
+    int qty = redeem(token);
+    if (qty <= 0) return 0;
+
+    if (what == ItemType::RehabPatient) {
+        // Chaque patient en file occupe un lit réservé : la file ne peut pas être pleine
+        for (int i = 0; i < qty; ++i) {
+            rehabArrivals.tryPush(patientTracker().receiveOne(PatientStage::Rehab, uniqueId));
+        }
+        nbRehabArrived.fetch_add(qty);
+    } else {
+        mutex.lock();
+        stocks[what] += qty;
+        patientTracker().receive(sickPatients, qty, PatientStage::Hospital, uniqueId);
+        mutex.unlock();
+    }
+    population().add(PatientHolder::Hospital, qty);
+    return qty;
+}
+
+void Hospital::abort(Reservation& token) {
+    beds.release(redeem(token));
+}
+
+int Hospital::nextWorkDay(int today) {
+    mutex.lock();
+    bool busy = stocks[ItemType::SickPatient] > 0 || nbRehabArrived.load() > 0 ||
+                (nbNursingStaff > 0 && money >= nbNursingStaff * getEmployeeSalary(EmployeeType::NursingStaff));
+    int nextDischarge = NO_WORK_DAY;
+    for (const RehabTimer& timer : rehabTimers) {
+        // Les minuteurs ont été décomptés pour la dernière fois au dernier jour exécuté
+        nextDischarge = std::min(nextDischarge, lastDayRun() + timer.daysLeft);
+    }
+    mutex.unlock();
+    return busy ? today : std::max(today, nextDischarge);
 }
 
 int Hospital::getNumberPatients() {
-    return stocks[ItemType::SickPatient] + stocks[ItemType::RehabPatient] + nbFreed;
+    return *sickStock + *rehabStock + nbRehabArrived.load() + nbFreed;
 }
 
 void Hospital::setClinics(std::vector<Seller*> c) {
     clinics = std::move(c);
+    clinicHandles.clear();
+    for (auto* clinic : clinics) clinicHandles.push_back(PatientReceiver::resolve(clinic));
 }
 
 void Hospital::setInsurance(Seller* ins) { 
-    insurance = ins; 
+    insurance = ins;
+    insuranceHandle = InsuranceHandle::resolve(ins);
 }
@@ -1,5 +1,8 @@
 #include "insurance.h"
 #include "costs.h"
+#include "journal.h"
+#include "phases.h"
+#include "placement.h"
 #include <pcosynchro/pcothread.h>
 
 
@@ -9,34 +12,110 @@ void Insurance::run() {
     logger() << "Insurance " <<  uniqueId << " starting with fund " << money << std::endl;
 
     while (true) {
-        clock->worker_wait_day_start();
+        clock->worker_wait_day_start(this);
         if (PcoThread::thisThread()->stopRequested()) break;
+        applyIntents();
 
         // Réception de la somme des cotisations journalières des assurés
-        receiveContributions();
+        receiveContributions(enterDay());
 
         // Payer les factures
         payBills();
 
+        publishState();
         clock->worker_end_day();
     }
 
     logger() << "Insurance " <<  uniqueId << " stopping with fund " << money << std::endl;
 }
 
-void Insurance::receiveContributions() {
-
-    // TODO
+void Insurance::receiveContributions(int days) {
+    mutex.lock();
+    money += INSURANCE_CONTRIBUTION * days;
+    mutex.unlock();
+    journal().record(EventType::Contribution, -1, uniqueId, ItemType::Nothing, 0, INSURANCE_CONTRIBUTION * days);
+}
 
+int Insurance::nextWorkDay(int today) {
+    mutex.lock();
+    int next = NO_WORK_DAY;
+    // Les cotisations des jours sautés arrivent d'un coup au prochain passage
+    int daysNeeded = unpaidBills.daysUntilPayable(money, INSURANCE_CONTRIBUTION);
+    if (daysNeeded >= 0) next = daysNeeded == 0 ? today : std::max(today, lastDayRun() + daysNeeded);
+    mutex.unlock();
+    return next;
 }
 
 void Insurance::invoice(int bill, Seller* who) {
+    mutex.lock();
+    unpaidBills.add(who, bill);
+    mutex.unlock();
+    journal().record(EventType::Invoice, who->getUniqueId(), uniqueId, ItemType::Nothing, 0, bill);
+}
 
-    // TODO
+int Insurance::applyIntent(const Intent& intent) {
+    if (intent.op != Intent::Op::Invoice) return Seller::applyIntent(intent);
 
+    // Seul ce thread touche l'assurance pendant l'application : pas de verrou
+    Seller* who = phases->deferred(phases->actorAt(intent.from));
+    unpaidBills.add(who, intent.amount);
+    journal().record(EventType::Invoice, who->getUniqueId(), uniqueId, ItemType::Nothing, 0, intent.amount);
+    return 0;
 }
 
 void Insurance::payBills() {
+    mutex.lock();
+    unpaidBills.refreshPriorities();
+    while (auto payment = unpaidBills.next(money)) {
+        auto [who, bill] = *payment;
+        money -= bill;
+
+        // Le bénéficiaire est payé sans tenir notre verrou
+        mutex.unlock();
+        placement().noteCall(who);
+        who->pay(bill);
+        journal().record(EventType::Pay, uniqueId, who->getUniqueId(), ItemType::Nothing, 0, bill);
+        mutex.lock();
+    }
+    mutex.unlock();
+}
+
+int Insurance::getUnpaidAmount() {
+    mutex.lock();
+    int total = unpaidBills.getUnpaidAmount();
+    mutex.unlock();
+    return total;
+}
+
+void Insurance::fillState(ActorState& state) {
+    mutex.lock();
+    Seller::fillState(state);
+    state.unpaid = unpaidBills.getUnpaidAmount();
+    mutex.unlock();
+}
+
+void Insurance::setPaymentPolicy(const PaymentPolicy& policy) {
+    mutex.lock();
+    unpaidBills.setPolicy(policy);
+    mutex.unlock();
+}
+
+void Insurance::setCreditLimit(const Seller* who, int limit) {
+    mutex.lock();
+    unpaidBills.setCreditLimit(who, limit);
+    mutex.unlock();
+}
+
+int Insurance::getCreditLimit(const Seller* who) {
+    mutex.lock();
+    int limit = unpaidBills.getCreditLimit(who);
+    mutex.unlock();
+    return limit;
+}
 
-    // TODO
+int Insurance::getCreditLeft(const Seller* who) {
+    mutex.lock();
+    int left = unpaidBills.getCreditLeft(who, money);
+    mutex.unlock();
+    return left;
 }
@@ -0,0 +1,93 @@
+#include "inventory_policy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Units needed by today's batch.
+int batchNeed(const InventoryState& state) {
+    return std::min(state.waiting, state.capacity);
+}
+
+} // namespace
+
+int OnDemandPolicy::orderQuantity(const InventoryState& state) {
+    // Appelée sans patient (commande manuelle) : on vise au moins une unité
+    return std::max(0, std::max(1, batchNeed(state)) - state.stock);
+}
+
+ReorderPointPolicy::ReorderPointPolicy(int reorderPoint, int orderUpTo)
+: reorderPoint(reorderPoint), orderUpTo(orderUpTo) {
+    if (reorderPoint < 0 || orderUpTo <= reorderPoint) {
+        throw std::invalid_argument("ReorderPointPolicy: expected 0 <= s < S");
+    }
+}
+
+int ReorderPointPolicy::orderQuantity(const InventoryState& state) {
+    int left = state.stock - batchNeed(state);
+    if (left > reorderPoint) return 0;
+    return orderUpTo - left;
+}
+
+MovingAverageDemandPolicy::MovingAverageDemandPolicy(int window, int coverDays)
+: window(static_cast<size_t>(window)), coverDays(coverDays) {
+    if (window <= 0 || coverDays < 0) {
+        throw std::invalid_argument("MovingAverageDemandPolicy: expected window > 0 and cover >= 0");
+    }
+}
+
+int MovingAverageDemandPolicy::orderQuantity(const InventoryState& state) {
+    int need = batchNeed(state);
+    int ahead = static_cast<int>(std::ceil(averageDemand() * coverDays));
+    // On ne commande que si demain ne serait plus couvert, et alors pour plusieurs jours
+    int tomorrow = static_cast<int>(std::ceil(averageDemand()));
+    if (state.stock >= need + tomorrow && state.stock > 0) return 0;
+    return std::max(0, std::max(need + ahead, 1) - state.stock);
+}
+
+void MovingAverageDemandPolicy::recordDay(int consumed) {
+    history.push_back(consumed);
+    sum += consumed;
+    if (history.size() > window) {
+        sum -= history.front();
+        history.pop_front();
+    }
+}
+
+double MovingAverageDemandPolicy::averageDemand() const {
+    return history.empty() ? 0.0 : static_cast<double>(sum) / static_cast<double>(history.size());
+}
+
+InventoryPolicyFactory parseInventoryPolicy(const std::string& description) {
+    std::vector<std::string> parts;
+    std::stringstream ss(description);
+    for (std::string part; std::getline(ss, part, ':');) parts.push_back(part);
+
+    auto number = [&](size_t i) {
+        try {
+            return std::stoi(parts.at(i));
+        } catch (const std::exception&) {
+            throw std::invalid_argument("Bad inventory policy: " + description);
+        }
+    };
+
+    if (parts.size() == 1 && parts[0] == "on-demand") {
+        return [] { return std::make_unique<OnDemandPolicy>(); };
+    }
+    if (parts.size() == 3 && parts[0] == "sS") {
+        int s = number(1), S = number(2);
+        ReorderPointPolicy check(s, S);
+        return [s, S] { return std::make_unique<ReorderPointPolicy>(s, S); };
+    }
+    if (parts.size() == 3 && parts[0] == "moving-average") {
+        int window = number(1), cover = number(2);
+        MovingAverageDemandPolicy check(window, cover);
+        return [window, cover] { return std::make_unique<MovingAverageDemandPolicy>(window, cover); };
+    }
+    throw std::invalid_argument("Bad inventory policy: " + description);
+}
@@ -0,0 +1,193 @@
+#include "journal.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char MAGIC[8] = "PCOJRNL";
+constexpr uint64_t INITIAL_CAPACITY = 1 << 16;   // events per segment before growing
+const std::string SEGMENT_PREFIX = "segment-";
+const std::string SEGMENT_SUFFIX = ".pcoj";
+
+// Unique sur toutes les instances, pour qu'un segment thread_local ne soit jamais réutilisé à tort
+std::atomic<uint64_t> nextGeneration{1};
+
+size_t fileSize(uint64_t capacity) {
+    return sizeof(JournalSegmentHeader) + capacity * sizeof(JournalEvent);
+}
+
+bool isSegmentFile(const std::filesystem::path& p) {
+    const std::string name = p.filename().string();
+    return name.rfind(SEGMENT_PREFIX, 0) == 0 && p.extension() == SEGMENT_SUFFIX;
+}
+
+} // namespace
+
+/**
+ * @brief One thread's memory-mapped segment file.
+ */
+struct Journal::Segment {
+    Segment(const std::string& path) : path(path) {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) throw std::runtime_error("Journal: cannot create " + path);
+        map(INITIAL_CAPACITY);
+
+        std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+        header->version = VERSION;
+        header->eventSize = sizeof(JournalEvent);
+        header->count = 0;
+    }
+
+    ~Segment() {
+        if (header) ::munmap(header, fileSize(capacity));
+        if (fd >= 0) ::close(fd);
+    }
+
+    void map(uint64_t newCapacity) {
+        if (::ftruncate(fd, static_cast<off_t>(fileSize(newCapacity))) != 0) {
+            throw std::runtime_error("Journal: cannot grow " + path);
+        }
+        if (header) ::munmap(header, fileSize(capacity));
+        void* mapped = ::mmap(nullptr, fileSize(newCapacity), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) throw std::runtime_error("Journal: cannot map " + path);
+        header = static_cast<JournalSegmentHeader*>(mapped);
+        events = reinterpret_cast<JournalEvent*>(header + 1);
+        capacity = newCapacity;
+    }
+
+    void append(const JournalEvent& event) {
+        if (count == capacity) map(capacity * 2);
+        events[count++] = event;
+        header->count = count;
+    }
+
+    /**
+     * @brief Drops the unused tail of the file.
+     */
+    void finish() {
+        ::munmap(header, fileSize(capacity));
+        header = nullptr;
+        if (::ftruncate(fd, static_cast<off_t>(fileSize(count))) != 0) {
+            throw std::runtime_error("Journal: cannot truncate " + path);
+        }
+    }
+
+    std::string path;
+    int fd{-1};
+    JournalSegmentHeader* header{nullptr};
+    JournalEvent* events{nullptr};
+    uint64_t capacity{0};
+    uint64_t count{0};
+};
+
+Journal::Journal() = default;
+
+Journal::~Journal() {
+    if (isOpen()) close();
+}
+
+void Journal::open(const std::string& dir) {
+    if (isOpen()) close();
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (!std::filesystem::is_directory(dir)) throw std::runtime_error("Journal: cannot use directory " + dir);
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (isSegmentFile(entry.path())) std::filesystem::remove(entry.path());
+    }
+
+    directory = dir;
+    day.store(0, std::memory_order_relaxed);
+    generation.store(nextGeneration.fetch_add(1));
+    enabled.store(true);
+}
+
+void Journal::close() {
+    enabled.store(false);
+
+    mutex.lock();
+    for (auto& segment : segments) segment->finish();
+    segments.clear();
+    mutex.unlock();
+}
+
+Journal::Segment* Journal::localSegment() {
+    thread_local Segment* segment = nullptr;
+    thread_local uint64_t segmentGeneration = 0;
+
+    uint64_t current = generation.load(std::memory_order_acquire);
+    if (segment && segmentGeneration == current) return segment;
+
+    mutex.lock();
+    std::string path = directory + "/" + SEGMENT_PREFIX + std::to_string(segments.size()) + SEGMENT_SUFFIX;
+    segments.push_back(std::make_unique<Segment>(path));
+    segment = segments.back().get();
+    mutex.unlock();
+
+    segmentGeneration = current;
+    return segment;
+}
+
+void Journal::record(EventType type, int from, int to, ItemType item, int qty, int amount) {
+    if (!isOpen()) return;
+
+    JournalEvent event{};
+    event.timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now().time_since_epoch()).count());
+    event.day = day.load(std::memory_order_relaxed);
+    event.from = from;
+    event.to = to;
+    event.qty = qty;
+    event.amount = amount;
+    event.type = type;
+    event.item = item;
+
+    localSegment()->append(event);
+}
+
+JournalSegments::JournalSegments(const std::string& dir) {
+    auto fail = [&](const std::string& message) {
+        for (auto& [base, size] : mappings) ::munmap(base, size);
+        throw std::runtime_error(message);
+    };
+
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (!isSegmentFile(entry.path())) continue;
+
+        int fd = ::open(entry.path().c_str(), O_RDONLY);
+        struct stat st{};
+        if (fd < 0 || ::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(JournalSegmentHeader))) {
+            if (fd >= 0) ::close(fd);
+            fail("Journal: unreadable segment " + entry.path().string());
+        }
+        size_t size = static_cast<size_t>(st.st_size);
+        void* base = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) fail("Journal: cannot map " + entry.path().string());
+        mappings.emplace_back(base, size);
+        ::madvise(base, size, MADV_SEQUENTIAL);
+
+        const auto* header = static_cast<const JournalSegmentHeader*>(base);
+        if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != Journal::VERSION
+            || header->eventSize != sizeof(JournalEvent) || fileSize(header->count) > size) {
+            fail("Journal: corrupt segment " + entry.path().string());
+        }
+        segments.push_back({reinterpret_cast<const JournalEvent*>(header + 1), header->count});
+    }
+}
+
+JournalSegments::~JournalSegments() {
+    for (auto& [base, size] : mappings) ::munmap(base, size);
+}
+
+Journal& journal() {
+    static Journal instance;
+    return instance;
+}
@@ -1,6 +1,11 @@
 // main.cpp (headless)
+#include <algorithm>
 #include <iostream>
+#include <fstream>
 #include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include <pcosynchro/pcothread.h>
 
@@ -11,9 +16,21 @@
 #include "insurance.h"
 
 #include "day_clock.h"
+#include "inventory_policy.h"
+#include "journal.h"
+#include "metrics.h"
+#include "partition.h"
+#include "stats_server.h"
+#include "phases.h"
+#include "placement.h"
+#include "population.h"
+#include "snapshot.h"
+#include "time_warp.h"
+#include "topology.h"
 #include "utils.h"
 
 
+
 int main(int argc, char **argv) {
     int NB_DAYS;
     int NB_SUPPLIER;
@@ -21,6 +38,22 @@ int main(int argc, char **argv) {
     int NB_CLINICS;
     int NB_HOSPITALS;
     int NB_AMBULANCE;
+    std::string SNAPSHOT_FILE;
+    std::string JOURNAL_DIR;
+    std::string METRICS_FILE;
+    std::string STATS_SOCKET;
+    int TREATMENT_CAPACITY = 1;
+    ProductionPlan PRODUCTION_PLAN;
+    bool TIME_WARP = false;
+    bool PHASED = false;
+    int NB_PARTITIONS = 1;
+    std::string TOPOLOGY;
+    InventoryPolicyFactory INVENTORY_POLICY = parseInventoryPolicy("on-demand");
+    PaymentPolicy PAYMENT_POLICY;
+    DispatchMode DISPATCH_MODE = DispatchMode::FreeCapacity;
+
+    // Réglé une seule fois, et non plus par chaque acteur construit
+    logger().setVerbosity(1);
 
     // Valeurs par défaut
     const int DEFAULT_DAYS = 6;
@@ -30,6 +63,80 @@ int main(int argc, char **argv) {
     const int DEFAULT_HOSPITAL = 2;
     const int DEFAULT_AMBULANCE = 2;
 
+    // Options facultatives --nom=valeur, retirées avant les paramètres positionnels
+    std::vector<char*> positional;
+    for (int i = 0; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i == 0 || arg.rfind("--", 0) != 0) {
+            positional.push_back(argv[i]);
+            continue;
+        }
+        auto eq = arg.find('=');
+        std::string name  = arg.substr(2, eq == std::string::npos ? std::string::npos : eq - 2);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if (name == "snapshot")     SNAPSHOT_FILE = value;
+        else if (name == "journal") JOURNAL_DIR = value;
+        else if (name == "metrics") METRICS_FILE = value;
+        else if (name == "stats")   STATS_SOCKET = value;
+        else if (name == "track-patients") patientTracker().enable();
+        else if (name == "treatment-capacity") TREATMENT_CAPACITY = atoi(value.c_str());
+        else if (name == "time-warp") TIME_WARP = true;
+        else if (name == "phased") PHASED = true;
+        else if (name == "partitions") NB_PARTITIONS = atoi(value.c_str());
+        else if (name == "numa") placement().enable();
+        else if (name == "seed") Seller::setRandomSeed(static_cast<uint32_t>(strtoul(value.c_str(), nullptr, 10)));
+        else if (name == "topology") TOPOLOGY = value;
+        else if (name == "production") {
+            // BATCH:LEAD, par exemple 5:2
+            auto colon = value.find(':');
+            PRODUCTION_PLAN.batchSize = atoi(value.substr(0, colon).c_str());
+            PRODUCTION_PLAN.leadTimeDays = colon == std::string::npos ? 0 : atoi(value.substr(colon + 1).c_str());
+        }
+        else if (name == "inventory") {
+            try {
+                INVENTORY_POLICY = parseInventoryPolicy(value);
+            } catch (const std::invalid_argument& e) {
+                printf("%s\n", e.what());
+                return 1;
+            }
+        }
+        else if (name == "dispatch") {
+            try {
+                DISPATCH_MODE = parseDispatchMode(value);
+            } catch (const std::invalid_argument& e) {
+                printf("%s\n", e.what());
+                return 1;
+            }
+        }
+        else if (name == "payments") {
+            try {
+                PAYMENT_POLICY = parsePaymentPolicy(value);
+            } catch (const std::invalid_argument& e) {
+                printf("%s\n", e.what());
+                return 1;
+            }
+        }
+        else {
+            printf("Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (TIME_WARP && !SNAPSHOT_FILE.empty()) {
+        printf("--time-warp cannot be combined with --snapshot\n");
+        return 1;
+    }
+    if (PHASED && (TIME_WARP || !SNAPSHOT_FILE.empty() || patientTracker().isEnabled())) {
+        printf("--phased cannot be combined with --time-warp, --snapshot or --track-patients\n");
+        return 1;
+    }
+    if (NB_PARTITIONS != 1 && (!PHASED || !JOURNAL_DIR.empty() || !METRICS_FILE.empty() ||
+                               !STATS_SOCKET.empty() || placement().isEnabled())) {
+        printf("--partitions needs --phased, and cannot be combined with --journal, --metrics, --stats or --numa\n");
+        return 1;
+    }
+    argc = static_cast<int>(positional.size());
+    argv = positional.data();
+
     // Si aucun argument supplémentaire : utiliser les valeurs par défaut
     if (argc == 1) {
         NB_DAYS      = DEFAULT_DAYS;
@@ -51,6 +158,11 @@ int main(int argc, char **argv) {
     else if (argc != 7) {
         printf("Usage: %s NB_DAYS\n or\n", argv[0]);
         printf("Usage: %s NB_DAYS NB_SUPPLIER NB_INSURANCE NB_CLINIC NB_HOSPITAL NB_AMBULANCE\n", argv[0]);
+        printf("Options: --snapshot=FILE --journal=DIR --metrics=FILE[.csv] --track-patients --treatment-capacity=N\n");
+        printf("         --inventory=on-demand|sS:s:S|moving-average:WINDOW:COVER --production=BATCH:LEAD\n");
+        printf("         --numa --topology=all-to-all|regional:REGIONS:FANOUT[:SEED]|FILE\n");
+        printf("         --time-warp --phased --partitions=N --payments=fifo|priority[:CREDIT[:partial]]\n");
+        printf("         --dispatch=random|capacity --stats=SOCKET --seed=N\n");
         return 1;
     }
     // Sinon : lire les valeurs depuis argv
@@ -69,54 +181,128 @@ int main(int argc, char **argv) {
     auto clinics    = createClinics(NB_CLINICS, NB_AMBULANCE + NB_HOSPITALS + NB_SUPPLIER);
 
     Insurance insurance(NB_AMBULANCE + NB_HOSPITALS + NB_CLINICS + NB_SUPPLIER + NB_INSURANCE, INSURANCE_FUND);
+    insurance.setPaymentPolicy(PAYMENT_POLICY);
+
+    std::vector<Seller*> allSellers;
+    allSellers.insert(allSellers.end(), ambulances.begin(), ambulances.end());
+    allSellers.insert(allSellers.end(), suppliers.begin(), suppliers.end());
+    allSellers.insert(allSellers.end(), hospitals.begin(), hospitals.end());
+    allSellers.insert(allSellers.end(), clinics.begin(), clinics.end());
+    allSellers.push_back(&insurance);
+
+    Seller* insuranceLink = &insurance;
+
+    // Avec --phased, tout appel d'un acteur à un autre devient une intention appliquée
+    // le lendemain par le thread du destinataire
+    std::unique_ptr<PhasedDay> phases;
+    if (PHASED) {
+        phases = std::make_unique<PhasedDay>(allSellers);
+        for (auto* s : allSellers) s->setPhases(phases.get());
+        insuranceLink = phases->deferred(&insurance);
+    }
 
-    std::vector<Seller*> sellersHospitals;
-    sellersHospitals.reserve(hospitals.size());
-    for (auto* h : hospitals) sellersHospitals.push_back(h);
-
-    std::vector<Seller*> sellersSuppliers;
-    sellersSuppliers.reserve(suppliers.size());
-    for (auto* s : suppliers) sellersSuppliers.push_back(s);
-
-    int clinicsByHospital = NB_CLINICS / NB_HOSPITALS;
-    int clinicsShared     = NB_CLINICS % NB_HOSPITALS;
-    int countClinic = 0;
-
-    for (auto & hospital : hospitals) {
-        std::vector<Seller*> tmpClinics;
-        int start = countClinic;
-        int end   = countClinic + clinicsByHospital;
-        for (int k = start; k < end && k < (int)clinics.size(); ++k)
-            tmpClinics.push_back(clinics[k]);
-        // partage
-        for (int k = NB_CLINICS - clinicsShared; k < NB_CLINICS; ++k)
-            if (k >= 0 && k < (int)clinics.size())
-                tmpClinics.push_back(clinics[k]);
-
-        hospital->setClinics(tmpClinics);
-        hospital->setInsurance(&insurance);
-        countClinic += clinicsByHospital;
+    // Avec --partitions, les acteurs sont répartis entre plusieurs processus
+    // qui n'échangent que des intentions, par mémoire partagée
+    std::unique_ptr<Partition> partition;
+    if (NB_PARTITIONS != 1) {
+        try {
+            partition = std::make_unique<Partition>(NB_PARTITIONS, static_cast<int>(allSellers.size()));
+        } catch (const std::exception& e) {
+            printf("%s\n", e.what());
+            return 1;
+        }
+        phases->setPartition(partition.get());
+    }
+    // Acteurs exécutés par ce processus : tous, sauf avec --partitions
+    auto runsHere = [&phases](const Seller* s) {
+        return !phases || phases->isLocal(phases->indexOf(s));
+    };
+    auto localOnly = [&runsHere](const auto& group) {
+        std::decay_t<decltype(group)> out;
+        for (auto* s : group) {
+            if (runsHere(s)) out.push_back(s);
+        }
+        return out;
+    };
+
+    // Qui parle à qui : par défaut le câblage historique (tous vers tous)
+    Topology topology;
+    try {
+        topology = makeTopology(TOPOLOGY, static_cast<int>(ambulances.size()), static_cast<int>(suppliers.size()),
+                                static_cast<int>(clinics.size()), static_cast<int>(hospitals.size()));
+        applyTopology(topology, ambulances, suppliers, clinics, hospitals);
+    } catch (const std::exception& e) {
+        printf("%s\n", e.what());
+        return 1;
     }
 
+    for (auto* h : hospitals)  h->setInsurance(insuranceLink);
     for (auto* a : ambulances) {
-        a->setHospitals(sellersHospitals);
-        a->setInsurance(&insurance);
+        a->setInsurance(insuranceLink);
+        a->setDispatchMode(DISPATCH_MODE);
+    }
+
+    for (auto* s : suppliers) {
+        for (auto item : {ItemType::Syringe, ItemType::Pill, ItemType::Scalpel, ItemType::Thermometer, ItemType::Stethoscope}) {
+            s->setProductionPlan(item, PRODUCTION_PLAN);
+        }
     }
 
     for (auto* c : clinics) {
-        c->setHospitalsAndSuppliers(sellersHospitals, sellersSuppliers);
-        c->setInsurance(&insurance);
+        c->setInsurance(insuranceLink);
+        c->setTreatmentCapacity(TREATMENT_CAPACITY);
+        c->setInventoryPolicy(INVENTORY_POLICY);
     }
 
-    const int PARTICIPANTS =
-        (int)ambulances.size() +
-        (int)suppliers.size()  +
-        (int)clinics.size()    +
-        (int)hospitals.size()  + 
-        NB_INSURANCE; // +1 pour l'assurance
+    // Chaque hôpital et ses cliniques propres sur le même nœud NUMA ; les cliniques
+    // partagées entre hôpitaux et les autres acteurs sur les nœuds les moins chargés
+    if (placement().isEnabled()) {
+        placement().setNodes(readNumaNodes());
+        std::vector<int> nbHospitalsOfClinic(clinics.size(), 0);
+        for (const auto& list : topology.hospitalClinics) {
+            for (int c : list) ++nbHospitalsOfClinic[c];
+        }
+        for (size_t h = 0; h < hospitals.size(); ++h) {
+            std::vector<Seller*> group = {hospitals[h]};
+            for (int c : topology.hospitalClinics[h]) {
+                if (nbHospitalsOfClinic[c] == 1) group.push_back(clinics[c]);
+            }
+            placement().placeGroup(group);
+        }
+        for (size_t c = 0; c < clinics.size(); ++c) {
+            if (nbHospitalsOfClinic[c] != 1) placement().placeGroup({clinics[c]});
+        }
+        for (auto* a : ambulances) placement().placeGroup({a});
+        for (auto* s : suppliers)  placement().placeGroup({s});
+        placement().placeGroup({&insurance});
+    }
 
+    // Chaque processus continue avec le monde câblé jusqu'ici, avant le moindre thread ;
+    // seul le premier écrit sur la sortie standard
+    if (partition) {
+        partition->forkProcesses();
+        if (!partition->isMain()) std::cout.setstate(std::ios::failbit);
+    }
 
-    DayClock clock(PARTICIPANTS);
+    const int PARTICIPANTS = static_cast<int>(localOnly(allSellers).size());
+
+
+    std::unique_ptr<DayClock> clockOwner;
+    TimeWarpClock* warp = nullptr;
+    if (TIME_WARP) {
+        // Seuls les jours où un acteur a du travail sont exécutés
+        auto owner = std::make_unique<TimeWarpClock>(allSellers, NB_DAYS);
+        warp = owner.get();
+        clockOwner = std::move(owner);
+    } else if (partition) {
+        // Les threads principaux des processus se retrouvent à chaque fin de journée
+        clockOwner = std::make_unique<SharedDayClock>(PARTICIPANTS, partition.get());
+    } else {
+        clockOwner = std::make_unique<DayClock>(PARTICIPANTS);
+    }
+    DayClock& clock = *clockOwner;
+    // Les réponses aux transferts et achats sont acheminées entre l'application et le règlement
+    if (phases) clock.set_phase_step([&phases] { phases->routeReplies(); });
 
     for (auto* a : ambulances) a->setClock(&clock);
     for (auto* s : suppliers)  s->setClock(&clock);
@@ -124,27 +310,122 @@ int main(int argc, char **argv) {
     for (auto* h : hospitals)  h->setClock(&clock);
     insurance.setClock(&clock);
 
+    // Reprise depuis un snapshot existant, sauvegardé ensuite à chaque fin de journée
+    if (!SNAPSHOT_FILE.empty() && std::ifstream(SNAPSHOT_FILE).good()) {
+        clock.set_current_day(Snapshot::restore(SNAPSHOT_FILE, allSellers));
+        std::cout << "Resuming from " << SNAPSHOT_FILE << " at day " << clock.current_day() << "\n";
+    }
+
+    // État de départ visible des moniteurs avant la première journée, et lu par les acteurs le jour 0
+    for (auto* s : localOnly(allSellers)) s->publishState();
+    if (phases) phases->swapBuffers();
+
+    // Journal d'audit : état de départ de chaque acteur
+    if (!JOURNAL_DIR.empty()) {
+        journal().open(JOURNAL_DIR);
+        journal().setDay(clock.current_day());
+        for (auto* s : allSellers) {
+            auto stock = s->getStock();
+            journal().record(EventType::Initial, -1, s->getUniqueId(), ItemType::Nothing,
+                             stock[ItemType::SickPatient] + stock[ItemType::RehabPatient], s->getFund());
+        }
+    }
+
     std::vector<std::unique_ptr<PcoThread>> threads;
     threads.reserve(ambulances.size() + suppliers.size() + clinics.size() + hospitals.size() + NB_INSURANCE);
 
-    for (auto* a : ambulances) threads.emplace_back(std::make_unique<PcoThread>(&Ambulance::run, a));
-    for (auto* s : suppliers)  threads.emplace_back(std::make_unique<PcoThread>(&Supplier::run,  s));
-    for (auto* c : clinics)    threads.emplace_back(std::make_unique<PcoThread>(&Clinic::run,    c));
-    for (auto* h : hospitals)  threads.emplace_back(std::make_unique<PcoThread>(&Hospital::run,  h));
-    threads.emplace_back(std::make_unique<PcoThread>(&Insurance::run, &insurance));
+    // Démarrage groupé : les threads sont créés en parallèle par type d'acteur
+    startWorkers(localOnly(ambulances), threads);
+    startWorkers(localOnly(suppliers), threads);
+    startWorkers(localOnly(clinics), threads);
+    startWorkers(localOnly(hospitals), threads);
+    startWorkers(localOnly(std::vector<Insurance*>{&insurance}), threads);
+
+    // Export des agrégats journaliers, écrit en arrière-plan
+    std::unique_ptr<MetricsExporter> metrics;
+    if (!METRICS_FILE.empty()) {
+        metrics = std::make_unique<MetricsExporter>(METRICS_FILE, ambulances, suppliers, clinics, hospitals,
+                                                    std::vector<Insurance*>{&insurance});
+    }
+
+    // Statistiques en direct sur un socket local, lues sans verrou
+    std::unique_ptr<StatsServer> stats;
+    if (!STATS_SOCKET.empty()) {
+        try {
+            stats = std::make_unique<StatsServer>(STATS_SOCKET, std::vector<StatsGroup>{
+                {"ambulance", {ambulances.begin(), ambulances.end()}},
+                {"supplier",  {suppliers.begin(), suppliers.end()}},
+                {"clinic",    {clinics.begin(), clinics.end()}},
+                {"hospital",  {hospitals.begin(), hospitals.end()}},
+                {"insurance", {&insurance}}}, clock);
+        } catch (const std::runtime_error& e) {
+            printf("%s\n", e.what());
+        }
+    }
+
+    const char* const holderNames[] = {"ambulances", "hospitals", "clinics", "freed"};
 
-    for (int d = 0; d < NB_DAYS; ++d) {
+    const int lastDay = clock.current_day() + NB_DAYS;
+    while (clock.current_day() < lastDay) {
+        if (warp) warp->skip_to_next_work_day();
+        int d = clock.current_day();
+        journal().setDay(clock.current_day());
+        patientTracker().setDay(clock.current_day());
         clock.start_next_day(); // “jour d” commence pour tout le monde
         clock.wait_all_done();  // attend que tous aient fini leur journée
+
+        // Intentions de la journée regroupées par destinataire, états publiés lus demain
+        if (phases) phases->swapBuffers();
+
+        // Les acteurs sautés par le time-warp ont pu recevoir des patients : tous republient
+        for (auto* s : localOnly(allSellers)) s->publishState();
+        // Avec --partitions, les compteurs de population ne voient que ce processus
+        for (const auto& m : partition ? std::vector<PopulationMismatch>{} : population().crossCheck(allSellers)) {
+            std::cout << "Day " << d << " : " << m.counted << " patients counted in "
+                      << holderNames[static_cast<int>(m.holder)] << ", " << m.published << " published\n";
+        }
+
+        if (metrics) metrics->sampleDay(clock.current_day() - 1);
+
+        if (!SNAPSHOT_FILE.empty()) {
+            Snapshot::save(SNAPSHOT_FILE, allSellers, clock.current_day());
+        }
     }
 
     // Stop les threads
     endService(threads);
 
-    clock.start_next_day(); // Libère les potentiels worker bloqué
+    clock.release_workers(); // Libère les potentiels worker bloqué
 
     for (auto& t : threads) t->join();
 
+    // Intentions du dernier jour, appliquées une fois les threads arrêtés
+    if (phases) phases->applyAll();
+
+    if (journal().isOpen()) journal().close();
+    metrics.reset();
+    stats.reset();
+
+    // État final de chaque acteur ; avec --partitions, chaque processus écrit celui
+    // des siens et seul le premier fait le bilan
+    std::unordered_map<const Seller*, ActorState> finals;
+    for (size_t i = 0; i < allSellers.size(); ++i) {
+        if (!runsHere(allSellers[i])) continue;
+        allSellers[i]->publishState();
+        finals[allSellers[i]] = allSellers[i]->readState();
+        if (partition) partition->setFinalState(static_cast<int>(i), finals[allSellers[i]]);
+    }
+    if (partition) {
+        if (!partition->isMain()) return 0;
+        try {
+            partition->join();
+        } catch (const std::runtime_error& e) {
+            printf("%s\n", e.what());
+            return 1;
+        }
+        for (size_t i = 0; i < allSellers.size(); ++i) finals[allSellers[i]] = partition->getFinalState(static_cast<int>(i));
+    }
+
     int startPatient = INITIAL_PATIENT_SICK;
     int endPatient   = 0;
 
@@ -155,55 +436,71 @@ int main(int argc, char **argv) {
                     INSURANCE_FUND;
 
     int endFund = 0;
+    int treated = 0;
 
     for (Ambulance* a : ambulances) {
-        int ambulanceFinalFund = a->getFund();
+        const ActorState& state = finals.at(a);
+        int ambulanceFinalFund = state.fund;
         std::cout << "Final fund for ambulance is : " << ambulanceFinalFund  << "\n";
         endFund += ambulanceFinalFund;
 
-        int ambulanceAmountPaidToEmployees = a->getAmountPaidToEmployees(EmployeeType::EmergencyStaff);
+        int ambulanceAmountPaidToEmployees = state.employeesPaid * getEmployeeSalary(EmployeeType::EmergencyStaff);
         std::cout << "Final amount paid for employees for ambulance is : " << ambulanceAmountPaidToEmployees << "\n\n";
         endFund += ambulanceAmountPaidToEmployees;
 
-        endPatient += a->getNumberPatients();
+        endPatient += state.patients;
     }
     for (Supplier* s : suppliers) {
-        int supplierFinalFund = s->getFund();
+        const ActorState& state = finals.at(s);
+        int supplierFinalFund = state.fund;
         std::cout << "Final fund for supplier is : " << supplierFinalFund  << "\n";
         endFund += supplierFinalFund;
 
-        int supplierAmountPaidToEmployees = s->getAmountPaidToEmployees(EmployeeType::Supplier);
+        int supplierAmountPaidToEmployees = state.employeesPaid * getEmployeeSalary(EmployeeType::Supplier);
         std::cout << "Final amount paid for employees for supplier is : " << supplierAmountPaidToEmployees << "\n\n";
         endFund += supplierAmountPaidToEmployees;
     }
     for (Clinic* c : clinics) {
-        int clinicFinalFund = c->getFund();
+        const ActorState& state = finals.at(c);
+        int clinicFinalFund = state.fund;
         std::cout << "Final fund for clinic is : " << clinicFinalFund  << "\n";
         endFund += clinicFinalFund;
 
-        int clinicAmountPaidToEmployees = c->getAmountPaidToEmployees(EmployeeType::TreatmentSpecialist);
+        int clinicAmountPaidToEmployees = state.employeesPaid * getEmployeeSalary(EmployeeType::TreatmentSpecialist);
         std::cout << "Final amount paid for employees for clinic is : " << clinicAmountPaidToEmployees << "\n\n";
         endFund += clinicAmountPaidToEmployees;
+        treated += clinicAmountPaidToEmployees / getEmployeeSalary(EmployeeType::TreatmentSpecialist);
 
-        endPatient += c->getNumberPatients();
+        endPatient += state.patients;
     }
     for (Hospital* h : hospitals) {
-        int hospitalFinalFund = h->getFund();
+        const ActorState& state = finals.at(h);
+        int hospitalFinalFund = state.fund;
         std::cout << "Final fund for hospital is : " << hospitalFinalFund  << "\n";
         endFund += hospitalFinalFund;
 
-        int hospitalAmountPaidToEmployees = h->getAmountPaidToEmployees(EmployeeType::NursingStaff);
+        int hospitalAmountPaidToEmployees = state.employeesPaid * getEmployeeSalary(EmployeeType::NursingStaff);
         std::cout << "Final amount paid for employees for hospital is : " << hospitalAmountPaidToEmployees << "\n\n";
         endFund += hospitalAmountPaidToEmployees;
 
-        endPatient += h->getNumberPatients();
+        // Les patients sortis restent comptés par l'hôpital
+        endPatient += state.patients + state.freed;
     }
-    int insuranceFinalFund = insurance.getFund();
+    int insuranceFinalFund = finals.at(&insurance).fund;
     std::cout << "Final fund for insurance is : " << insuranceFinalFund  << "\n\n\n\n";
-    endFund += insuranceFinalFund - (INSURANCE_CONTRIBUTION * NB_DAYS);
+    endFund += insuranceFinalFund - (INSURANCE_CONTRIBUTION * clock.current_day());
 
     std::cout << "The expected fund is : " << startFund << " and you got at the end : " << endFund << "\n";
     std::cout << "The expected patient is : " << startPatient << " and you got at the end : " << endPatient << "\n";
+    int daysRun = std::max(1, clock.current_day() - clock.first_day());
+    std::cout << "Patients treated per day : " << static_cast<double>(treated) / daysRun << "\n";
+
+    if (patientTracker().isEnabled()) patientTracker().printReport(std::cout);
+    if (placement().isEnabled()) placement().printReport(std::cout);
+    if (warp) {
+        std::cout << "Time warp: " << warp->getDaysRun() << " of " << NB_DAYS << " days run, "
+                  << warp->getIdleActorDays() << " idle actor-days skipped\n";
+    }
 
     return 0;
 }
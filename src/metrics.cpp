@@ -0,0 +1,147 @@
+#include "metrics.h"
+
+#include <cstdint>
+
+namespace {
+
+constexpr char MAGIC[8] = "PCOMETR";
+constexpr int NB_HOLDERS = static_cast<int>(PatientHolder::Nothing);
+constexpr int NB_COLUMNS = sizeof(DayMetrics) / sizeof(int64_t);
+
+const char* const HEADER =
+    "day,patients_ambulance,patients_hospital,patients_clinic,patients_freed,"
+    "fund_ambulance,fund_supplier,fund_clinic,fund_hospital,fund_insurance,"
+    "rejected_patients,unpaid_backlog,supplier_stock";
+
+static_assert(sizeof(DayMetrics) == NB_COLUMNS * sizeof(int64_t), "DayMetrics must only hold int64 columns");
+
+template<typename T>
+int64_t sumFunds(const std::vector<T*>& sellers) {
+    int64_t sum = 0;
+    for (auto* s : sellers) sum += s->readState().fund;
+    return sum;
+}
+
+template<typename T>
+int64_t sumUnpaid(const std::vector<T*>& sellers) {
+    int64_t sum = 0;
+    for (auto* s : sellers) sum += s->readState().unpaid;
+    return sum;
+}
+
+} // namespace
+
+MetricsExporter::MetricsExporter(const std::string& path,
+                                 std::vector<Ambulance*> ambulances,
+                                 std::vector<Supplier*> suppliers,
+                                 std::vector<Clinic*> clinics,
+                                 std::vector<Hospital*> hospitals,
+                                 std::vector<Insurance*> insurances)
+    : ambulances(std::move(ambulances)), suppliers(std::move(suppliers)), clinics(std::move(clinics)),
+      hospitals(std::move(hospitals)), insurances(std::move(insurances)),
+      csv(path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0) {
+    out.open(path, csv ? std::ios::trunc : std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Metrics: cannot create " + path);
+
+    lastRejected = population().rejected();
+    if (!csv) columns.resize(NB_COLUMNS);
+    writeHeader();
+    writer = std::make_unique<PcoThread>(&MetricsExporter::writeLoop, this);
+}
+
+MetricsExporter::~MetricsExporter() {
+    mutex.lock();
+    stopping = true;
+    hasWork.notifyOne();
+    mutex.unlock();
+
+    writer->join();
+    if (!csv) writeColumns();
+    out.flush();
+}
+
+void MetricsExporter::sampleDay(int day) {
+    DayMetrics m{};
+    m.day = day;
+    for (int h = 0; h < NB_HOLDERS; ++h) {
+        m.patients[h] = population().count(static_cast<PatientHolder>(h));
+    }
+    m.fundAmbulances = sumFunds(ambulances);
+    m.fundSuppliers  = sumFunds(suppliers);
+    m.fundClinics    = sumFunds(clinics);
+    m.fundHospitals  = sumFunds(hospitals);
+    m.fundInsurances = sumFunds(insurances);
+
+    long long rejected = population().rejected();
+    m.rejectedPatients = rejected - lastRejected;
+    lastRejected = rejected;
+
+    m.unpaidBacklog = sumUnpaid(clinics) + sumUnpaid(insurances);
+    for (auto* s : suppliers) {
+        ActorState state = s->readState();
+        for (int qty : state.stock) m.supplierStock += qty;
+    }
+
+    mutex.lock();
+    pending.push_back(m);
+    hasWork.notifyOne();
+    mutex.unlock();
+}
+
+void MetricsExporter::writeLoop() {
+    std::vector<DayMetrics> batch;
+
+    while (true) {
+        mutex.lock();
+        while (pending.empty() && !stopping) {
+            hasWork.wait(&mutex);
+        }
+        batch.swap(pending);
+        bool done = stopping;
+        mutex.unlock();
+
+        for (const auto& m : batch) writeRow(m);
+        batch.clear();
+
+        if (done) {
+            // Un dernier passage pour les échantillons arrivés entre-temps
+            mutex.lock();
+            batch.swap(pending);
+            mutex.unlock();
+            for (const auto& m : batch) writeRow(m);
+            return;
+        }
+    }
+}
+
+void MetricsExporter::writeHeader() {
+    // L'en-tête binaire n'est écrit qu'à l'arrêt, une fois le nombre de jours connu
+    if (csv) out << HEADER << "\n";
+}
+
+void MetricsExporter::writeRow(const DayMetrics& m) {
+    const auto* values = reinterpret_cast<const int64_t*>(&m);
+    if (!csv) {
+        for (int c = 0; c < NB_COLUMNS; ++c) columns[c].push_back(values[c]);
+        return;
+    }
+    for (int c = 0; c < NB_COLUMNS; ++c) {
+        if (c) out << ',';
+        out << values[c];
+    }
+    out << '\n';
+}
+
+void MetricsExporter::writeColumns() {
+    uint32_t nbColumns = NB_COLUMNS;
+    uint32_t reserved = 0;
+    uint64_t nbRows = columns.front().size();
+    out.write(MAGIC, sizeof(MAGIC));
+    out.write(reinterpret_cast<const char*>(&nbColumns), sizeof(nbColumns));
+    out.write(reinterpret_cast<const char*>(&reserved), sizeof(reserved));
+    out.write(reinterpret_cast<const char*>(&nbRows), sizeof(nbRows));
+    for (const auto& column : columns) {
+        out.write(reinterpret_cast<const char*>(column.data()),
+                  static_cast<std::streamsize>(column.size() * sizeof(int64_t)));
+    }
+}
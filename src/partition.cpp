@@ -0,0 +1,225 @@
+#include "partition.h"
+
+#include <climits>
+#include <cstdio>
+#include <ctime>
+#include <linux/futex.h>
+#include <new>
+#include <signal.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <type_traits>
+#include <unistd.h>
+#include <pcosynchro/pcothread.h>
+
+namespace {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+              "futex needs a plain 32-bit atomic");
+static_assert(std::is_trivially_copyable_v<RemoteIntent> && std::is_trivially_copyable_v<ActorState>,
+              "only plain data crosses processes");
+
+/// Tours sans progrès entre deux vérifications des autres processus
+constexpr int IDLE_ROUNDS_PER_CHECK = 2000;
+
+// Pas de FUTEX_PRIVATE_FLAG : l'attente doit fonctionner entre processus
+void futexWait(std::atomic<uint32_t>* word, uint32_t expected) {
+    // Réveil périodique : un processus arrêté ne viendrait jamais
+    timespec timeout{0, 100 * 1000 * 1000};
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+void futexWakeAll(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+/// Place de count objets T à partir de offset, aligné pour T
+template<typename T>
+size_t reserveArray(size_t& offset, size_t count) {
+    size_t start = (offset + alignof(T) - 1) / alignof(T) * alignof(T);
+    offset = start + sizeof(T) * count;
+    return start;
+}
+
+} // namespace
+
+Partition::Partition(int nbPartitions, int nbActors)
+: nbPartitions(nbPartitions), nbActors(nbActors) {
+    if (nbPartitions < 1 || nbPartitions > nbActors) {
+        throw std::invalid_argument("Partition: between 1 and " + std::to_string(nbActors) + " processes");
+    }
+    auto nbChannels = static_cast<size_t>(nbPartitions) * static_cast<size_t>(nbPartitions);
+    size_t size = 0;
+    size_t arrivedAt    = reserveArray<std::atomic<uint32_t>>(size, 1);
+    size_t generationAt = reserveArray<std::atomic<uint32_t>>(size, 1);
+    size_t flagsAt      = reserveArray<std::atomic<int32_t>>(size, static_cast<size_t>(nbPartitions));
+    size_t channelsAt   = reserveArray<RemoteChannel>(size, nbChannels);
+    size_t statesAt     = reserveArray<ActorState>(size, 2 * static_cast<size_t>(nbActors));
+    size_t finalsAt     = reserveArray<ActorState>(size, static_cast<size_t>(nbActors));
+
+    void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) throw std::runtime_error("Partition: mmap failed");
+    mapping = mem;
+    mappedSize = size;
+
+    // Le segment anonyme est rempli de zéros : seuls les anneaux ont à être construits
+    auto* base = static_cast<char*>(mem);
+    arrived    = new (base + arrivedAt) std::atomic<uint32_t>(0);
+    generation = new (base + generationAt) std::atomic<uint32_t>(0);
+    flags      = reinterpret_cast<std::atomic<int32_t>*>(base + flagsAt);
+    for (int p = 0; p < nbPartitions; ++p) new (&flags[p]) std::atomic<int32_t>(0);
+    channels   = reinterpret_cast<RemoteChannel*>(base + channelsAt);
+    for (size_t c = 0; c < nbChannels; ++c) new (&channels[c]) RemoteChannel();
+    states     = reinterpret_cast<ActorState*>(base + statesAt);
+    finals     = reinterpret_cast<ActorState*>(base + finalsAt);
+}
+
+Partition::~Partition() {
+    for (size_t c = 0; c < static_cast<size_t>(nbPartitions) * static_cast<size_t>(nbPartitions); ++c) {
+        channels[c].~RemoteChannel();
+    }
+    munmap(mapping, mappedSize);
+}
+
+void Partition::forkProcesses() {
+    // Ce qui attend dans les tampons de sortie ne doit être écrit qu'une fois
+    fflush(nullptr);
+    pid_t parent = getpid();
+    for (int p = 1; p < nbPartitions; ++p) {
+        pid_t pid = fork();
+        if (pid < 0) throw std::runtime_error("Partition: fork failed");
+        if (pid == 0) {
+            self = p;
+            children.clear();
+            // Le fils ne survit pas au premier processus, seul à surveiller les autres
+            prctl(PR_SET_PDEATHSIG, SIGKILL);
+            if (getppid() != parent) _exit(1);
+            return;
+        }
+        children.push_back(pid);
+    }
+}
+
+void Partition::join() {
+    std::string failed;
+    for (size_t i = 0; i < children.size(); ++i) {
+        int status = 0;
+        if (waitpid(children[i], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failed += " " + std::to_string(i + 1);
+        }
+    }
+    children.clear();
+    if (!failed.empty()) throw std::runtime_error("Partition: process" + failed + " failed");
+}
+
+void Partition::checkPeers() {
+    for (size_t i = 0; i < children.size(); ++i) {
+        // WNOWAIT : le processus arrêté reste à récupérer par join()
+        siginfo_t info{};
+        if (waitid(P_PID, static_cast<id_t>(children[i]), &info, WEXITED | WNOHANG | WNOWAIT) == 0 &&
+            info.si_pid == children[i]) {
+            throw std::runtime_error("Partition: process " + std::to_string(i + 1) + " stopped");
+        }
+    }
+}
+
+void Partition::exchange(std::vector<std::vector<Intent>>& boxes) {
+    // Ce qui part vers chaque processus, dans l'ordre des émetteurs, puis la fin du lot
+    std::vector<std::vector<RemoteIntent>> outgoing(static_cast<size_t>(nbPartitions));
+    for (size_t sender = 0; sender < boxes.size(); ++sender) {
+        auto& box = boxes[sender];
+        auto kept = box.begin();
+        for (const auto& intent : box) {
+            if (isLocal(intent.to)) {
+                *kept++ = intent;
+            } else {
+                outgoing[intent.to % nbPartitions].push_back({static_cast<int32_t>(sender), intent});
+            }
+        }
+        box.erase(kept, box.end());
+    }
+    for (auto& batch : outgoing) batch.push_back({-1, {}});
+
+    std::vector<size_t> sent(static_cast<size_t>(nbPartitions), 0);
+    std::vector<bool> received(static_cast<size_t>(nbPartitions), false);
+    sent[self] = outgoing[self].size();
+    received[self] = true;
+    int pending = 2 * (nbPartitions - 1);
+    int idle = 0;
+    while (pending > 0) {
+        bool progress = false;
+        for (int p = 0; p < nbPartitions; ++p) {
+            auto& batch = outgoing[p];
+            while (sent[p] < batch.size() && channel(self, p).tryPush(batch[sent[p]])) {
+                progress = true;
+                if (++sent[p] == batch.size()) --pending;
+            }
+            // Au-delà de la fin du lot, l'anneau contient déjà le lot suivant
+            RemoteIntent message;
+            while (!received[p] && channel(p, self).tryPop(message)) {
+                progress = true;
+                if (message.sender < 0) {
+                    received[p] = true;
+                    --pending;
+                } else {
+                    boxes[static_cast<size_t>(message.sender)].push_back(message.intent);
+                }
+            }
+        }
+        if (progress) {
+            idle = 0;
+        } else {
+            if (++idle % IDLE_ROUNDS_PER_CHECK == 0) checkPeers();
+            PcoThread::usleep(20);
+        }
+    }
+}
+
+void Partition::meet() {
+    uint32_t gen = generation->load(std::memory_order_acquire);
+    if (arrived->fetch_add(1, std::memory_order_acq_rel) + 1 == static_cast<uint32_t>(nbPartitions)) {
+        arrived->store(0, std::memory_order_relaxed);
+        generation->fetch_add(1, std::memory_order_release);
+        futexWakeAll(generation);
+        return;
+    }
+    while (generation->load(std::memory_order_acquire) == gen) {
+        futexWait(generation, gen);
+        if (generation->load(std::memory_order_acquire) == gen) checkPeers();
+    }
+}
+
+bool Partition::any(bool local) {
+    flags[self].store(local ? 1 : 0, std::memory_order_relaxed);
+    meet();
+    bool result = false;
+    for (int p = 0; p < nbPartitions; ++p) result = result || flags[p].load(std::memory_order_relaxed) != 0;
+    // Personne ne réécrit son drapeau avant que tous l'aient lu
+    meet();
+    return result;
+}
+
+ActorState* Partition::stateBuffer(int which) {
+    return states + static_cast<size_t>(which) * static_cast<size_t>(nbActors);
+}
+
+void Partition::setFinalState(int actor, const ActorState& state) {
+    finals[actor] = state;
+}
+
+const ActorState& Partition::getFinalState(int actor) const {
+    return finals[actor];
+}
+
+SharedDayClock::SharedDayClock(int participants, Partition* partition)
+: DayClock(participants), partition(partition) {}
+
+void SharedDayClock::wait_all_done() {
+    DayClock::wait_all_done();
+    // Journée finie dans ce processus : on attend qu'elle le soit dans tous
+    partition->meet();
+}
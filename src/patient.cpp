@@ -0,0 +1,192 @@
+#include "patient.h"
+
+#include <iomanip>
+#include <stdexcept>
+
+namespace {
+
+/// Patients handed over by the current thread and not yet received.
+thread_local std::vector<PatientHandle> outbox;
+thread_local size_t outboxNext = 0;
+
+const char* const STAGE_NAMES[NB_PATIENT_STAGES] = {
+    "Pickup -> freed", "Ambulance -> hospital", "Hospital -> clinic",
+    "Clinic -> treated", "Treated -> rehab", "Rehab -> freed"
+};
+
+} // namespace
+
+// PatientPool
+
+PatientPool::~PatientPool() {
+    for (auto& slab : slabs) delete[] slab.load();
+}
+
+PatientHandle PatientPool::allocate() {
+    uint64_t head = freeHead.load(std::memory_order_acquire);
+    while (indexOf(head) != NO_PATIENT) {
+        auto index = static_cast<PatientHandle>(indexOf(head));
+        uint64_t next = (*this)[index].nextFree.load(std::memory_order_relaxed);
+        uint64_t newHead = ((tagOf(head) + 1) << 32) | next;
+        if (freeHead.compare_exchange_weak(head, newHead, std::memory_order_acq_rel)) {
+            return index;
+        }
+    }
+
+    uint32_t index = nextUnused.fetch_add(1, std::memory_order_relaxed);
+    uint32_t slab = index / SLAB_SIZE;
+    if (slab >= MAX_SLABS) throw std::runtime_error("PatientPool: exhausted");
+
+    if (!slabs[slab].load(std::memory_order_acquire)) {
+        auto* fresh = new PatientRecord[SLAB_SIZE];
+        PatientRecord* expected = nullptr;
+        if (!slabs[slab].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel)) {
+            delete[] fresh;  // un autre thread a installé la slab
+        }
+    }
+    return index;
+}
+
+void PatientPool::release(PatientHandle handle) {
+    uint64_t head = freeHead.load(std::memory_order_relaxed);
+    uint64_t newHead;
+    do {
+        (*this)[handle].nextFree.store(static_cast<PatientHandle>(indexOf(head)), std::memory_order_relaxed);
+        newHead = ((tagOf(head) + 1) << 32) | handle;
+    } while (!freeHead.compare_exchange_weak(head, newHead, std::memory_order_acq_rel));
+}
+
+// PatientTracker::Histogram
+
+void PatientTracker::Histogram::add(int days) {
+    int bucket = days < 0 ? 0 : (days >= NB_BUCKETS ? NB_BUCKETS - 1 : days);
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t PatientTracker::Histogram::count() const {
+    uint64_t sum = 0;
+    for (const auto& b : buckets) sum += b.load(std::memory_order_relaxed);
+    return sum;
+}
+
+int PatientTracker::Histogram::percentile(double p) const {
+    uint64_t total = count();
+    if (total == 0) return 0;
+    auto target = static_cast<uint64_t>(p * static_cast<double>(total - 1));
+    uint64_t seen = 0;
+    for (int d = 0; d < NB_BUCKETS; ++d) {
+        seen += buckets[d].load(std::memory_order_relaxed);
+        if (seen > target) return d;
+    }
+    return NB_BUCKETS - 1;
+}
+
+double PatientTracker::Histogram::mean() const {
+    uint64_t total = count();
+    if (total == 0) return 0.0;
+    double sum = 0.0;
+    for (int d = 0; d < NB_BUCKETS; ++d) sum += static_cast<double>(d) * buckets[d].load(std::memory_order_relaxed);
+    return sum / static_cast<double>(total);
+}
+
+// PatientTracker
+
+void PatientTracker::mark(PatientHandle h, PatientStage stage, int owner) {
+    PatientRecord& rec = pool[h];
+    rec.owner = owner;
+    rec.stageDay[static_cast<int>(stage)] = day.load(std::memory_order_relaxed);
+}
+
+void PatientTracker::admit(std::deque<PatientHandle>& to, int qty, PatientStage stage, int owner) {
+    if (!isEnabled()) return;
+    for (int i = 0; i < qty; ++i) {
+        PatientHandle h = pool.allocate();
+        PatientRecord& rec = pool[h];
+        rec.id = nextId.fetch_add(1, std::memory_order_relaxed);
+        for (auto& d : rec.stageDay) d = -1;
+        mark(h, stage, owner);
+        to.push_back(h);
+    }
+}
+
+void PatientTracker::advance(std::deque<PatientHandle>& from, std::deque<PatientHandle>& to, PatientStage stage) {
+    if (!isEnabled() || from.empty()) return;
+    PatientHandle h = from.front();
+    from.pop_front();
+    mark(h, stage, pool[h].owner);
+    to.push_back(h);
+}
+
+void PatientTracker::send(std::deque<PatientHandle>& from, int qty) {
+    if (!isEnabled()) return;
+    outbox.clear();
+    outboxNext = 0;
+    for (int i = 0; i < qty && !from.empty(); ++i) {
+        outbox.push_back(from.front());
+        from.pop_front();
+    }
+}
+
+void PatientTracker::receive(std::deque<PatientHandle>& to, int qty, PatientStage stage, int owner) {
+    if (!isEnabled()) return;
+    for (int i = 0; i < qty && outboxNext < outbox.size(); ++i) {
+        PatientHandle h = outbox[outboxNext++];
+        mark(h, stage, owner);
+        to.push_back(h);
+    }
+}
+
+PatientHandle PatientTracker::receiveOne(PatientStage stage, int owner) {
+    if (!isEnabled() || outboxNext >= outbox.size()) return NO_PATIENT;
+    PatientHandle h = outbox[outboxNext++];
+    mark(h, stage, owner);
+    return h;
+}
+
+void PatientTracker::takeBack(std::deque<PatientHandle>& from) {
+    if (!isEnabled()) return;
+    while (outbox.size() > outboxNext) {
+        from.push_front(outbox.back());
+        outbox.pop_back();
+    }
+    outbox.clear();
+    outboxNext = 0;
+}
+
+void PatientTracker::discharge(const std::vector<PatientHandle>& handles) {
+    if (!isEnabled()) return;
+    for (PatientHandle h : handles) {
+        mark(h, PatientStage::Freed, -1);
+        const PatientRecord& rec = pool[h];
+        for (int s = 1; s < NB_PATIENT_STAGES; ++s) {
+            if (rec.stageDay[s] >= 0 && rec.stageDay[s - 1] >= 0) {
+                stageLatency[s].add(rec.stageDay[s] - rec.stageDay[s - 1]);
+            }
+        }
+        stageLatency[0].add(rec.stageDay[static_cast<int>(PatientStage::Freed)]
+                            - rec.stageDay[static_cast<int>(PatientStage::Ambulance)]);
+        pool.release(h);
+    }
+}
+
+long long PatientTracker::dischargedCount() const {
+    return static_cast<long long>(stageLatency[0].count());
+}
+
+void PatientTracker::printReport(std::ostream& out) const {
+    out << "Patient latencies (days) :\n";
+    for (int s = 0; s < NB_PATIENT_STAGES; ++s) {
+        const Histogram& h = stageLatency[s];
+        out << "  " << std::left << std::setw(24) << STAGE_NAMES[s]
+            << " count " << h.count()
+            << ", mean " << std::fixed << std::setprecision(2) << h.mean()
+            << ", p50 " << h.percentile(0.50)
+            << ", p90 " << h.percentile(0.90)
+            << ", p99 " << h.percentile(0.99) << "\n";
+    }
+}
+
+PatientTracker& patientTracker() {
+    static PatientTracker tracker;
+    return tracker;
+}
@@ -0,0 +1,203 @@
+#include "payment_scheduler.h"
+#include "seller.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+PaymentPolicy parsePaymentPolicy(const std::string& description) {
+    std::vector<std::string> parts;
+    std::stringstream ss(description);
+    for (std::string part; std::getline(ss, part, ':');) parts.push_back(part);
+
+    PaymentPolicy policy;
+    if (parts.size() == 1 && parts[0] == "fifo") return policy;
+    if (!parts.empty() && parts.size() <= 3 && parts[0] == "priority") {
+        policy.prioritizeWaiting = true;
+        try {
+            if (parts.size() > 1) policy.creditLimit = std::stoi(parts[1]);
+        } catch (const std::exception&) {
+            throw std::invalid_argument("Bad payment policy: " + description);
+        }
+        if (policy.creditLimit < 0 || (parts.size() == 3 && parts[2] != "partial")) {
+            throw std::invalid_argument("Bad payment policy: " + description);
+        }
+        policy.partialPayments = parts.size() == 3;
+        return policy;
+    }
+    throw std::invalid_argument("Bad payment policy: " + description);
+}
+
+PaymentScheduler::PaymentScheduler(PaymentPolicy policy) : policy(policy) {}
+
+void PaymentScheduler::setPolicy(const PaymentPolicy& p) {
+    policy = p;
+    rebuild();
+}
+
+void PaymentScheduler::setCreditLimit(const Seller* who, int limit) {
+    creditLimits[who] = std::max(0, limit);
+}
+
+int PaymentScheduler::getCreditLimit(const Seller* who) const {
+    auto it = creditLimits.find(who);
+    return it == creditLimits.end() ? policy.creditLimit : it->second;
+}
+
+std::vector<std::pair<const Seller*, int>> PaymentScheduler::getCreditLimits() const {
+    std::vector<std::pair<const Seller*, int>> limits(creditLimits.begin(), creditLimits.end());
+    std::sort(limits.begin(), limits.end(),
+              [](const auto& a, const auto& b) { return a.first->getUniqueId() < b.first->getUniqueId(); });
+    return limits;
+}
+
+std::vector<Payment> PaymentScheduler::getOverdrafts() const {
+    return {overdrafts.begin(), overdrafts.end()};
+}
+
+void PaymentScheduler::addOverdraft(Seller* who, int amount) {
+    if (amount <= 0) return;
+    if (!overdrafts.empty() && overdrafts.back().who == who) {
+        overdrafts.back().amount += amount;
+    } else {
+        overdrafts.push_back({who, amount});
+    }
+    overdrawn += amount;
+}
+
+int PaymentScheduler::getCreditLeft(const Seller* who, int money) const {
+    // Ce que les fonds ne doivent plus rembourse les tirages les plus anciens
+    int repaid = std::max(0, overdrawn - std::max(0, -money));
+    int drawn = 0;
+    for (const auto& draw : overdrafts) {
+        int covered = std::min(repaid, draw.amount);
+        repaid -= covered;
+        if (draw.who == who) drawn += draw.amount - covered;
+    }
+    return std::max(0, getCreditLimit(who) - drawn);
+}
+
+void PaymentScheduler::settleOverdrafts(int money) {
+    int repaid = std::max(0, overdrawn - std::max(0, -money));
+    while (repaid > 0) {
+        Payment& oldest = overdrafts.front();
+        int covered = std::min(repaid, oldest.amount);
+        oldest.amount -= covered;
+        overdrawn -= covered;
+        repaid -= covered;
+        if (oldest.amount == 0) overdrafts.pop_front();
+    }
+}
+
+PaymentScheduler::Key PaymentScheduler::keyOf(Seller* who, const Account& account) const {
+    const Bill& head = account.bills.front();
+    if (policy.prioritizeWaiting && account.waiting) return {0, head.amount, head.seq, who};
+    return {1, 0, head.seq, who};
+}
+
+void PaymentScheduler::rebuild() {
+    queue.clear();
+    for (auto& [who, account] : accounts) {
+        if (!policy.prioritizeWaiting) account.waiting = false;
+        queue.insert(keyOf(who, account));
+    }
+}
+
+void PaymentScheduler::add(Seller* who, int amount) {
+    Account& account = accounts[who];
+    account.bills.push_back({nextSeq++, amount});
+    unpaid += amount;
+    // La tête de file ne change que pour un fournisseur qui n'avait rien en attente
+    if (account.bills.size() == 1) queue.insert(keyOf(who, account));
+}
+
+void PaymentScheduler::refreshPriorities() {
+    if (!policy.prioritizeWaiting) return;
+    for (auto& [who, account] : accounts) {
+        bool waiting = who->isWaitingForPayment();
+        if (waiting == account.waiting) continue;
+        queue.erase(keyOf(who, account));
+        account.waiting = waiting;
+        queue.insert(keyOf(who, account));
+    }
+}
+
+std::optional<Payment> PaymentScheduler::next(int money) {
+    if (queue.empty()) return std::nullopt;
+
+    settleOverdrafts(money);
+    Seller* who = std::get<3>(*queue.begin());
+    Account& account = accounts.at(who);
+    Bill& head = account.bills.front();
+    int payable = std::max(0, money) + getCreditLeft(who, money);
+
+    int amount;
+    if (head.amount <= payable) {
+        amount = head.amount;
+    } else if (policy.partialPayments && payable > 0) {
+        amount = payable;
+    } else {
+        return std::nullopt;
+    }
+
+    // La part payée au-delà des fonds est tirée sur le crédit de ce fournisseur
+    addOverdraft(who, amount - std::max(0, money));
+    queue.erase(queue.begin());
+    head.amount -= amount;
+    unpaid -= amount;
+    if (head.amount == 0) account.bills.pop_front();
+    if (account.bills.empty()) {
+        accounts.erase(who);
+    } else {
+        queue.insert(keyOf(who, account));
+    }
+    return Payment{who, amount};
+}
+
+int PaymentScheduler::daysUntilPayable(int money, int incomePerDay) const {
+    if (accounts.empty()) return -1;
+
+    // Le plus tôt sur toutes les têtes de file : l'ordre peut changer d'ici là
+    int days = -1;
+    for (const auto& [who, account] : accounts) {
+        int needed = policy.partialPayments ? 1 : account.bills.front().amount;
+        auto payableAfter = [&](int d) {
+            int funds = money + d * incomePerDay;
+            return needed <= std::max(0, funds) + getCreditLeft(who, funds);
+        };
+        if (payableAfter(0)) return 0;
+        if (incomePerDay <= 0) continue;
+
+        // Borne haute sans tenir compte des tirages remboursés d'ici là, puis dichotomie
+        int low = 0;
+        int high = (needed - std::max(0, money) + incomePerDay - 1) / incomePerDay + 1;
+        if (money < 0) high += (-money + incomePerDay - 1) / incomePerDay;
+        while (high - low > 1) {
+            int mid = low + (high - low) / 2;
+            (payableAfter(mid) ? high : low) = mid;
+        }
+        if (days < 0 || high < days) days = high;
+    }
+    return days;
+}
+
+std::vector<Payment> PaymentScheduler::pending() const {
+    std::vector<std::pair<long long, Payment>> bills;
+    for (const auto& [who, account] : accounts) {
+        for (const auto& bill : account.bills) bills.push_back({bill.seq, {who, bill.amount}});
+    }
+    std::sort(bills.begin(), bills.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<Payment> out;
+    out.reserve(bills.size());
+    for (const auto& [seq, payment] : bills) out.push_back(payment);
+    return out;
+}
+
+void PaymentScheduler::clear() {
+    accounts.clear();
+    queue.clear();
+    unpaid = 0;
+    overdrafts.clear();
+    overdrawn = 0;
+}
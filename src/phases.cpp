@@ -0,0 +1,167 @@
+#include "phases.h"
+
+#include "partition.h"
+
+namespace {
+
+/// Outbox of the worker running on this thread, nullptr outside the workers
+thread_local std::vector<Intent>* currentOutbox = nullptr;
+thread_local const PhasedDay* currentDay = nullptr;
+
+} // namespace
+
+DeferredSeller::DeferredSeller(Seller* target, int index, PhasedDay* day)
+: Seller(0, target->getUniqueId()), target(target), index(index), day(day) {}
+
+void DeferredSeller::invoice(int bill, Seller* who) {
+    day->post({Intent::Op::Invoice, ItemType::Nothing, day->indexOf(who), index, 0, bill});
+}
+
+void DeferredSeller::pay(int bill) {
+    day->post({Intent::Op::Pay, ItemType::Nothing, -1, index, 0, bill});
+}
+
+bool DeferredSeller::isWaitingForPayment() const {
+    return day->previous(target).waiting != 0;
+}
+
+int DeferredSeller::getFreeCapacity() const {
+    return day->previous(target).freeCapacity;
+}
+
+PhasedDay::PhasedDay(const std::vector<Seller*>& actors)
+: actors(actors), outboxes(actors.size() + 1), inboxes(actors.size()),
+  replyOutboxes(actors.size()), replyInboxes(actors.size()) {
+    proxies.reserve(actors.size());
+    for (size_t i = 0; i < actors.size(); ++i) {
+        indices[actors[i]] = static_cast<int>(i);
+        proxies.push_back(std::make_unique<DeferredSeller>(actors[i], static_cast<int>(i), this));
+    }
+    // Les bénéficiaires peuvent aussi être désignés par leur mandataire
+    for (size_t i = 0; i < actors.size(); ++i) {
+        indices[proxies[i].get()] = static_cast<int>(i);
+    }
+    ownStates.assign(2 * actors.size(), ActorState{});
+    states = {ownStates.data(), ownStates.data() + actors.size()};
+}
+
+void PhasedDay::setPartition(Partition* p) {
+    if (p->getActorCount() != static_cast<int>(actors.size())) {
+        throw std::invalid_argument("PhasedDay: partition made for another number of actors");
+    }
+    partition = p;
+    states = {p->stateBuffer(0), p->stateBuffer(1)};
+}
+
+bool PhasedDay::isLocal(int index) const {
+    return !partition || partition->isLocal(index);
+}
+
+Seller* PhasedDay::deferred(Seller* target) {
+    return proxies[indices.at(target)].get();
+}
+
+void PhasedDay::bindOutbox(Seller* self) {
+    currentOutbox = &outboxes[indices.at(self)];
+    currentDay = this;
+}
+
+void PhasedDay::post(const Intent& intent) {
+    if (currentDay == this) {
+        currentOutbox->push_back(intent);
+        return;
+    }
+    sharedOutboxMutex.lock();
+    outboxes.back().push_back(intent);
+    sharedOutboxMutex.unlock();
+}
+
+void PhasedDay::request(Intent::Op op, const Seller* from, const Seller* to, ItemType what, int qty) {
+    post({op, what, indexOf(from), indexOf(to), qty, 0});
+}
+
+void PhasedDay::publish(const Seller* actor, const ActorState& state) {
+    states[front ^ 1][indexOf(actor)] = state;
+}
+
+void PhasedDay::route(Boxes& from, Boxes& to) {
+    // Ce qui vise un autre processus part par les anneaux ; ce qu'il nous
+    // envoie arrive dans la boîte de son émetteur, à sa place dans le tri
+    if (partition) partition->exchange(from);
+
+    // Tri par comptage sur la cible : chaque boîte de réception garde l'ordre des émetteurs
+    std::vector<size_t> counts(to.size(), 0);
+    for (const auto& box : from) {
+        for (const auto& intent : box) ++counts[intent.to];
+    }
+    for (size_t i = 0; i < to.size(); ++i) to[i].reserve(to[i].size() + counts[i]);
+
+    for (auto& box : from) {
+        for (const auto& intent : box) to[intent.to].push_back(intent);
+        nbIntents += static_cast<long long>(box.size());
+        box.clear();
+    }
+}
+
+void PhasedDay::swapBuffers() {
+    route(outboxes, inboxes);
+    front ^= 1;
+}
+
+int PhasedDay::applyInbox(Seller* self) {
+    int index = indices.at(self);
+    auto& inbox = inboxes[index];
+    auto& replies = replyOutboxes[index];
+    for (const auto& intent : inbox) {
+        int granted = self->applyIntent(intent);
+        if (intent.op == Intent::Op::Transfer) {
+            replies.push_back({Intent::Op::Accepted, intent.item, index, intent.from, intent.qty, granted});
+        } else if (intent.op == Intent::Op::Buy) {
+            replies.push_back({Intent::Op::Sold, intent.item, index, intent.from, intent.qty, granted});
+        }
+    }
+    int applied = static_cast<int>(inbox.size());
+    inbox.clear();
+    return applied;
+}
+
+void PhasedDay::routeReplies() {
+    route(replyOutboxes, replyInboxes);
+}
+
+int PhasedDay::settleReplies(Seller* self) {
+    auto& replies = replyInboxes[indices.at(self)];
+    if (replies.empty()) return 0;
+    self->settleReplies(replies);
+    int settled = static_cast<int>(replies.size());
+    replies.clear();
+    return settled;
+}
+
+void PhasedDay::applyAll() {
+    auto pending = [this] {
+        for (const auto& box : outboxes) {
+            if (!box.empty()) return true;
+        }
+        return false;
+    };
+    // Les boîtes de réception du dernier échange d'abord ; régler une réponse
+    // peut encore émettre une facture : on recommence tant qu'il en reste
+    bool again = false;
+    do {
+        swapBuffers();
+        for (size_t i = 0; i < actors.size(); ++i) {
+            if (isLocal(static_cast<int>(i))) applyInbox(actors[i]);
+        }
+        routeReplies();
+        for (size_t i = 0; i < actors.size(); ++i) {
+            if (!isLocal(static_cast<int>(i))) continue;
+            // Les factures partent de la boîte de l'acteur, comme depuis son thread
+            bindOutbox(actors[i]);
+            settleReplies(actors[i]);
+        }
+        again = partition ? partition->any(pending()) : pending();
+    } while (again);
+    currentOutbox = nullptr;
+    currentDay = nullptr;
+}
@@ -0,0 +1,131 @@
+#include "placement.h"
+
+#include <algorithm>
+#include <dirent.h>
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace {
+
+/// Node of the actor running on this thread, -1 outside actor threads.
+thread_local int currentNode = -1;
+
+} // namespace
+
+std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    for (std::string range; std::getline(ss, range, ',');) {
+        range.erase(std::remove_if(range.begin(), range.end(), ::isspace), range.end());
+        if (range.empty()) continue;
+        try {
+            size_t dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            if (first < 0 || last < first) throw std::invalid_argument(range);
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        } catch (const std::exception&) {
+            throw std::invalid_argument("Bad CPU list: " + list);
+        }
+    }
+    return cpus;
+}
+
+std::vector<NumaNode> readNumaNodes(const std::string& root) {
+    std::vector<NumaNode> nodes;
+
+    if (DIR* dir = opendir(root.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.rfind("node", 0) != 0 || name.size() == 4
+                || !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+                continue;
+            }
+            std::ifstream in(root + "/" + name + "/cpulist");
+            std::string list;
+            if (!std::getline(in, list)) continue;
+            auto cpus = parseCpuList(list);
+            // Les nœuds sans CPU (mémoire seule) ne peuvent pas accueillir de threads
+            if (!cpus.empty()) nodes.push_back({std::stoi(name.substr(4)), std::move(cpus)});
+        }
+        closedir(dir);
+    }
+
+    if (nodes.empty()) {
+        NumaNode all{0, {}};
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        for (int cpu = 0; cpu < std::max(1L, n); ++cpu) all.cpus.push_back(cpu);
+        nodes.push_back(std::move(all));
+    }
+
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+    return nodes;
+}
+
+void Placement::setNodes(std::vector<NumaNode> n) {
+    nodes = std::move(n);
+    load.assign(nodes.size(), 0);
+    nodeBySeller.clear();
+}
+
+int Placement::placeGroup(const std::vector<Seller*>& group) {
+    if (nodes.empty()) setNodes(readNumaNodes());
+    int node = static_cast<int>(std::min_element(load.begin(), load.end()) - load.begin());
+    for (auto* s : group) place(s, node);
+    return node;
+}
+
+void Placement::place(const Seller* seller, int node) {
+    if (node < 0 || node >= static_cast<int>(nodes.size())) throw std::out_of_range("Placement: no such node");
+    auto [it, inserted] = nodeBySeller.emplace(seller, node);
+    if (!inserted) {
+        --load[it->second];
+        it->second = node;
+    }
+    ++load[node];
+}
+
+int Placement::nodeOf(const Seller* seller) const {
+    auto found = nodeBySeller.find(seller);
+    return found == nodeBySeller.end() ? -1 : found->second;
+}
+
+bool Placement::pinCurrentThread(const Seller* seller) {
+    int node = nodeOf(seller);
+    if (node < 0) return false;
+    currentNode = node;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : nodes[node].cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+void Placement::noteCall(const Seller* callee) {
+    if (!isEnabled() || currentNode < 0) return;
+    int node = nodeOf(callee);
+    if (node < 0) return;
+    (node == currentNode ? sameNode : crossNode).fetch_add(1, std::memory_order_relaxed);
+}
+
+void Placement::printReport(std::ostream& out) const {
+    out << "Placement on " << nodes.size() << " NUMA node(s) :\n";
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        out << "  node " << nodes[n].id << " : " << nodes[n].cpus.size() << " cpu(s), "
+            << load[n] << " actor(s)\n";
+    }
+    long long same = sameNodeCalls();
+    long long cross = crossNodeCalls();
+    out << "  calls : " << same + cross << " total, " << cross << " cross-node\n";
+}
+
+Placement& placement() {
+    static Placement instance;
+    return instance;
+}
@@ -0,0 +1,78 @@
+#include "population.h"
+#include "seller.h"
+
+PopulationCounter::Shard& PopulationCounter::localShard() {
+    static std::atomic<int> nextShard{0};
+    thread_local int shard = nextShard.fetch_add(1, std::memory_order_relaxed) % NB_SHARDS;
+    return shards[shard];
+}
+
+void PopulationCounter::add(PatientHolder holder, int delta) {
+    if (holder == PatientHolder::Nothing || delta == 0) return;
+    localShard().counts[static_cast<int>(holder)].fetch_add(delta, std::memory_order_relaxed);
+}
+
+void PopulationCounter::move(PatientHolder from, PatientHolder to, int qty) {
+    Shard& shard = localShard();
+    shard.counts[static_cast<int>(from)].fetch_sub(qty, std::memory_order_relaxed);
+    shard.counts[static_cast<int>(to)].fetch_add(qty, std::memory_order_relaxed);
+}
+
+void PopulationCounter::reject(int qty) {
+    if (qty <= 0) return;
+    localShard().rejected.fetch_add(qty, std::memory_order_relaxed);
+}
+
+long long PopulationCounter::rejected() const {
+    long long sum = 0;
+    for (const auto& shard : shards) {
+        sum += shard.rejected.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+long long PopulationCounter::count(PatientHolder holder) const {
+    if (holder == PatientHolder::Nothing) return 0;
+    long long sum = 0;
+    for (const auto& shard : shards) {
+        sum += shard.counts[static_cast<int>(holder)].load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+long long PopulationCounter::total() const {
+    long long sum = 0;
+    for (int h = 0; h < NB_HOLDERS; ++h) {
+        sum += count(static_cast<PatientHolder>(h));
+    }
+    return sum;
+}
+
+std::vector<PopulationMismatch> PopulationCounter::crossCheck(const std::vector<Seller*>& actors) const {
+    long long published[NB_HOLDERS]{};
+    for (const Seller* actor : actors) {
+        ActorState state = actor->readState();
+        PatientHolder holder = actor->patientHolder();
+        if (holder != PatientHolder::Nothing) published[static_cast<int>(holder)] += state.patients;
+        published[static_cast<int>(PatientHolder::Freed)] += state.freed;
+    }
+
+    std::vector<PopulationMismatch> mismatches;
+    for (int h = 0; h < NB_HOLDERS; ++h) {
+        long long counted = count(static_cast<PatientHolder>(h));
+        if (counted != published[h]) mismatches.push_back({static_cast<PatientHolder>(h), counted, published[h]});
+    }
+    return mismatches;
+}
+
+void PopulationCounter::reset() {
+    for (auto& shard : shards) {
+        for (auto& c : shard.counts) c.store(0, std::memory_order_relaxed);
+        shard.rejected.store(0, std::memory_order_relaxed);
+    }
+}
+
+PopulationCounter& population() {
+    static PopulationCounter counter;
+    return counter;
+}
@@ -0,0 +1,121 @@
+// replay.cpp : rejoue un journal d'audit pour reconstruire soldes et patients
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "journal.h"
+
+/**
+ * @brief State of one actor rebuilt from the journal.
+ */
+struct ActorBalance {
+    long long funds = 0;        ///< Current funds.
+    long long patients = 0;     ///< Patients currently held.
+    long long salaries = 0;     ///< Total paid to employees.
+    long long pendingBills = 0; ///< Invoiced or bought but not yet paid.
+    bool seen = false;          ///< Named by at least one event.
+};
+
+/**
+ * @brief Balances indexed by unique id: ids are dense, from 0 to the number of actors.
+ */
+class Balances {
+public:
+    ActorBalance& operator[](int32_t id) {
+        if (id < 0) throw std::runtime_error("Journal: event without its actor");
+        // Agrandi seulement à la première apparition d'un id plus grand
+        if (static_cast<size_t>(id) >= actors.size()) actors.resize(static_cast<size_t>(id) + 1);
+        ActorBalance& actor = actors[static_cast<size_t>(id)];
+        actor.seen = true;
+        return actor;
+    }
+
+    [[nodiscard]] const std::vector<ActorBalance>& all() const { return actors; }
+
+private:
+    std::vector<ActorBalance> actors;
+};
+
+int main(int argc, char** argv) {
+    if (argc != 2 && argc != 3) {
+        printf("Usage: %s JOURNAL_DIR [DAY]\n", argv[0]);
+        return 1;
+    }
+
+    const std::string directory = argv[1];
+    const int lastDay = argc == 3 ? atoi(argv[2]) : std::numeric_limits<int>::max();
+
+    Balances actors;
+    long long nbEvents = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    try {
+        Journal::replay(directory, [&](const JournalEvent& e) {
+            if (e.day > lastDay) return;
+            ++nbEvents;
+
+            switch (e.type) {
+                case EventType::Initial:
+                    actors[e.to].funds = e.amount;
+                    actors[e.to].patients = e.qty;
+                    break;
+                case EventType::Transfer:
+                    actors[e.from].patients -= e.qty;
+                    actors[e.to].patients += e.qty;
+                    break;
+                case EventType::Buy:
+                    actors[e.to].pendingBills += e.amount;
+                    break;
+                case EventType::Invoice:
+                    actors[e.to].pendingBills += e.amount;
+                    break;
+                case EventType::Pay:
+                    actors[e.from].funds -= e.amount;
+                    actors[e.from].pendingBills -= e.amount;
+                    actors[e.to].funds += e.amount;
+                    break;
+                case EventType::Salary:
+                    actors[e.from].funds -= e.amount;
+                    actors[e.from].salaries += e.amount;
+                    break;
+                case EventType::Contribution:
+                    actors[e.to].funds += e.amount;
+                    break;
+            }
+        });
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+
+    long long totalFunds = 0;
+    long long totalPatients = 0;
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Replayed " << nbEvents << " events";
+    if (argc == 3) std::cout << " up to day " << lastDay;
+    if (seconds > 0) {
+        std::cout << " (" << static_cast<double>(nbEvents * sizeof(JournalEvent)) / seconds / 1e6 << " MB/s)";
+    }
+    std::cout << "\n\n";
+
+    for (size_t id = 0; id < actors.all().size(); ++id) {
+        const ActorBalance& a = actors.all()[id];
+        if (!a.seen) continue;
+        std::cout << "Actor " << id << " : fund " << a.funds << ", salaries " << a.salaries
+                  << ", unpaid " << a.pendingBills << ", patients " << a.patients << "\n";
+        totalFunds += a.funds + a.salaries;
+        totalPatients += a.patients;
+    }
+
+    std::cout << "\nTotal fund (including salaries) : " << totalFunds << "\n";
+    std::cout << "Total patients : " << totalPatients << "\n";
+
+    return 0;
+}
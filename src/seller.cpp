@@ -1,22 +1,52 @@
 #include "seller.h"
+#include "phases.h"
+#include <atomic>
 #include <random>
 #include <cassert>
 
+uint32_t Seller::randomSeed = 1;
+
+void Seller::setRandomSeed(uint32_t seed) {
+    randomSeed = seed;
+}
+
+std::mt19937 Seller::seededEngine(int uniqueId) {
+    std::seed_seq seq{randomSeed, static_cast<uint32_t>(uniqueId)};
+    return std::mt19937(seq);
+}
+
 Seller *Seller::chooseRandomSeller(std::vector<Seller *> &sellers) {
     assert(sellers.size());
     std::vector<Seller*> out;
-    std::sample(sellers.begin(), sellers.end(), std::back_inserter(out),
-            1, std::mt19937{std::random_device{}()});
+    std::sample(sellers.begin(), sellers.end(), std::back_inserter(out), 1, rng);
     return out.front();
 }
 
+thread_local Seller::ReservationIds Seller::reservationIds;
+
+uint64_t Seller::ReservationIds::refill() {
+    static std::atomic<uint64_t> nextBlock{1};
+    next = nextBlock.fetch_add(BLOCK, std::memory_order_relaxed);
+    end = next + BLOCK;
+    return next++;
+}
+
+void Seller::rejectRedeem(const Reservation& token) const {
+    if (!token.isOpen()) throw std::logic_error("Reservation already settled");
+    throw std::logic_error("Reservation settled on another seller");
+}
+
+size_t Seller::chooseRandomIndex(size_t n) {
+    if (n == 0) return NO_INDEX;
+    return std::uniform_int_distribution<size_t>(0, n - 1)(rng);
+}
+
 ItemType Seller::chooseRandomItem(std::map<ItemType, int> &itemsForSale) {
     if (!itemsForSale.size()) {
         return ItemType::Nothing;
     }
     std::vector<std::pair<ItemType, int> > out;
-    std::sample(itemsForSale.begin(), itemsForSale.end(), std::back_inserter(out),
-            1, std::mt19937{std::random_device{}()});
+    std::sample(itemsForSale.begin(), itemsForSale.end(), std::back_inserter(out), 1, rng);
     return out.front().first;
 }
 
@@ -26,65 +56,69 @@ ItemType Seller::getRandomItemFromStock() {
     }
 
     auto it = stocks.begin();
-    std::advance(it, rand() % stocks.size());
+    std::advance(it, chooseRandomIndex(stocks.size()));
 
     return it->first;
 }
 
-int getCostPerUnit(ItemType item) {
-    switch (item) {
-        case ItemType::Syringe : return SYRINGUE_COST;
-        case ItemType::Pill : return PILL_COST;
-        case ItemType::Scalpel : return SCALPEL_COST;
-        case ItemType::Thermometer : return THERMOMETER_COST;
-        case ItemType::Stethoscope : return STETHOSCOPE_COST;
-        default : return 0;
+int Seller::applyIntent(const Intent& intent) {
+    switch (intent.op) {
+    case Intent::Op::Transfer:
+        return transfer(intent.item, intent.qty);
+    case Intent::Op::Buy:
+        // Une vente est entière ou n'a pas lieu
+        return buy(intent.item, intent.qty) > 0 ? intent.qty : 0;
+    case Intent::Op::Invoice:
+        // Le paiement de cette facture repassera lui aussi par une intention
+        invoice(intent.amount, phases->deferred(phases->actorAt(intent.from)));
+        return 0;
+    case Intent::Op::Pay:
+        pay(intent.amount);
+        return 0;
+    default:
+        throw std::logic_error("Seller::applyIntent(): replies are settled, not applied");
     }
 }
 
-std::string getItemName(ItemType item) {
-    switch (item) {
-        case ItemType::Syringe : return "Syringe";
-        case ItemType::Pill : return "Pill";
-        case ItemType::Scalpel : return "Scalpel";
-        case ItemType::Thermometer : return "Thermometer";
-        case ItemType::Stethoscope : return "Stethoscope";
-        case ItemType::RehabPatient : return "Rehab Patient";
-        case ItemType::SickPatient : return "Sick Patient";
-        case ItemType::Nothing : return "Nothing";
-        default : return "???";
-    }
+void Seller::settleReplies(const std::vector<Intent>& /*replies*/) {
+    throw std::logic_error("Seller::settleReplies() not supported");
 }
 
-EmployeeType getEmployeeThatProduces(ItemType item) {
-    switch (item) {
-        case ItemType::Syringe : /* fallthrough */
-        case ItemType::Pill : /* fallthrough */
-        case ItemType::Scalpel : /* fallthrough */
-        case ItemType::Thermometer : /* fallthrough */
-        case ItemType::SickPatient : /* fallthrough */
-        case ItemType::Stethoscope : return EmployeeType::Supplier;
-        case ItemType::RehabPatient : return EmployeeType::TreatmentSpecialist;
-        default : return EmployeeType::Nothing;
-    }
+void Seller::applyIntents() {
+    if (!phases) return;
+    phases->applyInbox(this);
+    // Le dernier arrivé à la barrière achemine les réponses vers leurs demandeurs
+    clock->worker_phase_barrier();
+    phases->bindOutbox(this);
+    phases->settleReplies(this);
 }
 
-int getEmployeeSalary(EmployeeType employee) {
-    switch (employee) {
-        case EmployeeType::EmergencyStaff : return NURSE_COST;
-        case EmployeeType::NursingStaff : return NURSE_COST;
-        case EmployeeType::Supplier : return SUPPLIER_COST;
-        case EmployeeType::TreatmentSpecialist : return DOCTOR_COST;
-        default : return 0;
-    }
+Seller* Seller::oneWay(Seller* target) {
+    return phases ? phases->deferred(target) : target;
 }
 
-int getCostPerService(ServiceType claim) {
-    switch (claim) {
-        case ServiceType::Transport : return TRANSFER_COST;
-        case ServiceType::PreTreatmentStay : return PRETREATMENT_COST;
-        case ServiceType::Treatment : return TREATMENT_COST;
-        case ServiceType::Rehab : return REHAB_COST;
-        default : return 0;
+void Seller::publishState() {
+    ActorState state{};
+    state.day = clock ? clock->current_day() : lastRunDay;
+    fillState(state);
+    published.publish(state);
+    // Avec des journées en phases, les autres acteurs liront cet état demain
+    if (phases) phases->publish(this, state);
+}
+
+void Seller::fillState(ActorState& state) {
+    state.fund = money;
+    state.employeesPaid = nbEmployeesPaid;
+    state.freeCapacity = getFreeCapacity();
+    state.waiting = isWaitingForPayment() ? 1 : 0;
+    for (const auto& [item, qty] : stocks) {
+        if (static_cast<int>(item) < ActorState::NB_ITEMS) state.stock[static_cast<int>(item)] = qty;
     }
 }
+
+int Seller::enterDay() {
+    int today = clock->current_day();
+    int elapsed = today - lastDayRun();
+    lastRunDay = today;
+    return elapsed;
+}
@@ -0,0 +1,430 @@
+#include "snapshot.h"
+#include "ambulance.h"
+#include "clinic.h"
+#include "hospital.h"
+#include "insurance.h"
+#include "supplier.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <sstream>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char MAGIC[8] = "PCOSNAP";
+constexpr int NB_ITEM_TYPES = static_cast<int>(ItemType::Nothing);
+constexpr int32_t NO_STOCK = -1;
+
+enum class ActorKind : int32_t { Ambulance, Hospital, Clinic, Supplier, Insurance };
+enum class LinkRole : int32_t { Hospital, Clinic, Supplier, Insurance };
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    int32_t day;
+    uint32_t nbActors;
+    uint32_t poolSize;      ///< Number of int32 in the pool.
+};
+
+struct ActorRecord {
+    int32_t uniqueId;
+    ActorKind kind;
+    int32_t money;
+    int32_t nbEmployeesPaid;
+    int32_t stocks[NB_ITEM_TYPES];  ///< NO_STOCK when the item is not held at all.
+    int32_t counter;                ///< Hospital::nbFreed.
+    int32_t queued;                 ///< Patients handed over but not yet drained by the receiver.
+    uint32_t linksOffset, nbLinks;  ///< Pool pairs (LinkRole, uniqueId).
+    uint32_t billsOffset, nbBills;  ///< Pool pairs (uniqueId, amount).
+    uint32_t timersOffset, nbTimers;///< Pool entries: rehab days left, or (item, qty, daysLeft) per supplier batch.
+    uint32_t rngOffset, nbRng;      ///< Pool entries: words of the random engine, as written by operator<<.
+    uint32_t creditsOffset, nbCredits; ///< Pool pairs (uniqueId, credit limit) of the insurance.
+    uint32_t overdraftsOffset, nbOverdrafts; ///< Pool pairs (uniqueId, credit drawn) of the insurance, oldest first.
+};
+
+ActorKind kindOf(Seller* s) {
+    if (dynamic_cast<Ambulance*>(s)) return ActorKind::Ambulance;
+    if (dynamic_cast<Hospital*>(s))  return ActorKind::Hospital;
+    if (dynamic_cast<Clinic*>(s))    return ActorKind::Clinic;
+    if (dynamic_cast<Supplier*>(s))  return ActorKind::Supplier;
+    if (dynamic_cast<Insurance*>(s)) return ActorKind::Insurance;
+    throw std::runtime_error("Snapshot: unknown actor type");
+}
+
+/**
+ * @brief Read-only memory mapping of a whole file, unmapped on destruction.
+ */
+struct MappedFile {
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Snapshot: cannot open " + path);
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(SnapshotHeader))) {
+            ::close(fd);
+            throw std::runtime_error("Snapshot: truncated file " + path);
+        }
+        size = static_cast<size_t>(st.st_size);
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) throw std::runtime_error("Snapshot: cannot map " + path);
+        data = static_cast<const char*>(mapped);
+    }
+
+    ~MappedFile() { ::munmap(const_cast<char*>(data), size); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data{nullptr};
+    size_t size{0};
+};
+
+/**
+ * @brief Writes a whole buffer, retrying short writes.
+ */
+bool writeAll(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = ::write(fd, bytes, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        bytes += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * @brief Flushes the directory holding path, so that a rename into it survives a crash.
+ */
+bool syncParentDirectory(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return false;
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+}
+
+void addEngine(std::vector<int32_t>& pool, ActorRecord& rec, const std::mt19937& rng) {
+    std::stringstream text;
+    text << rng;
+    rec.rngOffset = static_cast<uint32_t>(pool.size());
+    for (uint32_t word; text >> word;) {
+        pool.push_back(static_cast<int32_t>(word));
+        ++rec.nbRng;
+    }
+}
+
+std::mt19937 engineFrom(const int32_t* words, uint32_t count) {
+    if (count != std::mt19937::state_size + 1) throw std::runtime_error("Snapshot: invalid random state");
+    std::stringstream text;
+    for (uint32_t w = 0; w < count; ++w) text << static_cast<uint32_t>(words[w]) << ' ';
+    std::mt19937 rng;
+    if (!(text >> rng)) throw std::runtime_error("Snapshot: invalid random state");
+    return rng;
+}
+
+void addLinks(std::vector<int32_t>& pool, ActorRecord& rec, LinkRole role, const std::vector<Seller*>& sellers) {
+    for (auto* s : sellers) {
+        pool.push_back(static_cast<int32_t>(role));
+        pool.push_back(s->getUniqueId());
+        ++rec.nbLinks;
+    }
+}
+
+} // namespace
+
+void Snapshot::save(const std::string& path, const std::vector<Seller*>& sellers, int day) {
+    std::vector<ActorRecord> records(sellers.size());
+    std::vector<int32_t> pool;
+
+    for (size_t i = 0; i < sellers.size(); ++i) {
+        Seller* s = sellers[i];
+        ActorRecord& rec = records[i];
+        std::memset(&rec, 0, sizeof(rec));
+
+        rec.uniqueId = s->uniqueId;
+        rec.kind = kindOf(s);
+        rec.money = s->money;
+        rec.nbEmployeesPaid = s->nbEmployeesPaid;
+        // getStock() : le stock des fournisseurs est dans leurs compteurs
+        auto stock = s->getStock();
+        for (int it = 0; it < NB_ITEM_TYPES; ++it) {
+            auto found = stock.find(static_cast<ItemType>(it));
+            rec.stocks[it] = found == stock.end() ? NO_STOCK : found->second;
+        }
+
+        addEngine(pool, rec, s->rng);
+
+        rec.linksOffset = static_cast<uint32_t>(pool.size());
+        switch (rec.kind) {
+            case ActorKind::Ambulance: {
+                auto* a = static_cast<Ambulance*>(s);
+                addLinks(pool, rec, LinkRole::Hospital, a->hospitals);
+                if (a->insurance) addLinks(pool, rec, LinkRole::Insurance, {a->insurance});
+                break;
+            }
+            case ActorKind::Hospital: {
+                auto* h = static_cast<Hospital*>(s);
+                addLinks(pool, rec, LinkRole::Clinic, h->clinics);
+                if (h->insurance) addLinks(pool, rec, LinkRole::Insurance, {h->insurance});
+                rec.counter = h->nbFreed;
+                rec.queued = h->nbRehabArrived;
+                rec.timersOffset = static_cast<uint32_t>(pool.size());
+                rec.nbTimers = static_cast<uint32_t>(h->rehabTimers.size());
+                for (const auto& timer : h->rehabTimers) pool.push_back(timer.daysLeft);
+                break;
+            }
+            case ActorKind::Clinic: {
+                auto* c = static_cast<Clinic*>(s);
+                addLinks(pool, rec, LinkRole::Hospital, c->hospitals);
+                addLinks(pool, rec, LinkRole::Supplier, c->suppliers);
+                if (c->insurance) addLinks(pool, rec, LinkRole::Insurance, {c->insurance});
+                rec.queued = c->nbArrived;
+                rec.billsOffset = static_cast<uint32_t>(pool.size());
+                for (auto& [supplier, bill] : c->unpaidBills) {
+                    pool.push_back(supplier->getUniqueId());
+                    pool.push_back(bill);
+                    ++rec.nbBills;
+                }
+                break;
+            }
+            case ActorKind::Insurance: {
+                auto* ins = static_cast<Insurance*>(s);
+                rec.billsOffset = static_cast<uint32_t>(pool.size());
+                for (auto& [who, bill] : ins->unpaidBills.pending()) {
+                    pool.push_back(who->getUniqueId());
+                    pool.push_back(bill);
+                    ++rec.nbBills;
+                }
+                rec.creditsOffset = static_cast<uint32_t>(pool.size());
+                for (auto& [who, limit] : ins->unpaidBills.getCreditLimits()) {
+                    pool.push_back(who->getUniqueId());
+                    pool.push_back(limit);
+                    ++rec.nbCredits;
+                }
+                rec.overdraftsOffset = static_cast<uint32_t>(pool.size());
+                for (auto& [who, drawn] : ins->unpaidBills.getOverdrafts()) {
+                    pool.push_back(who->getUniqueId());
+                    pool.push_back(drawn);
+                    ++rec.nbOverdrafts;
+                }
+                break;
+            }
+            case ActorKind::Supplier: {
+                auto* sup = static_cast<Supplier*>(s);
+                rec.timersOffset = static_cast<uint32_t>(pool.size());
+                for (const auto& batch : sup->workInProgress) {
+                    pool.push_back(static_cast<int32_t>(batch.item));
+                    pool.push_back(batch.qty);
+                    pool.push_back(batch.daysLeft);
+                    rec.nbTimers += 3;
+                }
+                break;
+            }
+        }
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.day = day;
+    header.nbActors = static_cast<uint32_t>(records.size());
+    header.poolSize = static_cast<uint32_t>(pool.size());
+
+    // Fichier temporaire rendu durable avant le rename, puis le répertoire :
+    // après un crash, path contient l'ancien ou le nouveau snapshot, jamais un fichier tronqué
+    const std::string tmpPath = path + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw std::runtime_error("Snapshot: cannot write " + tmpPath);
+    bool written = writeAll(fd, &header, sizeof(header))
+                && writeAll(fd, records.data(), records.size() * sizeof(ActorRecord))
+                && writeAll(fd, pool.data(), pool.size() * sizeof(int32_t))
+                && ::fsync(fd) == 0;
+    written = ::close(fd) == 0 && written;
+    if (!written) {
+        std::remove(tmpPath.c_str());
+        throw std::runtime_error("Snapshot: cannot write " + tmpPath);
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Snapshot: cannot replace " + path);
+    }
+    if (!syncParentDirectory(path)) {
+        throw std::runtime_error("Snapshot: cannot flush the directory of " + path);
+    }
+}
+
+int Snapshot::restore(const std::string& path, const std::vector<Seller*>& sellers) {
+    MappedFile file(path);
+    const char* base = file.data;
+    const auto* header = reinterpret_cast<const SnapshotHeader*>(base);
+    const size_t expected = sizeof(SnapshotHeader)
+                          + header->nbActors * sizeof(ActorRecord)
+                          + header->poolSize * sizeof(int32_t);
+
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION || expected != file.size) {
+        throw std::runtime_error("Snapshot: invalid or incompatible file " + path);
+    }
+    if (header->nbActors != sellers.size()) {
+        throw std::runtime_error("Snapshot: actor count does not match");
+    }
+
+    const auto* records = reinterpret_cast<const ActorRecord*>(base + sizeof(SnapshotHeader));
+    const auto* pool = reinterpret_cast<const int32_t*>(records + header->nbActors);
+
+    std::unordered_map<int, Seller*> byId;
+    for (auto* s : sellers) byId[s->getUniqueId()] = s;
+
+    auto lookup = [&](int32_t id) -> Seller* {
+        auto found = byId.find(id);
+        if (found == byId.end()) throw std::runtime_error("Snapshot: unknown actor id " + std::to_string(id));
+        return found->second;
+    };
+
+    population().reset();
+
+    for (uint32_t i = 0; i < header->nbActors; ++i) {
+        const ActorRecord& rec = records[i];
+        Seller* s = lookup(rec.uniqueId);
+        if (kindOf(s) != rec.kind) {
+            throw std::runtime_error("Snapshot: actor " + std::to_string(rec.uniqueId) + " changed type");
+        }
+
+        auto inPool = [&](uint32_t offset, uint32_t count) {
+            return static_cast<uint64_t>(offset) + count <= header->poolSize;
+        };
+        if (!inPool(rec.linksOffset, 2 * rec.nbLinks) || !inPool(rec.billsOffset, 2 * rec.nbBills)
+            || !inPool(rec.timersOffset, rec.nbTimers) || !inPool(rec.rngOffset, rec.nbRng)
+            || !inPool(rec.creditsOffset, 2 * rec.nbCredits) || !inPool(rec.overdraftsOffset, 2 * rec.nbOverdrafts)) {
+            throw std::runtime_error("Snapshot: record " + std::to_string(rec.uniqueId) + " out of bounds");
+        }
+
+        s->money = rec.money;
+        s->nbEmployeesPaid = rec.nbEmployeesPaid;
+        s->rng = engineFrom(pool + rec.rngOffset, rec.nbRng);
+        // Les entrées existantes ne sont jamais supprimées : les cliniques pointent sur celles des patients
+        for (int it = 0; it < NB_ITEM_TYPES; ++it) {
+            auto item = static_cast<ItemType>(it);
+            if (rec.stocks[it] != NO_STOCK) {
+                s->stocks[item] = rec.stocks[it];
+            } else if (auto entry = s->stocks.find(item); entry != s->stocks.end()) {
+                entry->second = 0;
+            }
+        }
+
+        std::vector<Seller*> links[4];
+        for (uint32_t l = 0; l < rec.nbLinks; ++l) {
+            const int32_t* link = pool + rec.linksOffset + 2 * l;
+            if (link[0] < 0 || link[0] > static_cast<int32_t>(LinkRole::Insurance)) {
+                throw std::runtime_error("Snapshot: invalid link role");
+            }
+            links[link[0]].push_back(lookup(link[1]));
+        }
+        Seller* insurance = links[static_cast<int>(LinkRole::Insurance)].empty()
+                          ? nullptr : links[static_cast<int>(LinkRole::Insurance)].front();
+
+        auto stockOf = [&](ItemType it) { return s->stocks.count(it) ? s->stocks[it] : 0; };
+
+        switch (rec.kind) {
+            case ActorKind::Ambulance: {
+                auto* a = static_cast<Ambulance*>(s);
+                a->setHospitals(links[static_cast<int>(LinkRole::Hospital)]);
+                a->setInsurance(insurance);
+                population().add(PatientHolder::Ambulance, stockOf(ItemType::SickPatient));
+                break;
+            }
+            case ActorKind::Hospital: {
+                auto* h = static_cast<Hospital*>(s);
+                h->setClinics(links[static_cast<int>(LinkRole::Clinic)]);
+                h->setInsurance(insurance);
+                h->nbFreed = rec.counter;
+                // Les fiches patients ne sont pas sauvegardées : les minuteurs restaurés n'en ont pas
+                h->rehabTimers.clear();
+                for (uint32_t t = 0; t < rec.nbTimers; ++t) {
+                    h->rehabTimers.push_back({pool[rec.timersOffset + t], NO_PATIENT});
+                }
+                for (int q = 0; q < rec.queued; ++q) h->rehabArrivals.tryPush(NO_PATIENT);
+                h->nbRehabArrived = rec.queued;
+                int admitted = stockOf(ItemType::SickPatient) + stockOf(ItemType::RehabPatient) + rec.queued;
+                h->beds.reset(h->maxBeds - admitted);
+                h->hasFunds = h->money > 0;
+                population().add(PatientHolder::Hospital, admitted);
+                population().add(PatientHolder::Freed, h->nbFreed);
+                break;
+            }
+            case ActorKind::Clinic: {
+                auto* c = static_cast<Clinic*>(s);
+                c->setHospitalsAndSuppliers(links[static_cast<int>(LinkRole::Hospital)],
+                                            links[static_cast<int>(LinkRole::Supplier)]);
+                c->setInsurance(insurance);
+                // Les cliniques spécialisées gardent le stock des ressources hors de la map
+                for (auto item : c->resourcesNeeded) {
+                    int qty = stockOf(item);
+                    c->stocks.erase(item);
+                    c->setResourceStock(item, qty);
+                }
+                for (int q = 0; q < rec.queued; ++q) c->arrivals.tryPush(NO_PATIENT);
+                c->nbArrived = rec.queued;
+                c->arrivalsFree = CLINIC_QUEUE_CAPACITY - rec.queued;
+                c->unpaidBills.clear();
+                for (uint32_t b = 0; b < rec.nbBills; ++b) {
+                    const int32_t* bill = pool + rec.billsOffset + 2 * b;
+                    Seller* supplier = lookup(bill[0]);
+                    if (kindOf(supplier) != ActorKind::Supplier) {
+                        throw std::runtime_error("Snapshot: clinic bill to non-supplier " + std::to_string(bill[0]));
+                    }
+                    c->unpaidBills.emplace_back(static_cast<Supplier*>(supplier), bill[1]);
+                }
+                c->publishAcceptance();
+                population().add(PatientHolder::Clinic,
+                                 stockOf(ItemType::SickPatient) + stockOf(ItemType::RehabPatient) + rec.queued);
+                break;
+            }
+            case ActorKind::Insurance: {
+                auto* ins = static_cast<Insurance*>(s);
+                ins->unpaidBills.clear();
+                for (uint32_t b = 0; b < rec.nbBills; ++b) {
+                    const int32_t* bill = pool + rec.billsOffset + 2 * b;
+                    ins->unpaidBills.add(lookup(bill[0]), bill[1]);
+                }
+                ins->unpaidBills.clearCreditLimits();
+                for (uint32_t l = 0; l < rec.nbCredits; ++l) {
+                    const int32_t* credit = pool + rec.creditsOffset + 2 * l;
+                    ins->unpaidBills.setCreditLimit(lookup(credit[0]), credit[1]);
+                }
+                for (uint32_t o = 0; o < rec.nbOverdrafts; ++o) {
+                    const int32_t* draw = pool + rec.overdraftsOffset + 2 * o;
+                    ins->unpaidBills.addOverdraft(lookup(draw[0]), draw[1]);
+                }
+                break;
+            }
+            case ActorKind::Supplier: {
+                auto* sup = static_cast<Supplier*>(s);
+                if (rec.nbTimers % 3 != 0) throw std::runtime_error("Snapshot: truncated supplier batch");
+                sup->workInProgress.clear();
+                for (uint32_t b = 0; b < rec.nbTimers; b += 3) {
+                    const int32_t* batch = pool + rec.timersOffset + b;
+                    if (batch[0] < 0 || batch[0] >= NB_ITEM_TYPES) throw std::runtime_error("Snapshot: invalid item");
+                    sup->workInProgress.push_back({static_cast<ItemType>(batch[0]), batch[1], batch[2]});
+                }
+                // Le stock va dans les compteurs, la map des fournisseurs reste vide
+                for (auto item : sup->resourcesSupplied) sup->stockOf(item).store(stockOf(item));
+                sup->stocks.clear();
+                break;
+            }
+        }
+    }
+
+    return header->day;
+}
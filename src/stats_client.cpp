@@ -0,0 +1,38 @@
+// stats_client.cpp : affiche les statistiques d'une simulation lancée avec --stats=SOCKET
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+#include "stats_server.h"
+
+int main(int argc, char** argv) {
+    if (argc != 2 && argc != 3) {
+        printf("Usage: %s SOCKET [INTERVAL_MS]\n", argv[0]);
+        return 1;
+    }
+
+    const std::string path = argv[1];
+    const int intervalMs = argc == 3 ? atoi(argv[2]) : 0;
+
+    // Sans intervalle un seul rapport, sinon un rapport par intervalle jusqu'à la fin de la simulation
+    bool first = true;
+    do {
+        try {
+            std::string report = StatsServer::query(path);
+            if (!first) printf("\n");
+            fputs(report.c_str(), stdout);
+            fflush(stdout);
+            first = false;
+        } catch (const std::runtime_error& e) {
+            if (first) {
+                printf("%s\n", e.what());
+                return 1;
+            }
+            return 0;
+        }
+        if (intervalMs > 0) usleep(static_cast<useconds_t>(intervalMs) * 1000);
+    } while (intervalMs > 0);
+    return 0;
+}
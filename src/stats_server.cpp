@@ -0,0 +1,153 @@
+#include "stats_server.h"
+#include "population.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <tuple>
+#include <unistd.h>
+
+namespace {
+
+const char* const HOLDER_NAMES[] = {"ambulance", "hospital", "clinic", "freed"};
+static_assert(sizeof(HOLDER_NAMES) / sizeof(HOLDER_NAMES[0]) == static_cast<int>(PatientHolder::Nothing));
+
+sockaddr_un addressOf(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("Stats: bad socket path " + path);
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return addr;
+}
+
+void sendAll(int fd, const std::string& text) {
+    size_t sent = 0;
+    while (sent < text.size()) {
+        ssize_t n = ::send(fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;
+        sent += static_cast<size_t>(n);
+    }
+}
+
+} // namespace
+
+StatsServer::StatsServer(const std::string& path, std::vector<StatsGroup> groups, const DayClock& clock)
+    : path(path), groups(std::move(groups)), clock(clock), start(std::chrono::steady_clock::now()),
+      startDay(clock.current_day()), startFreed(population().count(PatientHolder::Freed)) {
+    sockaddr_un addr = addressOf(path);
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) throw std::runtime_error("Stats: cannot create socket");
+
+    // Un fichier laissé par une exécution précédente empêcherait bind()
+    ::unlink(path.c_str());
+    if (::bind(listenFd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(listenFd, 8) < 0) {
+        ::close(listenFd);
+        throw std::runtime_error("Stats: cannot listen on " + path + ": " + std::strerror(errno));
+    }
+    server = std::make_unique<PcoThread>(&StatsServer::serveLoop, this);
+}
+
+StatsServer::~StatsServer() {
+    stopping = true;
+    server->join();
+    ::close(listenFd);
+    ::unlink(path.c_str());
+}
+
+void StatsServer::serveLoop() {
+    pollfd waiting{listenFd, POLLIN, 0};
+    while (!stopping.load()) {
+        // Attente bornée : l'arrêt est vu au plus tard 100 ms après la demande
+        if (::poll(&waiting, 1, 100) <= 0) continue;
+        int client = ::accept(listenFd, nullptr, nullptr);
+        if (client < 0) continue;
+        sendAll(client, report());
+        ::close(client);
+    }
+}
+
+std::string StatsServer::report() const {
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    int day = clock.current_day();
+    long long freed = population().count(PatientHolder::Freed);
+
+    std::ostringstream out;
+    out << "day " << day << "\n";
+    out << "elapsed_sec " << elapsed << "\n";
+    out << "days_per_sec " << (elapsed > 0 ? (day - startDay) / elapsed : 0.0) << "\n";
+    for (int h = 0; h < static_cast<int>(PatientHolder::Nothing); ++h) {
+        out << "patients_" << HOLDER_NAMES[h] << " " << population().count(static_cast<PatientHolder>(h)) << "\n";
+    }
+    out << "patients_per_sec " << (elapsed > 0 ? (freed - startFreed) / elapsed : 0.0) << "\n";
+    out << "rejected_patients " << population().rejected() << "\n";
+
+    const WaitHistogram& waits = clock.getBarrierWaits();
+    out << "barrier_waits " << waits.count() << "\n";
+    out << "barrier_wait_p50_us " << waits.percentileUs(0.50) << "\n";
+    out << "barrier_wait_p90_us " << waits.percentileUs(0.90) << "\n";
+    out << "barrier_wait_p99_us " << waits.percentileUs(0.99) << "\n";
+
+    // (contended, attente, groupe, acteur) des mutex les plus disputés
+    std::vector<std::tuple<uint64_t, uint64_t, const std::string*, int>> hot;
+    for (const auto& group : groups) {
+        long long fund = 0, backlog = 0, unpaid = 0;
+        LockStats locks;
+        for (const Seller* s : group.actors) {
+            ActorState state = s->readState();
+            fund += state.fund;
+            backlog += state.backlog;
+            unpaid += state.unpaid;
+
+            LockStats l = s->getLockStats();
+            locks.acquisitions += l.acquisitions;
+            locks.contended += l.contended;
+            locks.waitNs += l.waitNs;
+            if (l.contended > 0) hot.emplace_back(l.contended, l.waitNs, &group.name, s->getUniqueId());
+        }
+        out << "fund_" << group.name << " " << fund << "\n";
+        out << "backlog_" << group.name << " " << backlog << "\n";
+        out << "unpaid_" << group.name << " " << unpaid << "\n";
+        out << "lock_" << group.name << "_acquisitions " << locks.acquisitions << "\n";
+        out << "lock_" << group.name << "_contended " << locks.contended << "\n";
+        out << "lock_" << group.name << "_wait_ms " << locks.waitNs / 1'000'000 << "\n";
+    }
+
+    size_t nbHot = std::min(hot.size(), static_cast<size_t>(NB_HOT_LOCKS));
+    std::partial_sort(hot.begin(), hot.begin() + static_cast<std::ptrdiff_t>(nbHot), hot.end(),
+                      [](const auto& a, const auto& b) { return std::get<0>(a) > std::get<0>(b); });
+    for (size_t i = 0; i < nbHot; ++i) {
+        const auto& [contended, waitNs, name, id] = hot[i];
+        out << "hot_lock " << *name << " " << id << " contended " << contended
+            << " wait_ms " << waitNs / 1'000'000 << "\n";
+    }
+    return out.str();
+}
+
+std::string StatsServer::query(const std::string& path) {
+    sockaddr_un addr = addressOf(path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) throw std::runtime_error("Stats: cannot create socket");
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        throw std::runtime_error("Stats: nothing listens on " + path);
+    }
+
+    std::string text;
+    char buffer[4096];
+    while (true) {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        text.append(buffer, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return text;
+}
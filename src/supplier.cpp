@@ -1,13 +1,16 @@
 #include "supplier.h"
 #include "costs.h"
+#include "journal.h"
+#include "phases.h"
 #include <pcosynchro/pcothread.h>
+#include <algorithm>
 #include <iostream>
 
 
 Supplier::Supplier(int uniqueId, int fund, std::vector<ItemType> resourcesSupplied)
     : Seller(fund, uniqueId), resourcesSupplied(resourcesSupplied) {
-    for (const auto& item : resourcesSupplied) {    
-        stocks[item] = 0;    
+    for (const auto& item : resourcesSupplied) {
+        plans[item] = ProductionPlan{};
     }
 }
 
@@ -15,11 +18,14 @@ void Supplier::run() {
     logger() << "Supplier " <<  uniqueId << " starting with fund " << money << std::endl;
 
     while (true) {
-        clock->worker_wait_day_start();
+        clock->worker_wait_day_start(this);
         if (PcoThread::thisThread()->stopRequested()) break;
+        applyIntents();
 
+        advanceProduction(enterDay());
         attemptToProduceResource();
 
+        publishState();
         clock->worker_end_day();
     }
 
@@ -27,28 +33,121 @@ void Supplier::run() {
 }
 
 void Supplier::attemptToProduceResource() {
+    ItemType item = resourcesSupplied[chooseRandomIndex(resourcesSupplied.size())];
+    int salary = getEmployeeSalary(getEmployeeThatProduces(item));
+
+    mutex.lock();
+    const ProductionPlan& plan = plans[item];
+    int cost = plan.batchSize * salary;
+    bool produced = money >= cost;
+    if (produced) {
+        money -= cost;
+        nbEmployeesPaid += plan.batchSize;
+        if (plan.leadTimeDays == 0) {
+            stockOf(item).add(plan.batchSize);
+        } else {
+            workInProgress.push_back({item, plan.batchSize, plan.leadTimeDays});
+        }
+    }
+    int qty = plan.batchSize;
+    mutex.unlock();
 
-    // TODO
+    if (produced) journal().record(EventType::Salary, uniqueId, -1, item, qty, cost);
+}
 
+void Supplier::advanceProduction(int days) {
+    mutex.lock();
+    // Les lots sont démarrés dans l'ordre mais les délais varient selon l'article
+    for (auto it = workInProgress.begin(); it != workInProgress.end();) {
+        it->daysLeft -= days;
+        if (it->daysLeft > 0) {
+            ++it;
+            continue;
+        }
+        stockOf(it->item).add(it->qty);
+        it = workInProgress.erase(it);
+    }
+    mutex.unlock();
 }
 
 int Supplier::buy(ItemType it, int qty) {
+    if (qty <= 0 || !sellsResource(it)) return 0;
 
-    // TODO
+    // Pas de verrou : la facture ne dépend que de la quantité retirée
+    return stockOf(it).tryTake(qty) * getCostPerUnit(it);
 }
 
 void Supplier::pay(int bill) {
+    mutex.lock();
+    money += bill;
+    mutex.unlock();
+}
 
-    // TODO
-
+int Supplier::applyIntent(const Intent& intent) {
+    switch (intent.op) {
+    case Intent::Op::Buy:
+        // Tout ou rien, comme buy()
+        if (intent.qty <= 0 || !sellsResource(intent.item)) return 0;
+        return stockOf(intent.item).tryTake(intent.qty);
+    case Intent::Op::Pay:
+        // Seul ce thread touche le fournisseur pendant l'application : pas de verrou
+        money += intent.amount;
+        return 0;
+    default:
+        return Seller::applyIntent(intent);
+    }
 }
 
 int Supplier::getMaterialCost() {
-    int totalCost = 0;
+    return getOrderCost(resourcesSupplied);
+}
+
+void Supplier::setProductionPlan(ItemType item, ProductionPlan plan) {
+    if (!sellsResource(item)) return;
+    mutex.lock();
+    plans[item] = {std::max(1, plan.batchSize), std::max(0, plan.leadTimeDays)};
+    mutex.unlock();
+}
+
+int Supplier::getAvailable(ItemType item) const {
+    if (item == ItemType::Nothing) return 0;
+    return stock[static_cast<size_t>(item)].load();
+}
+
+std::map<ItemType, int> Supplier::getStock() const {
+    std::map<ItemType, int> out;
+    for (const auto& item : resourcesSupplied) out[item] = getAvailable(item);
+    return out;
+}
+
+int Supplier::nextWorkDay(int today) {
+    mutex.lock();
+    bool busy = false;
     for (const auto& item : resourcesSupplied) {
-        totalCost += getCostPerUnit(item);
+        busy = busy || money >= plans[item].batchSize * getEmployeeSalary(getEmployeeThatProduces(item));
     }
-    return totalCost;
+    int nextBatch = NO_WORK_DAY;
+    for (const auto& batch : workInProgress) {
+        nextBatch = std::min(nextBatch, lastDayRun() + batch.daysLeft);
+    }
+    mutex.unlock();
+    return busy ? today : std::max(today, nextBatch);
+}
+
+int Supplier::getWorkInProgress() {
+    mutex.lock();
+    int total = 0;
+    for (const auto& batch : workInProgress) total += batch.qty;
+    mutex.unlock();
+    return total;
+}
+
+void Supplier::fillState(ActorState& state) {
+    mutex.lock();
+    Seller::fillState(state);
+    for (const auto& batch : workInProgress) state.backlog += batch.qty;
+    mutex.unlock();
+    for (const auto& item : resourcesSupplied) state.stock[static_cast<int>(item)] = getAvailable(item);
 }
 
 bool Supplier::sellsResource(ItemType item) const {
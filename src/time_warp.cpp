@@ -0,0 +1,86 @@
+#include "time_warp.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+TimeWarpClock::TimeWarpClock(const std::vector<Seller*>& actors, int lastDay)
+: DayClock(static_cast<int>(actors.size())), actors(actors), lastDay(lastDay),
+  due(actors.size(), 0), lastWake(actors.size(), 0) {
+    for (size_t i = 0; i < actors.size(); ++i) indexOf[actors[i]] = i;
+}
+
+int TimeWarpClock::skip_to_next_work_day() {
+    int today = current_day();
+    if (planned) return today;
+
+    // Jour de travail le plus proche ; le dernier jour réveille tout le monde
+    std::vector<int> nextDays(actors.size());
+    int next = std::max(today, lastDay - 1);
+    for (size_t i = 0; i < actors.size(); ++i) {
+        nextDays[i] = std::max(today, actors[i]->nextWorkDay(today));
+        next = std::min(next, nextDays[i]);
+    }
+    bool closing = next >= lastDay - 1;
+
+    mutex.lock();
+    jump_to_day(next);
+    nbDue = 0;
+    for (size_t i = 0; i < actors.size(); ++i) {
+        due[i] = closing || nextDays[i] == next;
+        nbDue += due[i];
+    }
+    arrived = 0;
+    planned = true;
+    idleActorDays += static_cast<long long>(next - today) * static_cast<long long>(actors.size()) +
+                     static_cast<long long>(actors.size()) - nbDue;
+    mutex.unlock();
+    return next;
+}
+
+void TimeWarpClock::start_next_day() {
+    skip_to_next_work_day();
+
+    mutex.lock();
+    planned = false;
+    ++generation;
+    ++daysRun;
+    dayStarted.notifyAll();
+    mutex.unlock();
+}
+
+void TimeWarpClock::wait_all_done() {
+    mutex.lock();
+    while (arrived < nbDue) allArrived.wait(&mutex);
+    mutex.unlock();
+    advance_day();
+}
+
+void TimeWarpClock::worker_wait_day_start() {
+    throw std::logic_error("TimeWarpClock::worker_wait_day_start() needs the waiting actor");
+}
+
+void TimeWarpClock::worker_wait_day_start(Seller* who) {
+    size_t i = indexOf.at(who);
+    mutex.lock();
+    // Un acteur ne tourne qu'une fois par jour démarré, même s'il revient vite
+    while (!releasing && !(due[i] && lastWake[i] != generation)) dayStarted.wait(&mutex);
+    lastWake[i] = generation;
+    mutex.unlock();
+}
+
+void TimeWarpClock::worker_phase_barrier() {
+    throw std::logic_error("TimeWarpClock does not support phased days");
+}
+
+void TimeWarpClock::worker_end_day() {
+    mutex.lock();
+    if (++arrived == nbDue) allArrived.notifyOne();
+    mutex.unlock();
+}
+
+void TimeWarpClock::release_workers() {
+    mutex.lock();
+    releasing = true;
+    dayStarted.notifyAll();
+    mutex.unlock();
+}
@@ -0,0 +1,264 @@
+#include "topology.h"
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+#include "utils.h"
+
+namespace {
+
+/// First index of region r when count items are split in regions parts.
+int regionStart(int count, int regions, int r) {
+    return static_cast<int>(static_cast<long long>(count) * r / regions);
+}
+
+/// Region of item i.
+int regionOf(int count, int regions, int i) {
+    return static_cast<int>((static_cast<long long>(i) * regions) / count);
+}
+
+/// k consecutive indices of [begin, end), starting at first and wrapping around.
+std::vector<int> window(int begin, int end, int first, int k) {
+    int size = end - begin;
+    k = std::min(k, size);
+    std::vector<int> out;
+    out.reserve(k);
+    for (int j = 0; j < k; ++j) out.push_back(begin + (first - begin + j) % size);
+    return out;
+}
+
+template<typename T>
+std::vector<Seller*> pick(const std::vector<T*>& actors, const std::vector<int>& indices) {
+    std::vector<Seller*> out;
+    out.reserve(indices.size());
+    for (int i : indices) out.push_back(actors[i]);
+    return out;
+}
+
+const char* const KIND_AMBULANCE = "ambulance";
+const char* const KIND_HOSPITAL  = "hospital";
+const char* const KIND_CLINIC_H  = "clinic-hospitals";
+const char* const KIND_CLINIC_S  = "clinic-suppliers";
+
+/**
+ * @brief Index of the first ambulance linked to no hospital, -1 if there is none.
+ */
+int ambulanceWithoutHospital(const Topology& t) {
+    for (int a = 0; a < t.nbAmbulances; ++a) {
+        if (t.ambulanceHospitals[a].empty()) return a;
+    }
+    return -1;
+}
+
+} // namespace
+
+size_t Topology::nbLinks() const {
+    size_t total = 0;
+    for (const auto* lists : {&ambulanceHospitals, &hospitalClinics, &clinicHospitals, &clinicSuppliers}) {
+        for (const auto& l : *lists) total += l.size();
+    }
+    return total;
+}
+
+Topology makeAllToAllTopology(int nbAmbulances, int nbSuppliers, int nbClinics, int nbHospitals) {
+    Topology t{nbAmbulances, nbSuppliers, nbClinics, nbHospitals, {}, {}, {}, {}};
+
+    std::vector<int> allHospitals(nbHospitals);
+    for (int h = 0; h < nbHospitals; ++h) allHospitals[h] = h;
+    std::vector<int> allSuppliers(nbSuppliers);
+    for (int s = 0; s < nbSuppliers; ++s) allSuppliers[s] = s;
+
+    t.ambulanceHospitals.assign(nbAmbulances, allHospitals);
+    t.clinicHospitals.assign(nbClinics, allHospitals);
+    t.clinicSuppliers.assign(nbClinics, allSuppliers);
+
+    int clinicsByHospital = nbClinics / nbHospitals;
+    int clinicsShared     = nbClinics % nbHospitals;
+    t.hospitalClinics.resize(nbHospitals);
+    for (int h = 0; h < nbHospitals; ++h) {
+        for (int k = h * clinicsByHospital; k < (h + 1) * clinicsByHospital; ++k) t.hospitalClinics[h].push_back(k);
+        // partage
+        for (int k = nbClinics - clinicsShared; k < nbClinics; ++k) t.hospitalClinics[h].push_back(k);
+    }
+    return t;
+}
+
+Topology makeRegionalTopology(int nbAmbulances, int nbSuppliers, int nbClinics, int nbHospitals,
+                              int regions, int fanOut, uint32_t seed) {
+    if (regions <= 0 || fanOut <= 0) throw std::invalid_argument("Topology: regions and fan-out must be positive");
+    if (regions > nbHospitals) throw std::invalid_argument("Topology: more regions than hospitals");
+
+    Topology t{nbAmbulances, nbSuppliers, nbClinics, nbHospitals, {}, {}, {}, {}};
+    t.ambulanceHospitals.resize(nbAmbulances);
+    t.hospitalClinics.resize(nbHospitals);
+    t.clinicHospitals.resize(nbClinics);
+    t.clinicSuppliers.resize(nbClinics);
+
+    // Un générateur par acteur : résultat identique quel que soit le découpage en threads
+    auto rng = [seed](int kind, int i) { return std::mt19937(seed ^ (static_cast<uint32_t>(kind) << 28) ^ static_cast<uint32_t>(i)); };
+
+    parallelFor(nbAmbulances, [&](int a) {
+        int r = regionOf(nbAmbulances, regions, a);
+        int begin = regionStart(nbHospitals, regions, r), end = regionStart(nbHospitals, regions, r + 1);
+        auto gen = rng(0, a);
+        int first = begin + static_cast<int>(gen() % static_cast<uint32_t>(end - begin));
+        t.ambulanceHospitals[a] = window(begin, end, first, fanOut);
+    });
+
+    // Chaque clinique appartient à un hôpital de sa région (tour à tour), ce qui
+    // garantit qu'elle reçoit des patients
+    std::vector<int> homeHospital(nbClinics);
+    parallelFor(nbClinics, [&](int c) {
+        int r = regionOf(nbClinics, regions, c);
+        int begin = regionStart(nbHospitals, regions, r), end = regionStart(nbHospitals, regions, r + 1);
+        int rank = c - regionStart(nbClinics, regions, r);
+        homeHospital[c] = begin + rank % (end - begin);
+
+        auto gen = rng(1, c);
+        int first = begin + static_cast<int>(gen() % static_cast<uint32_t>(end - begin));
+        t.clinicHospitals[c] = window(begin, end, first, fanOut);
+
+        // Fournisseurs consécutifs sans retour au début : les deux sortes de
+        // fournisseurs alternent (voir createSuppliers)
+        int nbPicked = std::min(std::max(2, fanOut), nbSuppliers);
+        int supplierFirst = regionStart(nbSuppliers, regions, r) + static_cast<int>(gen() % 2);
+        t.clinicSuppliers[c] = window(0, nbSuppliers, std::min(supplierFirst, nbSuppliers - nbPicked), nbPicked);
+    });
+
+    // Regroupement linéaire : comptage puis remplissage
+    std::vector<int> counts(nbHospitals, 0);
+    for (int c = 0; c < nbClinics; ++c) ++counts[homeHospital[c]];
+    for (int h = 0; h < nbHospitals; ++h) t.hospitalClinics[h].reserve(counts[h]);
+    for (int c = 0; c < nbClinics; ++c) t.hospitalClinics[homeHospital[c]].push_back(c);
+
+    return t;
+}
+
+void saveTopology(const std::string& path, const Topology& t) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) throw std::runtime_error("Topology: cannot write " + path);
+
+    out << "actors " << t.nbAmbulances << ' ' << t.nbSuppliers << ' ' << t.nbClinics << ' ' << t.nbHospitals << '\n';
+    auto write = [&](const char* kind, const std::vector<std::vector<int>>& lists) {
+        for (size_t i = 0; i < lists.size(); ++i) {
+            out << kind << ' ' << i;
+            for (int target : lists[i]) out << ' ' << target;
+            out << '\n';
+        }
+    };
+    write(KIND_AMBULANCE, t.ambulanceHospitals);
+    write(KIND_HOSPITAL, t.hospitalClinics);
+    write(KIND_CLINIC_H, t.clinicHospitals);
+    write(KIND_CLINIC_S, t.clinicSuppliers);
+}
+
+Topology loadTopology(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Topology: cannot read " + path);
+
+    Topology t;
+    std::string line;
+    int lineNo = 0;
+    bool header = false;
+    auto fail = [&](const std::string& why) {
+        throw std::runtime_error("Topology: " + path + ":" + std::to_string(lineNo) + ": " + why);
+    };
+
+    while (std::getline(in, line)) {
+        ++lineNo;
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream ss(line);
+        std::string kind;
+        ss >> kind;
+
+        if (kind == "actors") {
+            if (!(ss >> t.nbAmbulances >> t.nbSuppliers >> t.nbClinics >> t.nbHospitals)
+                || t.nbAmbulances < 0 || t.nbSuppliers < 0 || t.nbClinics < 0 || t.nbHospitals < 0) {
+                fail("bad actor counts");
+            }
+            t.ambulanceHospitals.assign(t.nbAmbulances, {});
+            t.hospitalClinics.assign(t.nbHospitals, {});
+            t.clinicHospitals.assign(t.nbClinics, {});
+            t.clinicSuppliers.assign(t.nbClinics, {});
+            header = true;
+            continue;
+        }
+        if (!header) fail("missing 'actors' header");
+
+        std::vector<std::vector<int>>* lists = nullptr;
+        int targets = 0;
+        if (kind == KIND_AMBULANCE)     { lists = &t.ambulanceHospitals; targets = t.nbHospitals; }
+        else if (kind == KIND_HOSPITAL) { lists = &t.hospitalClinics;    targets = t.nbClinics; }
+        else if (kind == KIND_CLINIC_H) { lists = &t.clinicHospitals;    targets = t.nbHospitals; }
+        else if (kind == KIND_CLINIC_S) { lists = &t.clinicSuppliers;    targets = t.nbSuppliers; }
+        else fail("unknown kind '" + kind + "'");
+
+        int index;
+        if (!(ss >> index) || index < 0 || index >= static_cast<int>(lists->size())) fail("bad actor index");
+        for (int target; ss >> target;) {
+            if (target < 0 || target >= targets) fail("link to unknown actor " + std::to_string(target));
+            (*lists)[index].push_back(target);
+        }
+        if (!ss.eof()) fail("bad link");
+    }
+    if (!header) fail("empty file");
+    if (int a = ambulanceWithoutHospital(t); a >= 0) {
+        throw std::runtime_error("Topology: " + path + ": ambulance " + std::to_string(a) + " has no hospital");
+    }
+    return t;
+}
+
+Topology makeTopology(const std::string& description, int nbAmbulances, int nbSuppliers,
+                      int nbClinics, int nbHospitals) {
+    if (description.empty() || description == "all-to-all") {
+        return makeAllToAllTopology(nbAmbulances, nbSuppliers, nbClinics, nbHospitals);
+    }
+    if (description.rfind("regional:", 0) == 0) {
+        std::vector<long> parts;
+        std::stringstream ss(description.substr(9));
+        for (std::string part; std::getline(ss, part, ':');) {
+            try {
+                parts.push_back(std::stol(part));
+            } catch (const std::exception&) {
+                throw std::invalid_argument("Bad topology: " + description);
+            }
+        }
+        if (parts.size() < 2 || parts.size() > 3) throw std::invalid_argument("Bad topology: " + description);
+        return makeRegionalTopology(nbAmbulances, nbSuppliers, nbClinics, nbHospitals,
+                                    static_cast<int>(parts[0]), static_cast<int>(parts[1]),
+                                    parts.size() == 3 ? static_cast<uint32_t>(parts[2]) : 1u);
+    }
+    return loadTopology(description);
+}
+
+void applyTopology(const Topology& t,
+                   const std::vector<Ambulance*>& ambulances, const std::vector<Supplier*>& suppliers,
+                   const std::vector<Clinic*>& clinics, const std::vector<Hospital*>& hospitals) {
+    if (static_cast<int>(ambulances.size()) != t.nbAmbulances || static_cast<int>(suppliers.size()) != t.nbSuppliers
+        || static_cast<int>(clinics.size()) != t.nbClinics || static_cast<int>(hospitals.size()) != t.nbHospitals) {
+        throw std::runtime_error("Topology: actor counts do not match");
+    }
+
+    // Une ambulance doit pouvoir déposer ses patients quelque part
+    if (int a = ambulanceWithoutHospital(t); a >= 0) {
+        throw std::runtime_error("Topology: ambulance " + std::to_string(a) + " has no hospital");
+    }
+
+    // Une clinique doit pouvoir acheter chacune de ses ressources
+    for (int c = 0; c < t.nbClinics; ++c) {
+        for (auto item : clinics[c]->getResourcesNeeded()) {
+            bool sold = std::any_of(t.clinicSuppliers[c].begin(), t.clinicSuppliers[c].end(),
+                                    [&](int s) { return suppliers[s]->sellsResource(item); });
+            if (!sold) throw std::runtime_error("Topology: clinic " + std::to_string(c) + " has no supplier for a resource");
+        }
+    }
+
+    parallelFor(t.nbAmbulances, [&](int a) { ambulances[a]->setHospitals(pick(hospitals, t.ambulanceHospitals[a])); });
+    parallelFor(t.nbHospitals, [&](int h) { hospitals[h]->setClinics(pick(clinics, t.hospitalClinics[h])); });
+    parallelFor(t.nbClinics, [&](int c) {
+        clinics[c]->setHospitalsAndSuppliers(pick(hospitals, t.clinicHospitals[c]), pick(suppliers, t.clinicSuppliers[c]));
+    });
+}
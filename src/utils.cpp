@@ -1,5 +1,29 @@
 #include "utils.h"
 
+#include <algorithm>
+#include <thread>
+
+/// Plus petit nombre d'acteurs construits par un même thread
+static const int MIN_ACTORS_PER_THREAD = 1024;
+
+void parallelFor(int n, const std::function<void(int)>& fn, int minChunk) {
+    int nbWorkers = std::max(1, std::min(static_cast<int>(std::thread::hardware_concurrency()), n / minChunk));
+    if (nbWorkers == 1) {
+        for (int i = 0; i < n; ++i) fn(i);
+        return;
+    }
+
+    std::vector<std::unique_ptr<PcoThread>> workers;
+    for (int w = 0; w < nbWorkers; ++w) {
+        int begin = static_cast<int>(static_cast<long long>(n) * w / nbWorkers);
+        int end   = static_cast<int>(static_cast<long long>(n) * (w + 1) / nbWorkers);
+        workers.emplace_back(std::make_unique<PcoThread>([&fn, begin, end] {
+            for (int i = begin; i < end; ++i) fn(i);
+        }));
+    }
+    for (auto& w : workers) w->join();
+}
+
 void endService(const std::vector<std::unique_ptr<PcoThread> > &threads) {
     std::cout << "It's time to end !" << std::endl;
 	for (const auto &t : threads) t->requestStop();
@@ -11,25 +35,20 @@ std::vector<Ambulance*> createAmbulances(int nbAmbulances, int idStart){
         exit(-1);
     }
 
-    std::vector<Ambulance*> ambulances;
+    // Seul un indice sur trois reçoit une ambulance
+    std::vector<Ambulance*> ambulances((nbAmbulances + 2) / 3);
 
-    for(int i = 0; i < nbAmbulances; ++i){
-        switch(i % 3) {
+    parallelFor(static_cast<int>(ambulances.size()), [&](int k) {
+        std::map<ItemType, int> initialAmbulanceStock = {{ItemType::SickPatient, INITIAL_PATIENT_SICK}};
+        std::vector<ItemType> patients = {ItemType::SickPatient};
 
-            case 0:{
-                std::map<ItemType, int> initialAmbulanceStock = {{ItemType::SickPatient, INITIAL_PATIENT_SICK}};
-                std::vector<ItemType> patients = {ItemType::SickPatient};
-
-                ambulances.push_back(new Ambulance(
-                    i + idStart,
-                    SUPPLIER_FUND,
-                    patients,
-                    initialAmbulanceStock
-                ));
-                break;
-            }
-        }
-    }
+        ambulances[k] = new Ambulance(
+            3 * k + idStart,
+            SUPPLIER_FUND,
+            patients,
+            initialAmbulanceStock
+        );
+    }, MIN_ACTORS_PER_THREAD);
     return ambulances;
 }
 
@@ -39,20 +58,20 @@ std::vector<Supplier*> createSuppliers(int nbSuppliers, int idStart) {
         exit(-1);
     }
 
-    std::vector<Supplier*> suppliers;
+    std::vector<Supplier*> suppliers(nbSuppliers);
 
-    for(int i = 0; i < nbSuppliers; ++i){
+    parallelFor(nbSuppliers, [&](int i) {
         switch(i % 2) {
             case 0:{
-                suppliers.push_back(new MedicalDeviceSupplier(i + idStart, SUPPLIER_FUND));
+                suppliers[i] = new MedicalDeviceSupplier(i + idStart, SUPPLIER_FUND);
                 break;
             }
             case 1:{
-                suppliers.push_back(new Pharmacy(i + idStart, SUPPLIER_FUND));
+                suppliers[i] = new Pharmacy(i + idStart, SUPPLIER_FUND);
                 break;
             }
         }
-    }
+    }, MIN_ACTORS_PER_THREAD);
     return suppliers;
 }
 
@@ -62,24 +81,23 @@ std::vector<Clinic*> createClinics(int nbClinics, int idStart) {
         exit(-1);
     }
 
-    std::vector<Clinic*> clinics;
+    std::vector<Clinic*> clinics(nbClinics);
 
-    for(int i = 0; i < nbClinics; ++i) {
+    parallelFor(nbClinics, [&](int i) {
         switch(i % 3) {
             case 0:
-                clinics.push_back(new Pulmonology(i + idStart, CLINICS_FUND));
+                clinics[i] = new Pulmonology(i + idStart, CLINICS_FUND);
                 break;
 
             case 1:
-                clinics.push_back(new Cardiology(i + idStart, CLINICS_FUND));
+                clinics[i] = new Cardiology(i + idStart, CLINICS_FUND);
                 break;
 
             case 2:
-                clinics.push_back(new Neurology(i + idStart, CLINICS_FUND));
+                clinics[i] = new Neurology(i + idStart, CLINICS_FUND);
                 break;
         }
-    }
-
+    }, MIN_ACTORS_PER_THREAD);
 
     return clinics;
 }
@@ -89,11 +107,11 @@ std::vector<Hospital*> createHospitals(int nbHospital, int idStart) {
         std::cout << "Cannot launch the programm without any hospitalr";
         exit(-1);
     }
-    std::vector<Hospital*> hospitals;
+    std::vector<Hospital*> hospitals(nbHospital);
 
-    for(int i = 0; i < nbHospital; ++i){
-        hospitals.push_back(new Hospital(i + idStart, HOSPITALS_FUND, MAX_BEDS_PER_HOSTPITAL));
-    }
+    parallelFor(nbHospital, [&](int i) {
+        hospitals[i] = new Hospital(i + idStart, HOSPITALS_FUND, MAX_BEDS_PER_HOSTPITAL);
+    }, MIN_ACTORS_PER_THREAD);
 
     return hospitals;
 }
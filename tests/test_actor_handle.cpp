@@ -0,0 +1,99 @@
+// tests/test_actor_handle.cpp
+#include <gtest/gtest.h>
+#include <type_traits>
+#include "actor_handle.h"
+#include "ambulance.h"
+#include "clinic.h"
+#include "hospital.h"
+#include "insurance.h"
+#include "supplier.h"
+
+namespace {
+
+/// Acteur de test : ne passe que par l'interface virtuelle.
+class Receiver : public Seller {
+public:
+    Receiver() : Seller(0, 99) {}
+
+    int  transfer(ItemType, int qty) override { received += qty; return qty; }
+    int  buy(ItemType, int) override { return 0; }
+    void invoice(int, Seller*) override {}
+    void pay(int bill) override { money += bill; }
+
+    int received{0};
+};
+
+} // namespace
+
+// Seuls les types d'acteurs du handle sont acceptés ; les opérations qu'ils ne
+// supportent pas sont refusées à la compilation (static_assert dans le handle)
+static_assert(std::is_constructible_v<PatientReceiver, Hospital*>);
+static_assert(std::is_constructible_v<PatientReceiver, Pulmonology*>);
+static_assert(!std::is_constructible_v<PatientReceiver, Ambulance*>);
+static_assert(!std::is_constructible_v<PatientReceiver, Supplier*>);
+static_assert(!std::is_constructible_v<ResourceSeller, Clinic*>);
+static_assert(!ActorOps<Hospital>::buy && !ActorOps<Clinic>::invoice && !ActorOps<Insurance>::pay);
+
+TEST(ActorHandle, Resolve_ConcreteActors_AreCalledDirectly) {
+    Hospital hospital(1, 1000, 4);
+    Cardiology clinic(2, 1000);
+    Pharmacy supplier(3, 1000);
+    Insurance insurance(4, 1000);
+
+    EXPECT_FALSE(PatientReceiver::resolve(&hospital).isVirtual());
+    EXPECT_FALSE(PatientReceiver::resolve(&clinic).isVirtual());
+    EXPECT_FALSE(ResourceSeller::resolve(&supplier).isVirtual());
+    EXPECT_FALSE(InsuranceHandle::resolve(&insurance).isVirtual());
+
+    // Un acteur d'un autre type garde l'interface virtuelle
+    EXPECT_TRUE(PatientReceiver::resolve(&supplier).isVirtual());
+    EXPECT_EQ(PatientReceiver::resolve(&clinic).get(), &clinic);
+}
+
+TEST(ActorHandle, As_GivesTheTypedActorOnly) {
+    Pharmacy supplier(3, 1000);
+    Receiver mock;
+
+    EXPECT_EQ(ResourceSeller::resolve(&supplier).as<Supplier>(), &supplier);
+    EXPECT_EQ(ResourceSeller::resolve(&mock).as<Supplier>(), nullptr);
+    EXPECT_EQ(ResourceSeller().as<Supplier>(), nullptr);
+}
+
+TEST(ActorHandle, ChooseRandomIndex_EmptyList_ReturnsSentinel) {
+    Receiver mock;
+    EXPECT_EQ(mock.chooseRandomIndex(0), Seller::NO_INDEX);
+    for (int i = 0; i < 100; ++i) EXPECT_LT(mock.chooseRandomIndex(3), 3u);
+}
+
+TEST(ActorHandle, Resolve_Mock_KeepsVirtualInterface) {
+    Receiver mock;
+    auto handle = PatientReceiver::resolve(&mock);
+
+    EXPECT_TRUE(handle.isVirtual());
+    EXPECT_EQ(handle.transfer(ItemType::SickPatient, 3), 3);
+    EXPECT_EQ(mock.received, 3);
+}
+
+TEST(ActorHandle, Transfer_ReachesHospital) {
+    Hospital hospital(1, 1000, 4);
+    PatientReceiver handle(&hospital);
+
+    EXPECT_EQ(handle.transfer(ItemType::SickPatient, 3), 3);
+    EXPECT_EQ(handle.transfer(ItemType::SickPatient, 3), 1);
+    EXPECT_EQ(hospital.getNumberPatients(), 4);
+}
+
+TEST(ActorHandle, Invoice_ReachesInsurance) {
+    Insurance insurance(4, 0);
+    Receiver beneficiary;
+    InsuranceHandle handle(&insurance);
+
+    handle.invoice(25, &beneficiary);
+    EXPECT_EQ(insurance.getUnpaidAmount(), 25);
+}
+
+TEST(ActorHandle, Default_IsEmpty) {
+    PatientReceiver handle;
+    EXPECT_FALSE(handle);
+    EXPECT_TRUE(handle.isVirtual());
+}
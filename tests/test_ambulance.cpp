@@ -5,6 +5,7 @@
 #include <memory>
 #include <vector>
 #include "ambulance.h"
+#include "hospital.h"
 #include "seller.h"
 #include "costs.h"
 
@@ -145,6 +146,57 @@ TEST_F(AmbulanceFixture, SendPatients_Fails_When_NotEnoughMoneyForSalary) {
     EXPECT_EQ(hosp->getAdmitted(), 0);
 }
 
+TEST_F(AmbulanceFixture, SendPatients_NoMoneyForSalary_GivesReservedBedsBack) {
+    Hospital real(22, 1'000, /*maxBeds*/10);
+    TestableAmbulance a(13, /*fund*/0, {ItemType::SickPatient}, {{ItemType::SickPatient, 5}});
+    a.setHospitals({&real});
+    a.setInsurance(ins.get());
+
+    a.sendPatients();
+
+    EXPECT_EQ(real.getFreeCapacity(), 10);
+    EXPECT_EQ(real.getNumberPatients(), 0);
+    EXPECT_EQ(a.getNumberPatients(), 5);
+}
+
+TEST_F(AmbulanceFixture, SendPatients_ByFreeCapacity_SkipsFullHospitals) {
+    Hospital full(20, 1'000, /*maxBeds*/0);
+    Hospital free(21, 1'000, /*maxBeds*/100);
+    TestableAmbulance a(12, 10'000, {ItemType::SickPatient}, {{ItemType::SickPatient, 40}});
+    a.setHospitals({&full, &free});
+    a.setInsurance(ins.get());
+
+    long long rejectedBefore = population().rejected();
+    int daysWithPatients = 0;
+    for (int day = 0; day < 10; ++day) {
+        daysWithPatients += a.getNumberPatients() > 0;
+        a.sendPatients();
+    }
+
+    EXPECT_EQ(population().rejected(), rejectedBefore);
+    EXPECT_EQ(free.getNumberPatients(), 40 - a.getNumberPatients());
+    // Un seul trajet par jour : un seul hôpital a de la place
+    EXPECT_EQ(a.getTransferCalls(), daysWithPatients);
+}
+
+TEST_F(AmbulanceFixture, SendPatients_AllHospitalsFull_NoTripNoSalary) {
+    Hospital full(20, 1'000, /*maxBeds*/0);
+    TestableAmbulance a(13, 10'000, {ItemType::SickPatient}, {{ItemType::SickPatient, 5}});
+    a.setHospitals({&full});
+    a.setInsurance(ins.get());
+
+    a.sendPatients();
+    EXPECT_EQ(a.getTransferCalls(), 0);
+    EXPECT_EQ(a.getFund(), 10'000);
+
+    // Au hasard, le trajet est fait (et payé) pour rien
+    a.setDispatchMode(DispatchMode::Random);
+    a.sendPatients();
+    EXPECT_EQ(a.getTransferCalls(), 1);
+    EXPECT_EQ(a.getNumberPatients(), 5);
+    EXPECT_LT(a.getFund(), 10'000);
+}
+
 TEST_F(AmbulanceFixture, PaySuccess) {
     const int startFund = amb->getFund();
 
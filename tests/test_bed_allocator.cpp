@@ -0,0 +1,93 @@
+// tests/test_bed_allocator.cpp
+#include <gtest/gtest.h>
+#include <pcosynchro/pcothread.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "bed_allocator.h"
+
+TEST(BedAllocator, ClaimsUpToFreeBeds) {
+    BedAllocator beds(5, 4);
+    EXPECT_EQ(beds.claim(3), 3);
+    EXPECT_EQ(beds.claim(3), 2);
+    EXPECT_EQ(beds.claim(1), 0);
+    EXPECT_EQ(beds.available(), 0);
+    EXPECT_EQ(beds.claim(0), 0);
+}
+
+TEST(BedAllocator, ReleasedBedsCanBeClaimedAgain) {
+    BedAllocator beds(10, 2);
+    EXPECT_EQ(beds.claim(10), 10);
+    beds.release(4);
+    EXPECT_EQ(beds.available(), 4);
+    EXPECT_EQ(beds.claim(6), 4);
+    beds.release(-1);
+    EXPECT_EQ(beds.available(), 0);
+}
+
+TEST(BedAllocator, SlabsClampedToBeds) {
+    EXPECT_EQ(BedAllocator(3, 16).getSlabCount(), 3);
+    EXPECT_EQ(BedAllocator(0, 16).getSlabCount(), 1);
+    EXPECT_EQ(BedAllocator(40, 0).getSlabCount(), 1);
+    EXPECT_GE(BedAllocator::defaultSlabCount(), 1);
+}
+
+TEST(BedAllocator, Reset_EmptiesSlabs) {
+    BedAllocator beds(8, 4);
+    beds.claim(8);
+    beds.release(3);
+    beds.reset(6);
+    EXPECT_EQ(beds.available(), 6);
+    EXPECT_EQ(beds.claim(8), 6);
+}
+
+TEST(BedAllocator, ConcurrentClaimsAndReleases_KeepEveryBed) {
+    const int BEDS = 40;
+    BedAllocator beds(BEDS, 8);
+    std::atomic<int> held{0};
+    std::atomic<int> maxHeld{0};
+
+    std::vector<std::unique_ptr<PcoThread>> ts;
+    for (int i = 0; i < 8; ++i) {
+        ts.emplace_back(std::make_unique<PcoThread>([&, i]() {
+            for (int k = 0; k < 20'000; ++k) {
+                int got = beds.claim(1 + (i + k) % 4);
+                int now = held.fetch_add(got) + got;
+                int seen = maxHeld.load();
+                while (now > seen && !maxHeld.compare_exchange_weak(seen, now)) {}
+                held.fetch_sub(got);
+                beds.release(got);
+            }
+        }));
+    }
+    for (auto& t : ts) t->join();
+
+    // Jamais plus de lits occupés qu'il n'y en a, et tous reviennent à la fin
+    EXPECT_LE(maxHeld.load(), BEDS);
+    EXPECT_EQ(beds.available(), BEDS);
+    EXPECT_EQ(beds.claim(BEDS + 1), BEDS);
+}
+
+TEST(BedAllocator, ConcurrentClaimsAtCapacity_NeverComeUpShort) {
+    // Autant de lits que la demande totale : un refus ne peut venir que de lits en transit
+    const int THREADS = 8;
+    const int PER_THREAD = 5;
+    BedAllocator beds(THREADS * PER_THREAD, THREADS);
+    std::atomic<int> shortClaims{0};
+
+    std::vector<std::unique_ptr<PcoThread>> ts;
+    for (int i = 0; i < THREADS; ++i) {
+        ts.emplace_back(std::make_unique<PcoThread>([&, i]() {
+            for (int k = 0; k < 20'000; ++k) {
+                int qty = 1 + (i + k) % PER_THREAD;
+                int got = beds.claim(qty);
+                if (got != qty) shortClaims.fetch_add(1);
+                beds.release(got);
+            }
+        }));
+    }
+    for (auto& t : ts) t->join();
+
+    EXPECT_EQ(shortClaims.load(), 0);
+    EXPECT_EQ(beds.available(), THREADS * PER_THREAD);
+}
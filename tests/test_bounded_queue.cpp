@@ -0,0 +1,63 @@
+// tests/test_bounded_queue.cpp
+#include <gtest/gtest.h>
+#include <pcosynchro/pcothread.h>
+#include <memory>
+#include <vector>
+
+#include "bounded_queue.h"
+
+TEST(BoundedQueue, FifoAndBoundedCapacity) {
+    BoundedQueue<int> q(3);
+    EXPECT_EQ(q.capacity(), 4u);
+
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(q.tryPush(i));
+    EXPECT_FALSE(q.tryPush(4));
+
+    int v = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(q.tryPop(v));
+        EXPECT_EQ(v, i);
+    }
+    EXPECT_FALSE(q.tryPop(v));
+
+    // Le tampon tourne : on peut le remplir à nouveau
+    EXPECT_TRUE(q.tryPush(7));
+    ASSERT_TRUE(q.tryPop(v));
+    EXPECT_EQ(v, 7);
+}
+
+TEST(BoundedQueue, ConcurrentProducersSingleConsumer_NothingLost) {
+    BoundedQueue<int> q(64);
+    const int P = 4;
+    const int N = 20000;
+
+    std::vector<std::unique_ptr<PcoThread>> producers;
+    for (int p = 0; p < P; ++p) {
+        producers.emplace_back(std::make_unique<PcoThread>([&q, p]() {
+            for (int k = 0; k < N; ++k) {
+                while (!q.tryPush(p * N + k)) {}
+            }
+        }));
+    }
+
+    std::vector<int> lastSeen(P, -1);
+    long long sum = 0;
+    int received = 0;
+    bool ordered = true;
+    while (received < P * N) {
+        int v;
+        if (!q.tryPop(v)) continue;
+        int p = v / N;
+        int k = v % N;
+        // Chaque producteur reste dans l'ordre
+        if (k <= lastSeen[p]) ordered = false;
+        lastSeen[p] = k;
+        sum += v;
+        ++received;
+    }
+    for (auto& t : producers) t->join();
+
+    long long total = static_cast<long long>(P) * N;
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(sum, total * (total - 1) / 2);
+}
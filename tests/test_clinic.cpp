@@ -21,6 +21,9 @@ public:
     using Clinic::sendPatientsToRehab;
     using Clinic::orderResources;
     using Clinic::treatOne;
+    using Clinic::treatPatients;
+    using Clinic::processNextPatient;
+    using Clinic::drainArrivals;
     using Seller::stocks;
     using Seller::money;
     using Clinic::nbEmployeesPaid;
@@ -40,6 +43,21 @@ public:
     int employeesPaid() const { return nbEmployeesPaid; }
 };
 
+/// Clinique dont les ressources sont fixées à la compilation.
+class TestablePulmonology : public Pulmonology {
+public:
+    TestablePulmonology(int id, int fund) : Pulmonology(id, fund) {}
+
+    using Clinic::treatPatients;
+    using Clinic::treatableWithStock;
+    using Clinic::orderResources;
+    using Clinic::getResourceStock;
+    using Clinic::setResourceStock;
+    using Clinic::getPurchaseCalls;
+    using Seller::stocks;
+    using Seller::money;
+};
+
 // ---------- Doubles de test ----------
 
 class RehabHospital : public Seller {
@@ -82,15 +100,12 @@ public:
     TestSupplier(int id, int fund, std::vector<ItemType> catalog)
         : Supplier(id, fund, std::move(catalog)) {}
 
-    using Seller::stocks;
     using Seller::money;
     using Seller::nbEmployeesPaid;
 
-    void setStock(ItemType it, int qty) { stocks[it] = qty; }
-    int getStock(ItemType it) const {
-        auto itf = stocks.find(it);
-        return itf == stocks.end() ? 0 : itf->second;
-    }
+    using Supplier::getStock;
+    void setStock(ItemType it, int qty) { stockOf(it).store(qty); }
+    int getStock(ItemType it) const { return getAvailable(it); }
     int getFund() const { return money; }
 };
 
@@ -142,6 +157,37 @@ TEST_F(ClinicFixture, OrderResources_BuysMissing_OnNoStock) {
     EXPECT_EQ(supB->getStock(ItemType::Thermometer), 9);
 }
 
+TEST_F(ClinicFixture, OrderResources_NoSupplierForItem_SkipsIt) {
+    // Seul le fournisseur de Pill est câblé : pas de commande de Thermometer
+    TestableClinic partial(98, /*fund*/1'000, {ItemType::Pill, ItemType::Thermometer});
+    partial.setHospitalsAndSuppliers({hosp.get()}, {supA.get()});
+
+    partial.orderResources();
+
+    EXPECT_EQ(partial.stocks[ItemType::Pill], 1);
+    EXPECT_EQ(partial.stocks[ItemType::Thermometer], 0);
+    EXPECT_EQ(partial.unpaidBills.size(), 1u);
+}
+
+TEST_F(ClinicFixture, OrderResources_OneBuyPerItem_SizedBySupplierStock) {
+    // 5 patients en attente, mais le fournisseur de Pill n'en a que 2
+    clinic->setTreatmentCapacity(5);
+    clinic->setPatients(5);
+    supA->setStock(ItemType::Pill, 2);
+
+    clinic->orderResources();
+
+    EXPECT_EQ(clinic->getPurchaseCalls(), 2);
+    EXPECT_EQ(clinic->stocks[ItemType::Pill], 2);
+    EXPECT_EQ(supA->getStock(ItemType::Pill), 0);
+    EXPECT_EQ(clinic->stocks[ItemType::Thermometer], 5);
+}
+
+TEST_F(ClinicFixture, SetSuppliers_RejectsNonSuppliers) {
+    TestableClinic other(97, /*fund*/1'000, {ItemType::Pill});
+    EXPECT_THROW(other.setHospitalsAndSuppliers({hosp.get()}, {hosp.get()}), std::invalid_argument);
+}
+
 TEST_F(ClinicFixture, HasResourcesThenTreatOne_ConsumesResourcesAndMovesPatientToRehab) {
     const int salary = getEmployeeSalary(EmployeeType::TreatmentSpecialist);
     clinic->setFunds(salary * 10);
@@ -158,6 +204,91 @@ TEST_F(ClinicFixture, HasResourcesThenTreatOne_ConsumesResourcesAndMovesPatientT
     EXPECT_EQ(clinic->employeesPaid(), 1);
 }
 
+TEST_F(ClinicFixture, TreatPatients_BatchLimitedByStockAndFunds) {
+    const int salary = getEmployeeSalary(EmployeeType::TreatmentSpecialist);
+    clinic->setFunds(salary * 3);
+    clinic->setPatients(/*sick*/6, /*rehab*/0);
+    clinic->setResource(ItemType::Pill, 5);
+    clinic->setResource(ItemType::Thermometer, 4);
+
+    // Les fonds ne paient que 3 spécialistes
+    EXPECT_EQ(clinic->treatPatients(10), 3);
+    EXPECT_EQ(clinic->stocks[ItemType::SickPatient], 3);
+    EXPECT_EQ(clinic->stocks[ItemType::RehabPatient], 3);
+    EXPECT_EQ(clinic->stocks[ItemType::Pill], 2);
+    EXPECT_EQ(clinic->stocks[ItemType::Thermometer], 1);
+    EXPECT_EQ(clinic->money, 0);
+    EXPECT_EQ(clinic->employeesPaid(), 3);
+
+    // Puis le stock de thermomètres
+    clinic->setFunds(salary * 10);
+    EXPECT_EQ(clinic->treatPatients(10), 1);
+    EXPECT_EQ(clinic->stocks[ItemType::SickPatient], 2);
+}
+
+TEST_F(ClinicFixture, TreatPatients_CompileTimeResources_MatchRuntimeVector) {
+    const int salary = getEmployeeSalary(EmployeeType::TreatmentSpecialist);
+    TestablePulmonology typed(7, salary * 3);
+    EXPECT_EQ(typed.getResourcesNeeded(), (std::vector<ItemType>{ItemType::Pill, ItemType::Thermometer}));
+
+    clinic->setFunds(salary * 3);
+    clinic->setPatients(6);
+    clinic->setResource(ItemType::Pill, 5);
+    clinic->setResource(ItemType::Thermometer, 4);
+    typed.stocks[ItemType::SickPatient] = 6;
+    typed.setResourceStock(ItemType::Pill, 5);
+    typed.setResourceStock(ItemType::Thermometer, 4);
+    EXPECT_EQ(typed.treatableWithStock(), 4);
+
+    // Le stock des ressources n'est pas dans la map de la clinique spécialisée
+    EXPECT_EQ(typed.stocks.count(ItemType::Pill), 0u);
+
+    EXPECT_EQ(typed.treatPatients(10), clinic->treatPatients(10));
+    EXPECT_EQ(typed.getStock(), clinic->getStock());
+    EXPECT_EQ(typed.money, clinic->money);
+
+    // Les ressources sont lues à chaque appel : un réassort est vu tout de suite
+    typed.money = salary * 10;
+    typed.setResourceStock(ItemType::Thermometer, 0);
+    EXPECT_EQ(typed.treatPatients(10), 0);
+    typed.setResourceStock(ItemType::Thermometer, 2);
+    EXPECT_EQ(typed.treatPatients(10), 2);
+    EXPECT_EQ(typed.getResourceStock(ItemType::Pill), 0);
+}
+
+TEST_F(ClinicFixture, OrderResources_CompileTimeResources_FillTheirArray) {
+    TestablePulmonology typed(8, 1'000);
+    typed.setHospitalsAndSuppliers({hosp.get()}, {supA.get(), supB.get()});
+    typed.stocks[ItemType::SickPatient] = 1;
+
+    typed.orderResources();
+
+    EXPECT_EQ(typed.getPurchaseCalls(), 2);
+    EXPECT_EQ(typed.getResourceStock(ItemType::Pill), 1);
+    EXPECT_EQ(typed.getResourceStock(ItemType::Thermometer), 1);
+    EXPECT_EQ(typed.getStock()[ItemType::Pill], 1);
+    EXPECT_EQ(supA->getStock(ItemType::Pill), 9);
+    EXPECT_EQ(typed.stocks.count(ItemType::Pill), 0u);
+}
+
+TEST_F(ClinicFixture, ProcessNextPatient_OrdersAndTreatsWholeBatch) {
+    const int salary = getEmployeeSalary(EmployeeType::TreatmentSpecialist);
+    clinic->setFunds(salary * 10);
+    clinic->setTreatmentCapacity(4);
+    clinic->setPatients(/*sick*/5, /*rehab*/0);
+    clinic->setResource(ItemType::Pill, 1);
+    clinic->setResource(ItemType::Thermometer, 0);
+
+    clinic->processNextPatient();
+
+    EXPECT_EQ(clinic->stocks[ItemType::RehabPatient], 4);
+    EXPECT_EQ(clinic->stocks[ItemType::SickPatient], 1);
+    // Une seule commande par ressource pour tout le lot
+    EXPECT_EQ(clinic->unpaidBills.size(), 2u);
+    EXPECT_EQ(supA->getStock(ItemType::Pill), 7);
+    EXPECT_EQ(supB->getStock(ItemType::Thermometer), 6);
+}
+
 TEST_F(ClinicFixture, TreatOne_Fails_WithoutMoney) {
     clinic->setFunds(0);
     clinic->setPatients(1, 0);
@@ -191,6 +322,10 @@ TEST_F(ClinicFixture, Transfer_AcceptsSickPatientsOnly_AndOnlyIfNoDebtAndNoUnpai
     clinic->setFunds(1);
     int got = clinic->transfer(ItemType::SickPatient, 3);
     EXPECT_EQ(got, 3);
+    EXPECT_EQ(clinic->getWaitingPatients(), 3);
+
+    // Les patients restent en file jusqu'au prochain traitement
+    clinic->drainArrivals();
     EXPECT_EQ(clinic->stocks[ItemType::SickPatient], 3);
 
     EXPECT_EQ(clinic->transfer(ItemType::Pill, 2), 0);
@@ -206,6 +341,17 @@ TEST_F(ClinicFixture, Transfer_AcceptsSickPatientsOnly_AndOnlyIfNoDebtAndNoUnpai
     EXPECT_EQ(poor.transfer(ItemType::SickPatient, 5), 0);
 }
 
+TEST_F(ClinicFixture, Transfer_FullQueue_AppliesBackpressureUntilDrained) {
+    EXPECT_EQ(clinic->transfer(ItemType::SickPatient, CLINIC_QUEUE_CAPACITY - 2), CLINIC_QUEUE_CAPACITY - 2);
+    EXPECT_EQ(clinic->transfer(ItemType::SickPatient, 5), 2);
+    EXPECT_EQ(clinic->transfer(ItemType::SickPatient, 1), 0);
+
+    clinic->drainArrivals();
+    EXPECT_EQ(clinic->stocks[ItemType::SickPatient], CLINIC_QUEUE_CAPACITY);
+    EXPECT_EQ(clinic->transfer(ItemType::SickPatient, 1), 1);
+    EXPECT_EQ(clinic->getWaitingPatients(), CLINIC_QUEUE_CAPACITY + 1);
+}
+
 TEST_F(ClinicFixture, PayBills_PaysWhenFundsSufficient) {
     // Force des factures (manque les 2 ressources)
     clinic->setResource(ItemType::Pill, 0);
@@ -0,0 +1,147 @@
+// tests/test_day_clock.cpp
+#include <gtest/gtest.h>
+#include <pcosynchro/pcothread.h>
+#include <atomic>
+#include <memory>
+#include <set>
+#include <vector>
+#include "day_clock.h"
+#include "seller.h"
+#include "time_warp.h"
+
+namespace {
+
+/// Acteur minimal qui a du travail aux jours donnés et note les jours exécutés.
+class Sleeper : public Seller {
+public:
+    Sleeper(int id, std::set<int> workDays) : Seller(0, id), workDays(std::move(workDays)) {}
+
+    int  transfer(ItemType, int) override { return 0; }
+    int  buy(ItemType, int) override { return 0; }
+    void invoice(int, Seller*) override {}
+    void pay(int) override {}
+
+    int nextWorkDay(int today) override {
+        auto it = workDays.lower_bound(today);
+        return it == workDays.end() ? NO_WORK_DAY : *it;
+    }
+
+    void run() {
+        while (true) {
+            clock->worker_wait_day_start(this);
+            if (PcoThread::thisThread()->stopRequested()) break;
+            daysRun.push_back(clock->current_day());
+            clock->worker_end_day();
+        }
+    }
+
+    std::vector<int> daysRun;
+
+private:
+    std::set<int> workDays;
+};
+
+} // namespace
+
+TEST(DayClock, EveryWorkerRunsEachDayExactlyOnce) {
+    const int nbWorkers = 8;
+    const int nbDays = 300;
+    DayClock clock(nbWorkers);
+    std::vector<std::atomic<int>> runs(nbWorkers);
+
+    std::vector<std::unique_ptr<PcoThread>> threads;
+    for (int w = 0; w < nbWorkers; ++w) {
+        threads.emplace_back(std::make_unique<PcoThread>([&clock, &runs, w] {
+            while (true) {
+                clock.worker_wait_day_start();
+                if (PcoThread::thisThread()->stopRequested()) break;
+                runs[w].fetch_add(1);
+                clock.worker_end_day();
+            }
+        }));
+    }
+
+    // Un thread rapide ne doit jamais exécuter la journée d'un thread lent
+    for (int d = 0; d < nbDays; ++d) {
+        clock.start_next_day();
+        clock.wait_all_done();
+        for (int w = 0; w < nbWorkers; ++w) ASSERT_EQ(runs[w].load(), d + 1) << "worker " << w << " day " << d;
+    }
+    EXPECT_EQ(clock.current_day(), nbDays);
+
+    for (auto& t : threads) t->requestStop();
+    clock.release_workers();
+    for (auto& t : threads) t->join();
+    // Chaque fin de journée d'un worker est une attente à la barrière
+    EXPECT_EQ(clock.getBarrierWaits().count(), static_cast<uint64_t>(nbWorkers * nbDays));
+}
+
+TEST(TimeWarpClock, RunsOnlyDaysWithWork_AndWakesEveryoneOnLastDay) {
+    Sleeper early(1, {3, 10});
+    Sleeper late(2, {10});
+    Sleeper idle(3, {});
+    std::vector<Seller*> actors = {&early, &late, &idle};
+
+    const int lastDay = 20;
+    TimeWarpClock clock(actors, lastDay);
+    for (auto* a : actors) a->setClock(&clock);
+
+    std::vector<std::unique_ptr<PcoThread>> threads;
+    threads.emplace_back(std::make_unique<PcoThread>(&Sleeper::run, &early));
+    threads.emplace_back(std::make_unique<PcoThread>(&Sleeper::run, &late));
+    threads.emplace_back(std::make_unique<PcoThread>(&Sleeper::run, &idle));
+
+    std::vector<int> started;
+    while (clock.current_day() < lastDay) {
+        started.push_back(clock.skip_to_next_work_day());
+        clock.start_next_day();
+        clock.wait_all_done();
+    }
+
+    for (auto& t : threads) t->requestStop();
+    clock.release_workers();
+    for (auto& t : threads) t->join();
+
+    EXPECT_EQ(started, (std::vector<int>{3, 10, 19}));
+    EXPECT_EQ(early.daysRun, (std::vector<int>{3, 10, 19}));
+    EXPECT_EQ(late.daysRun, (std::vector<int>{10, 19}));
+    EXPECT_EQ(idle.daysRun, (std::vector<int>{19}));
+    EXPECT_EQ(clock.getDaysRun(), 3);
+    EXPECT_EQ(clock.current_day(), lastDay);
+    // 20 jours x 3 acteurs, moins les 6 réveils
+    EXPECT_EQ(clock.getIdleActorDays(), 20 * 3 - 6);
+}
+
+TEST(DayClock, PhaseBarrier_SeparatesPhasesOfADay) {
+    const int nbWorkers = 6;
+    const int nbDays = 50;
+    DayClock clock(nbWorkers);
+    std::atomic<int> applied{0};
+    std::atomic<int> errors{0};
+
+    std::vector<std::unique_ptr<PcoThread>> threads;
+    for (int w = 0; w < nbWorkers; ++w) {
+        threads.emplace_back(std::make_unique<PcoThread>([&] {
+            while (true) {
+                clock.worker_wait_day_start();
+                if (PcoThread::thisThread()->stopRequested()) break;
+                applied.fetch_add(1);
+                clock.worker_phase_barrier();
+                // Personne ne décide avant que tous aient appliqué
+                if (applied.load() != (clock.current_day() + 1) * nbWorkers) errors.fetch_add(1);
+                clock.worker_end_day();
+            }
+        }));
+    }
+
+    for (int d = 0; d < nbDays; ++d) {
+        clock.start_next_day();
+        clock.wait_all_done();
+    }
+    for (auto& t : threads) t->requestStop();
+    clock.release_workers();
+    for (auto& t : threads) t->join();
+
+    EXPECT_EQ(applied.load(), nbDays * nbWorkers);
+    EXPECT_EQ(errors.load(), 0);
+}
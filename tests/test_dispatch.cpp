@@ -0,0 +1,74 @@
+// tests/test_dispatch.cpp
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+#include "dispatch.h"
+
+namespace {
+
+int planned(const std::vector<Trip>& trips) {
+    int total = 0;
+    for (const auto& trip : trips) total += trip.qty;
+    return total;
+}
+
+} // namespace
+
+TEST(Dispatch, NoFreeCapacity_NoTrip) {
+    EXPECT_TRUE(planTrips(5, {0, 0, 0}).empty());
+    EXPECT_TRUE(planTrips(0, {3, 4}).empty());
+    EXPECT_TRUE(planTrips(5, {}).empty());
+}
+
+TEST(Dispatch, OnlyHospitalsWithRoom_AndNeverMoreThanTheirRoom) {
+    auto trips = planTrips(5, {0, 2, 0, 1});
+    EXPECT_EQ(planned(trips), 3);
+    ASSERT_EQ(trips.size(), 2u);
+    EXPECT_EQ(trips[0].target, 1u);
+    EXPECT_EQ(trips[0].qty, 2);
+    EXPECT_EQ(trips[1].target, 3u);
+    EXPECT_EQ(trips[1].qty, 1);
+}
+
+TEST(Dispatch, Share_ProportionalToFreeCapacity) {
+    auto trips = planTrips(10, {10, 30, 60});
+    ASSERT_EQ(trips.size(), 3u);
+    EXPECT_EQ(trips[0].qty, 1);
+    EXPECT_EQ(trips[1].qty, 3);
+    EXPECT_EQ(trips[2].qty, 6);
+}
+
+TEST(Dispatch, LargestRemainders_GetThePatientsLeft) {
+    // Parts exactes 2/3, 4/3 et 2 : le patient restant va au plus grand reste (2/3)
+    auto trips = planTrips(4, {10, 20, 30});
+    EXPECT_EQ(planned(trips), 4);
+    ASSERT_EQ(trips.size(), 3u);
+    EXPECT_EQ(trips[0].qty, 1);
+    EXPECT_EQ(trips[1].qty, 1);
+    EXPECT_EQ(trips[2].qty, 2);
+
+    trips = planTrips(1, {10, 30, 60});
+    ASSERT_EQ(trips.size(), 1u);
+    EXPECT_EQ(trips[0].target, 2u);
+
+    // Restes égaux : le plus de place d'abord, puis le premier
+    trips = planTrips(2, {5, 10, 5});
+    ASSERT_EQ(trips.size(), 2u);
+    EXPECT_EQ(trips[0].target, 0u);
+    EXPECT_EQ(trips[1].target, 1u);
+    trips = planTrips(1, {5, 5});
+    ASSERT_EQ(trips.size(), 1u);
+    EXPECT_EQ(trips[0].target, 0u);
+}
+
+TEST(Dispatch, UnknownCapacity_TakesEveryPatient) {
+    auto trips = planTrips(5, {-1});
+    ASSERT_EQ(trips.size(), 1u);
+    EXPECT_EQ(trips[0].qty, 5);
+}
+
+TEST(Dispatch, ParseMode) {
+    EXPECT_EQ(parseDispatchMode("random"), DispatchMode::Random);
+    EXPECT_EQ(parseDispatchMode("capacity"), DispatchMode::FreeCapacity);
+    EXPECT_THROW(parseDispatchMode("nearest"), std::invalid_argument);
+}
@@ -97,10 +97,22 @@ TEST_F(HospitalFixture, ReceivesSickPatientsRespectingFundsAndBeds) {
     EXPECT_EQ(local.transfer(ItemType::SickPatient, 2), 0);
 }
 
+TEST_F(HospitalFixture, PublishState_CountsPatientsWaiting) {
+    hosp->transfer(ItemType::SickPatient, 4);
+    hosp->transfer(ItemType::RehabPatient, 2);
+    hosp->publishState();
+
+    ActorState state = hosp->readState();
+    EXPECT_EQ(state.fund, hosp->money);
+    EXPECT_EQ(state.stock[static_cast<int>(ItemType::SickPatient)], 4);
+    EXPECT_EQ(state.backlog, 4 + 2);
+    EXPECT_EQ(state.unpaid, 0);
+}
+
 TEST_F(HospitalFixture, ReceivesRehabPatientsStartsTimers) {
     int got = hosp->transfer(ItemType::RehabPatient, 3);
     EXPECT_EQ(got, 3);
-    EXPECT_EQ(hosp->stocks[ItemType::RehabPatient], 3);
+    EXPECT_EQ(hosp->getNumberPatients(), 3);
 
     int startFund = hosp->money;
     for (int day = 0; day < 5; ++day) hosp->updateRehab();
@@ -186,3 +198,61 @@ TEST_F(HospitalFixture, EndToEndShortRunDoesMeaningfulWork) {
     EXPECT_LE(hosp->stocks[ItemType::RehabPatient], startRehab);
     EXPECT_EQ(endFund, startFund);
 }
+
+TEST(HospitalReservation, TicketsAreSingleUseAndOwned) {
+    Hospital hosp(1, /*fund*/1'000, /*maxBeds*/5);
+    Hospital other(2, /*fund*/1'000, /*maxBeds*/5);
+
+    Reservation token = hosp.reserve(ItemType::SickPatient, 3);
+    EXPECT_TRUE(token.isOpen());
+    EXPECT_EQ(token.qty(), 3);
+    EXPECT_THROW(other.commit(token), std::logic_error);
+    EXPECT_TRUE(token.isOpen());
+
+    EXPECT_EQ(hosp.commit(token), 3);
+    EXPECT_FALSE(token.isOpen());
+    EXPECT_THROW(hosp.commit(token), std::logic_error);
+    EXPECT_THROW(hosp.abort(token), std::logic_error);
+    EXPECT_EQ(hosp.getFreeCapacity(), 2);
+
+    // Un ticket déplacé laisse l'original fermé : une seule annulation possible
+    Reservation first = hosp.reserve(ItemType::SickPatient, 2);
+    Reservation moved = std::move(first);
+    EXPECT_FALSE(first.isOpen());
+    EXPECT_THROW(hosp.abort(first), std::logic_error);
+    hosp.abort(moved);
+    EXPECT_EQ(hosp.getFreeCapacity(), 2);
+    EXPECT_EQ(hosp.getNumberPatients(), 3);
+
+    Reservation a = hosp.reserve(ItemType::SickPatient, 1);
+    Reservation b = hosp.reserve(ItemType::SickPatient, 1);
+    EXPECT_NE(a.getId(), b.getId());
+    hosp.abort(a);
+    hosp.abort(b);
+}
+
+TEST(HospitalReservation, UnsettledTicketsGiveTheirBedsBack) {
+    Hospital hosp(1, /*fund*/1'000, /*maxBeds*/5);
+
+    // Abandonné en sortant de la portée, par exemple sur une exception
+    try {
+        Reservation token = hosp.reserve(ItemType::SickPatient, 3);
+        EXPECT_EQ(hosp.getFreeCapacity(), 2);
+        throw std::runtime_error("early exit");
+    } catch (const std::runtime_error&) {}
+    EXPECT_EQ(hosp.getFreeCapacity(), 5);
+
+    // Écraser un ticket ouvert l'annule d'abord
+    Reservation token = hosp.reserve(ItemType::SickPatient, 2);
+    token = hosp.reserve(ItemType::SickPatient, 1);
+    EXPECT_EQ(hosp.getFreeCapacity(), 4);
+
+    // Un déplacement sur soi-même garde le ticket
+    Reservation& alias = token;
+    token = std::move(alias);
+    EXPECT_TRUE(token.isOpen());
+    EXPECT_EQ(token.qty(), 1);
+
+    EXPECT_EQ(hosp.commit(token), 1);
+    EXPECT_EQ(hosp.getFreeCapacity(), 4);
+}
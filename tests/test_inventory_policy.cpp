@@ -0,0 +1,60 @@
+// tests/test_inventory_policy.cpp
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+#include "inventory_policy.h"
+
+TEST(InventoryPolicy, OnDemand_BuysOnlyWhatTodaysBatchMisses) {
+    OnDemandPolicy policy;
+    EXPECT_EQ(policy.orderQuantity({/*stock*/0, /*waiting*/5, /*capacity*/3}), 3);
+    EXPECT_EQ(policy.orderQuantity({2, 5, 3}), 1);
+    EXPECT_EQ(policy.orderQuantity({4, 5, 3}), 0);
+    // Sans patient, une commande manuelle vise une unité
+    EXPECT_EQ(policy.orderQuantity({0, 0, 3}), 1);
+}
+
+TEST(InventoryPolicy, ReorderPoint_RefillsUpToSOnlyBelowReorderPoint) {
+    ReorderPointPolicy policy(/*s*/2, /*S*/8);
+    // Stock restant après le lot : 6 - 2 = 4 > s
+    EXPECT_EQ(policy.orderQuantity({6, 2, 2}), 0);
+    // 4 - 2 = 2 <= s : on remonte à 8 après le lot
+    EXPECT_EQ(policy.orderQuantity({4, 2, 2}), 6);
+    EXPECT_EQ(policy.orderQuantity({0, 1, 2}), 9);
+
+    EXPECT_THROW(ReorderPointPolicy(3, 3), std::invalid_argument);
+}
+
+TEST(InventoryPolicy, MovingAverage_OrdersAheadFromRecentConsumption) {
+    MovingAverageDemandPolicy policy(/*window*/3, /*cover*/4);
+    EXPECT_DOUBLE_EQ(policy.averageDemand(), 0.0);
+    EXPECT_EQ(policy.orderQuantity({0, 1, 2}), 1);
+
+    policy.recordDay(2);
+    policy.recordDay(2);
+    policy.recordDay(2);
+    EXPECT_DOUBLE_EQ(policy.averageDemand(), 2.0);
+    // Lot de 2 + 4 jours à 2 par jour
+    EXPECT_EQ(policy.orderQuantity({0, 3, 2}), 10);
+    // Demain encore couvert : rien à commander
+    EXPECT_EQ(policy.orderQuantity({4, 3, 2}), 0);
+
+    // La fenêtre glisse
+    policy.recordDay(5);
+    policy.recordDay(5);
+    policy.recordDay(5);
+    EXPECT_DOUBLE_EQ(policy.averageDemand(), 5.0);
+}
+
+TEST(InventoryPolicy, Parse_BuildsPoliciesAndRejectsGarbage) {
+    auto sS = parseInventoryPolicy("sS:1:5")();
+    EXPECT_EQ(sS->orderQuantity({0, 1, 1}), 6);
+
+    auto avg = parseInventoryPolicy("moving-average:7:2")();
+    EXPECT_NE(dynamic_cast<MovingAverageDemandPolicy*>(avg.get()), nullptr);
+
+    EXPECT_NE(dynamic_cast<OnDemandPolicy*>(parseInventoryPolicy("on-demand")().get()), nullptr);
+
+    EXPECT_THROW(parseInventoryPolicy("sS:5"), std::invalid_argument);
+    EXPECT_THROW(parseInventoryPolicy("sS:a:b"), std::invalid_argument);
+    EXPECT_THROW(parseInventoryPolicy("fifo"), std::invalid_argument);
+}
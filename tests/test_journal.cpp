@@ -0,0 +1,69 @@
+// tests/test_journal.cpp
+#include <gtest/gtest.h>
+#include <pcosynchro/pcothread.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "journal.h"
+
+class JournalFixture : public ::testing::Test {
+protected:
+    void TearDown() override {
+        if (journal.isOpen()) journal.close();
+        std::filesystem::remove_all(dir);
+    }
+
+    std::string dir = ::testing::TempDir() + "pco_journal_test";
+    Journal journal;
+};
+
+TEST_F(JournalFixture, ClosedJournalRecordsNothing) {
+    journal.record(EventType::Pay, 1, 2, ItemType::Nothing, 0, 10);
+
+    journal.open(dir);
+    journal.close();
+
+    int seen = 0;
+    Journal::replay(dir, [&](const JournalEvent&) { ++seen; });
+    EXPECT_EQ(seen, 0);
+}
+
+TEST_F(JournalFixture, ConcurrentWritersAreMergedInTimestampOrder) {
+    journal.open(dir);
+    journal.setDay(3);
+
+    // Assez d'événements pour forcer l'agrandissement des segments
+    const int N = 100'000;
+    std::vector<std::unique_ptr<PcoThread>> ts;
+    for (int i = 0; i < 4; ++i) {
+        ts.emplace_back(std::make_unique<PcoThread>([&, i]() {
+            for (int k = 0; k < N; ++k) {
+                journal.record(EventType::Transfer, i, 10 + i, ItemType::SickPatient, 1, k);
+            }
+        }));
+    }
+    for (auto& t : ts) t->join();
+    journal.close();
+
+    long long seen = 0;
+    uint64_t lastTimestamp = 0;
+    bool ordered = true;
+    std::vector<int> lastAmount(4, -1);
+    bool perWriterOrdered = true;
+
+    Journal::replay(dir, [&](const JournalEvent& e) {
+        ++seen;
+        ordered = ordered && e.timestamp >= lastTimestamp;
+        lastTimestamp = e.timestamp;
+        perWriterOrdered = perWriterOrdered && e.amount == lastAmount[e.from] + 1;
+        lastAmount[e.from] = e.amount;
+        EXPECT_EQ(e.day, 3);
+        EXPECT_EQ(e.to, 10 + e.from);
+    });
+
+    EXPECT_EQ(seen, 4LL * N);
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(perWriterOrdered);
+}
@@ -0,0 +1,112 @@
+// tests/test_metrics.cpp
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "metrics.h"
+
+class MetricsFixture : public ::testing::Test {
+protected:
+    void SetUp() override {
+        hosp.setInsurance(&ins);
+        clinic.setHospitalsAndSuppliers({&hosp}, {&sup});
+        clinic.setInsurance(&ins);
+    }
+    void TearDown() override { std::remove(path.c_str()); }
+
+    // Comme main, publie les états avant chaque échantillon
+    void publishAll() {
+        sup.publishState();
+        hosp.publishState();
+        clinic.publishState();
+        ins.publishState();
+    }
+
+    std::unique_ptr<MetricsExporter> makeExporter() {
+        return std::make_unique<MetricsExporter>(path, std::vector<Ambulance*>{}, std::vector<Supplier*>{&sup},
+                                                 std::vector<Clinic*>{&clinic}, std::vector<Hospital*>{&hosp},
+                                                 std::vector<Insurance*>{&ins});
+    }
+
+    std::string path = ::testing::TempDir() + "pco_metrics_test.csv";
+    Pharmacy sup{1, 200};
+    Hospital hosp{2, 1'000, 3};
+    Pulmonology clinic{3, 300};
+    Insurance ins{4, 1'000};
+};
+
+TEST_F(MetricsFixture, CsvHasOneLinePerSampledDay) {
+    {
+        auto metrics = makeExporter();
+        publishAll();
+        metrics->sampleDay(0);
+        ins.invoice(50, &hosp);
+        EXPECT_EQ(hosp.transfer(ItemType::SickPatient, 5), 3);
+        population().reject(2);
+        publishAll();
+        metrics->sampleDay(1);
+    }
+
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) lines.push_back(line);
+
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_EQ(lines[0].rfind("day,", 0), 0u);
+
+    std::vector<long long> cols;
+    std::stringstream row(lines[2]);
+    for (std::string cell; std::getline(row, cell, ',');) cols.push_back(std::stoll(cell));
+
+    ASSERT_EQ(cols.size(), 13u);
+    EXPECT_EQ(cols[0], 1);       // day
+    EXPECT_EQ(cols[7], 300);     // fund_clinic
+    EXPECT_EQ(cols[10], 2);      // rejected_patients pendant le jour 1
+    EXPECT_EQ(cols[11], 50);     // unpaid_backlog
+}
+
+TEST_F(MetricsFixture, BinaryIsWrittenColumnByColumn) {
+    path = ::testing::TempDir() + "pco_metrics_test.bin";
+    {
+        auto metrics = makeExporter();
+        publishAll();
+        metrics->sampleDay(0);
+        ins.invoice(50, &hosp);
+        publishAll();
+        metrics->sampleDay(1);
+        ins.invoice(25, &hosp);
+        publishAll();
+        metrics->sampleDay(2);
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    char magic[8];
+    uint32_t nbColumns = 0;
+    uint32_t reserved = 1;
+    uint64_t nbRows = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&nbColumns), sizeof(nbColumns));
+    in.read(reinterpret_cast<char*>(&reserved), sizeof(reserved));
+    in.read(reinterpret_cast<char*>(&nbRows), sizeof(nbRows));
+
+    EXPECT_EQ(std::string(magic), "PCOMETR");
+    ASSERT_EQ(nbColumns, 13u);
+    EXPECT_EQ(reserved, 0u);
+    ASSERT_EQ(nbRows, 3u);
+
+    std::vector<int64_t> values(nbColumns * nbRows);
+    in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(int64_t)));
+    ASSERT_TRUE(in);
+    EXPECT_EQ(in.peek(), std::ifstream::traits_type::eof());
+
+    // Colonne 0 : les jours, contigus ; colonne 11 : l'impayé de chaque jour
+    EXPECT_EQ(values[0], 0);
+    EXPECT_EQ(values[1], 1);
+    EXPECT_EQ(values[2], 2);
+    EXPECT_EQ(values[11 * nbRows + 0], 0);
+    EXPECT_EQ(values[11 * nbRows + 1], 50);
+    EXPECT_EQ(values[11 * nbRows + 2], 75);
+}
@@ -0,0 +1,202 @@
+// tests/test_partition.cpp
+#include <gtest/gtest.h>
+#include <pcosynchro/pcothread.h>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <unistd.h>
+
+#include "hospital.h"
+#include "insurance.h"
+#include "partition.h"
+#include "supplier.h"
+#include "topology.h"
+#include "utils.h"
+
+namespace {
+
+/// Acteurs filtrés sur ceux que ce processus exécute
+template<typename Group>
+Group localOnly(const Group& group, const PhasedDay& day) {
+    Group out;
+    for (auto* s : group) {
+        if (day.isLocal(day.indexOf(s))) out.push_back(s);
+    }
+    return out;
+}
+
+/// Fonds, employés payés, patients et stocks de chaque acteur d'un petit monde
+/// après quelques journées à phases, sur nbPartitions processus (1 : sans Partition).
+std::vector<int> runWorld(uint32_t seed, int nbDays, int nbPartitions) {
+    Seller::setRandomSeed(seed);
+    auto ambulances = createAmbulances(2, 0);
+    auto suppliers  = createSuppliers(2, 2);
+    auto hospitals  = createHospitals(2, 4);
+    auto clinics    = createClinics(3, 6);
+    Insurance insurance(9, INSURANCE_FUND);
+
+    std::vector<Seller*> all;
+    all.insert(all.end(), ambulances.begin(), ambulances.end());
+    all.insert(all.end(), suppliers.begin(), suppliers.end());
+    all.insert(all.end(), hospitals.begin(), hospitals.end());
+    all.insert(all.end(), clinics.begin(), clinics.end());
+    all.push_back(&insurance);
+
+    PhasedDay day(all);
+    std::unique_ptr<Partition> partition;
+    if (nbPartitions > 1) {
+        partition = std::make_unique<Partition>(nbPartitions, static_cast<int>(all.size()));
+        day.setPartition(partition.get());
+        partition->forkProcesses();
+    }
+    for (auto* s : all) s->setPhases(&day);
+    applyTopology(makeTopology("", 1, 2, 3, 2), ambulances, suppliers, clinics, hospitals);
+    for (auto* a : ambulances) a->setInsurance(day.deferred(&insurance));
+    for (auto* h : hospitals)  h->setInsurance(day.deferred(&insurance));
+    for (auto* c : clinics) {
+        c->setInsurance(day.deferred(&insurance));
+        c->setTreatmentCapacity(3);
+    }
+
+    int participants = static_cast<int>(localOnly(all, day).size());
+    std::unique_ptr<DayClock> clock;
+    if (partition) clock = std::make_unique<SharedDayClock>(participants, partition.get());
+    else clock = std::make_unique<DayClock>(participants);
+    clock->set_phase_step([&day] { day.routeReplies(); });
+    for (auto* s : all) s->setClock(clock.get());
+    for (auto* s : localOnly(all, day)) s->publishState();
+    day.swapBuffers();
+
+    std::vector<std::unique_ptr<PcoThread>> threads;
+    startWorkers(localOnly(ambulances, day), threads);
+    startWorkers(localOnly(suppliers, day), threads);
+    startWorkers(localOnly(hospitals, day), threads);
+    startWorkers(localOnly(clinics, day), threads);
+    startWorkers(localOnly(std::vector<Insurance*>{&insurance}, day), threads);
+    for (int d = 0; d < nbDays; ++d) {
+        clock->start_next_day();
+        clock->wait_all_done();
+        day.swapBuffers();
+    }
+    endService(threads);
+    clock->release_workers();
+    for (auto& t : threads) t->join();
+    day.applyAll();
+
+    std::vector<ActorState> finals(all.size());
+    for (size_t i = 0; i < all.size(); ++i) {
+        if (!day.isLocal(static_cast<int>(i))) continue;
+        all[i]->publishState();
+        finals[i] = all[i]->readState();
+        if (partition) partition->setFinalState(static_cast<int>(i), finals[i]);
+    }
+    if (partition) {
+        // Les autres processus n'ont plus rien à faire
+        if (!partition->isMain()) _exit(0);
+        partition->join();
+        for (size_t i = 0; i < all.size(); ++i) finals[i] = partition->getFinalState(static_cast<int>(i));
+    }
+
+    std::vector<int> out;
+    for (const auto& state : finals) {
+        out.insert(out.end(), {state.fund, state.employeesPaid, state.patients, state.freed});
+        out.insert(out.end(), std::begin(state.stock), std::end(state.stock));
+    }
+
+    for (auto* a : ambulances) delete a;
+    for (auto* s : suppliers)  delete s;
+    for (auto* h : hospitals)  delete h;
+    for (auto* c : clinics)    delete c;
+    Seller::setRandomSeed(1);
+    return out;
+}
+
+} // namespace
+
+TEST(Partition, Exchange_MoreThanARing_KeepsTheSenderOrder) {
+    // Acteurs 0 et 2 dans le premier processus, 1 et 3 dans le second ; boîte partagée en 4
+    const int NB_ACTORS = 4;
+    const int PER_TARGET = static_cast<int>(RemoteChannel::capacity()) * 2 + 3;
+    Partition partition(2, NB_ACTORS);
+    partition.forkProcesses();
+    int self = partition.getIndex();
+
+    // Deux échanges de suite : le second lot peut arriver avant la fin du premier
+    bool ordered = true;
+    for (int round = 0; round < 2; ++round) {
+        std::vector<std::vector<Intent>> boxes(NB_ACTORS + 1);
+        for (int sender = self; sender < NB_ACTORS; sender += 2) {
+            for (int k = 0; k < PER_TARGET; ++k) {
+                for (int to = 0; to < NB_ACTORS; ++to) {
+                    boxes[sender].push_back({Intent::Op::Pay, ItemType::Nothing, -1, to, round, k});
+                }
+            }
+        }
+        partition.exchange(boxes);
+
+        for (int sender = 0; sender < NB_ACTORS; ++sender) {
+            // Restent les intentions vers nos acteurs, dans l'ordre où elles ont été émises
+            auto& box = boxes[sender];
+            ordered = ordered && box.size() == static_cast<size_t>(PER_TARGET) * 2;
+            for (size_t i = 0; ordered && i < box.size(); ++i) {
+                ordered = partition.isLocal(box[i].to) && box[i].qty == round &&
+                          box[i].amount == static_cast<int>(i / 2);
+            }
+        }
+        ordered = ordered && boxes[NB_ACTORS].empty();
+    }
+    if (!partition.isMain()) _exit(ordered ? 0 : 1);
+
+    EXPECT_TRUE(ordered);
+    EXPECT_NO_THROW(partition.join());
+}
+
+TEST(Partition, SharedDayClock_KeepsProcessesInLockstep) {
+    const int DAYS = 50;
+    Partition partition(3, 3);
+    // Jours terminés par chacun des processus, lus par tous dans les états partagés
+    ActorState* days = partition.stateBuffer(0);
+    partition.forkProcesses();
+    int self = partition.getIndex();
+
+    SharedDayClock clock(1, &partition);
+    PcoThread worker([&clock, &days, self] {
+        for (int d = 0; d < DAYS; ++d) {
+            clock.worker_wait_day_start();
+            days[self].day = d + 1;
+            clock.worker_end_day();
+        }
+    });
+    bool lockstep = true;
+    for (int d = 0; d < DAYS; ++d) {
+        clock.start_next_day();
+        clock.wait_all_done();
+        // Aucun processus en retard, et aucun plus d'un jour en avance
+        for (int p = 0; p < 3; ++p) lockstep = lockstep && days[p].day >= d + 1 && days[p].day <= d + 2;
+    }
+    worker.join();
+    bool anyOdd = partition.any(self == 2);
+    bool anyNone = partition.any(false);
+    if (!partition.isMain()) _exit(lockstep && anyOdd && !anyNone ? 0 : 1);
+
+    EXPECT_TRUE(lockstep);
+    EXPECT_EQ(clock.current_day(), DAYS);
+    EXPECT_TRUE(anyOdd);
+    EXPECT_FALSE(anyNone);
+    EXPECT_NO_THROW(partition.join());
+}
+
+TEST(Partition, RejectsMoreProcessesThanActors) {
+    EXPECT_THROW(Partition(0, 3), std::invalid_argument);
+    EXPECT_THROW(Partition(4, 3), std::invalid_argument);
+
+    Partition partition(2, 3);
+    PhasedDay day(std::vector<Seller*>{});
+    EXPECT_THROW(day.setPartition(&partition), std::invalid_argument);
+}
+
+TEST(Partition, SeededWorld_SameResultsAsASingleProcess) {
+    auto single = runWorld(7, 30, 1);
+    EXPECT_EQ(runWorld(7, 30, 2), single);
+    EXPECT_EQ(runWorld(7, 30, 3), single);
+}
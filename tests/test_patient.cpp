@@ -0,0 +1,123 @@
+// tests/test_patient.cpp
+#include <gtest/gtest.h>
+#include <pcosynchro/pcothread.h>
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "patient.h"
+#include "ambulance.h"
+#include "hospital.h"
+#include "seller.h"
+#include "day_clock.h"
+
+// Assurance qui ignore les factures
+class SinkInsurance : public Seller {
+public:
+    explicit SinkInsurance(int id) : Seller(0, id) {}
+    void invoice(int, Seller*) override {}
+    int  transfer(ItemType, int) override { return 0; }
+    int  buy(ItemType, int) override { return 0; }
+    void pay(int) override {}
+};
+
+TEST(PatientPool, ConcurrentAllocateReleaseNeverHandsOutTwice) {
+    PatientPool pool;
+    const int N = 20'000;
+    std::vector<std::vector<PatientHandle>> kept(4);
+    std::vector<std::unique_ptr<PcoThread>> ts;
+    for (int i = 0; i < 4; ++i) {
+        ts.emplace_back(std::make_unique<PcoThread>([&, i]() {
+            for (int k = 0; k < N; ++k) {
+                PatientHandle h = pool.allocate();
+                if (k % 2) pool.release(h);
+                else kept[i].push_back(h);
+            }
+        }));
+    }
+    for (auto& t : ts) t->join();
+
+    std::vector<PatientHandle> all;
+    for (auto& v : kept) all.insert(all.end(), v.begin(), v.end());
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(all.size(), 4u * N / 2);
+    EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end());
+}
+
+TEST(PatientTracker, RehabPatientsAreDischargedWithLatencies) {
+    patientTracker().enable();
+    patientTracker().setDay(0);
+    long long startDischarged = patientTracker().dischargedCount();
+
+    SinkInsurance ins(3);
+    Hospital hosp(1, /*fund*/1'000, /*maxBeds*/2);
+    hosp.setInsurance(&ins);
+
+    // Des patients suivis envoyés en réhabilitation, un lit de moins que demandé
+    std::deque<PatientHandle> treated;
+    patientTracker().admit(treated, 3, PatientStage::Treated, 2);
+    patientTracker().send(treated, 3);
+    EXPECT_EQ(hosp.transfer(ItemType::RehabPatient, 3), 2);
+    patientTracker().takeBack(treated);
+    EXPECT_EQ(treated.size(), 1u);
+
+    DayClock clock(/*participants*/1);
+    hosp.setClock(&clock);
+    std::unique_ptr<PcoThread> th = std::make_unique<PcoThread>([&](){ hosp.run(); });
+
+    for (int day = 1; day <= REHAB_DURATION_DAYS; ++day) {
+        patientTracker().setDay(day);
+        clock.start_next_day();
+        clock.wait_all_done();
+    }
+
+    th->requestStop();
+    clock.start_next_day();
+    th->join();
+
+    EXPECT_EQ(patientTracker().dischargedCount(), startDischarged + 2);
+
+    std::ostringstream report;
+    patientTracker().printReport(report);
+    EXPECT_NE(report.str().find("Rehab -> freed"), std::string::npos);
+
+    patientTracker().disable();
+}
+
+TEST(PatientTracker, PatientWithoutRecord_DoesNotStopDischargesOfOthers) {
+    patientTracker().enable();
+    patientTracker().setDay(0);
+    long long startDischarged = patientTracker().dischargedCount();
+
+    SinkInsurance ins(3);
+    Hospital hosp(1, /*fund*/1'000, /*maxBeds*/5);
+    hosp.setInsurance(&ins);
+
+    // Boîte d'envoi vide : ce patient arrive sans fiche (comme après une restauration)
+    EXPECT_EQ(hosp.transfer(ItemType::RehabPatient, 1), 1);
+    std::deque<PatientHandle> treated;
+    patientTracker().admit(treated, 2, PatientStage::Treated, 2);
+    patientTracker().send(treated, 2);
+    EXPECT_EQ(hosp.transfer(ItemType::RehabPatient, 2), 2);
+
+    DayClock clock(/*participants*/1);
+    hosp.setClock(&clock);
+    std::unique_ptr<PcoThread> th = std::make_unique<PcoThread>([&](){ hosp.run(); });
+
+    for (int day = 1; day <= REHAB_DURATION_DAYS; ++day) {
+        patientTracker().setDay(day);
+        clock.start_next_day();
+        clock.wait_all_done();
+    }
+
+    th->requestStop();
+    clock.start_next_day();
+    th->join();
+
+    // Les deux patients suivis sont sortis, celui sans fiche ne compte pas
+    EXPECT_EQ(patientTracker().dischargedCount(), startDischarged + 2);
+    EXPECT_EQ(hosp.getNumberPatients(), 3);
+
+    patientTracker().disable();
+}
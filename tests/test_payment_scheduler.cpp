@@ -0,0 +1,200 @@
+// tests/test_payment_scheduler.cpp
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+#include "payment_scheduler.h"
+#include "phases.h"
+#include "seller.h"
+
+namespace {
+
+/// Fournisseur de soins dont on règle l'état d'attente à la main.
+class Provider : public Seller {
+public:
+    explicit Provider(int id) : Seller(0, id) {}
+
+    int  transfer(ItemType, int) override { return 0; }
+    int  buy(ItemType, int) override { return 0; }
+    void invoice(int, Seller*) override {}
+    void pay(int bill) override { money += bill; }
+    bool isWaitingForPayment() const override { return waiting; }
+
+    bool waiting{false};
+};
+
+std::vector<std::pair<int, int>> drain(PaymentScheduler& scheduler, int money) {
+    std::vector<std::pair<int, int>> paid;
+    while (auto p = scheduler.next(money)) {
+        money -= p->amount;
+        paid.emplace_back(p->who->getUniqueId(), p->amount);
+    }
+    return paid;
+}
+
+} // namespace
+
+TEST(PaymentScheduler, Fifo_KeepsArrivalOrder_AndStopsAtFirstUnpayable) {
+    Provider a(1), b(2);
+    PaymentScheduler scheduler(parsePaymentPolicy("fifo"));
+    scheduler.add(&a, 30);
+    scheduler.add(&b, 10);
+    scheduler.add(&a, 5);
+    b.waiting = true;
+    scheduler.refreshPriorities();
+
+    // 30 passe, puis 10 ; 5 attend même s'il reste de quoi payer après 10
+    EXPECT_EQ(drain(scheduler, 40), (std::vector<std::pair<int, int>>{{1, 30}, {2, 10}}));
+    EXPECT_EQ(scheduler.getUnpaidAmount(), 5);
+}
+
+TEST(PaymentScheduler, Priority_WaitingProvidersFirst_SmallestBillFirst) {
+    Provider a(1), b(2), c(3);
+    PaymentScheduler scheduler(parsePaymentPolicy("priority"));
+    scheduler.add(&a, 30);
+    scheduler.add(&b, 20);
+    scheduler.add(&c, 12);
+    scheduler.add(&b, 4);
+    b.waiting = c.waiting = true;
+    scheduler.refreshPriorities();
+
+    EXPECT_EQ(drain(scheduler, 100),
+              (std::vector<std::pair<int, int>>{{3, 12}, {2, 20}, {2, 4}, {1, 30}}));
+    EXPECT_TRUE(scheduler.empty());
+}
+
+TEST(PaymentScheduler, Priority_BehindPhasedDay_ReadsYesterdaysFlag) {
+    Provider a(1), b(2);
+    PhasedDay day({&a, &b});
+    a.setPhases(&day);
+    b.setPhases(&day);
+    PaymentScheduler scheduler(parsePaymentPolicy("priority"));
+    // Avec --phased, les factures arrivent avec le mandataire du fournisseur
+    scheduler.add(day.deferred(&a), 30);
+    scheduler.add(day.deferred(&b), 20);
+    b.waiting = true;
+    b.publishState();
+
+    // Le drapeau publié n'est lu qu'après l'échange des tampons
+    scheduler.refreshPriorities();
+    EXPECT_FALSE(day.deferred(&b)->isWaitingForPayment());
+    day.swapBuffers();
+    scheduler.refreshPriorities();
+
+    EXPECT_EQ(drain(scheduler, 100), (std::vector<std::pair<int, int>>{{2, 20}, {1, 30}}));
+}
+
+TEST(PaymentScheduler, Priority_WorkingProvidersStayFifo) {
+    Provider a(1), b(2);
+    PaymentScheduler scheduler(parsePaymentPolicy("priority"));
+    scheduler.add(&a, 50);
+    scheduler.add(&b, 1);
+    scheduler.refreshPriorities();
+
+    // Aucun fournisseur bloqué : une grosse facture n'est pas doublée par une petite
+    EXPECT_TRUE(drain(scheduler, 10).empty());
+    EXPECT_EQ(drain(scheduler, 51), (std::vector<std::pair<int, int>>{{1, 50}, {2, 1}}));
+}
+
+TEST(PaymentScheduler, PartialPayments_PayWhatFundsAllow) {
+    Provider a(1);
+    PaymentScheduler scheduler(parsePaymentPolicy("priority:0:partial"));
+    scheduler.add(&a, 25);
+
+    EXPECT_EQ(drain(scheduler, 10), (std::vector<std::pair<int, int>>{{1, 10}}));
+    EXPECT_EQ(scheduler.getUnpaidAmount(), 15);
+    EXPECT_TRUE(drain(scheduler, 0).empty());
+    EXPECT_EQ(drain(scheduler, 100), (std::vector<std::pair<int, int>>{{1, 15}}));
+}
+
+TEST(PaymentScheduler, CreditLimit_AllowsOverdraftPerProvider) {
+    Provider a(1), b(2);
+    PaymentScheduler scheduler;
+    scheduler.setCreditLimit(&a, 20);
+    scheduler.add(&a, 25);
+    scheduler.add(&b, 5);
+
+    // a peut être payé jusqu'à -20, b seulement sur fonds propres
+    auto first = scheduler.next(10);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->amount, 25);
+    EXPECT_FALSE(scheduler.next(10 - 25).has_value());
+    EXPECT_EQ(scheduler.getCreditLimit(&b), 0);
+}
+
+TEST(PaymentScheduler, CreditLimit_IsDrawnOnceUntilFundsComeBack) {
+    Provider a(1);
+    PaymentScheduler scheduler;
+    scheduler.setCreditLimit(&a, 20);
+    scheduler.add(&a, 15);
+    scheduler.add(&a, 15);
+    scheduler.add(&a, 15);
+
+    // 15 payés à découvert : il ne reste que 5 de crédit à a
+    ASSERT_TRUE(scheduler.next(0).has_value());
+    EXPECT_EQ(scheduler.getCreditLeft(&a, -15), 5);
+    EXPECT_FALSE(scheduler.next(-15).has_value());
+    EXPECT_EQ(scheduler.daysUntilPayable(-15, 10), 1);
+
+    // 10 de cotisations remboursent le plus ancien tirage
+    EXPECT_EQ(scheduler.getCreditLeft(&a, -5), 15);
+    ASSERT_TRUE(scheduler.next(-5).has_value());
+    EXPECT_EQ(scheduler.getOverdrafts().size(), 1u);
+    EXPECT_EQ(scheduler.getOverdrafts().front().amount, 20);
+    EXPECT_FALSE(scheduler.next(-20).has_value());
+
+    // Fonds revenus au-dessus de 0 : tout est remboursé
+    ASSERT_TRUE(scheduler.next(15).has_value());
+    EXPECT_TRUE(scheduler.getOverdrafts().empty());
+}
+
+TEST(PaymentScheduler, DefaultPolicy_IsFifo) {
+    Provider a(1), b(2);
+    PaymentScheduler scheduler;
+    EXPECT_FALSE(scheduler.getPolicy().prioritizeWaiting);
+    scheduler.add(&a, 30);
+    scheduler.add(&b, 10);
+    b.waiting = true;
+    scheduler.refreshPriorities();
+
+    EXPECT_EQ(drain(scheduler, 40), (std::vector<std::pair<int, int>>{{1, 30}, {2, 10}}));
+}
+
+TEST(PaymentScheduler, DaysUntilPayable_NeverLaterThanAnyHead) {
+    Provider a(1), b(2);
+    PaymentScheduler scheduler;
+    EXPECT_EQ(scheduler.daysUntilPayable(0, 10), -1);
+
+    scheduler.add(&a, 95);
+    scheduler.add(&b, 31);
+    EXPECT_EQ(scheduler.daysUntilPayable(0, 10), 4);
+    EXPECT_EQ(scheduler.daysUntilPayable(31, 10), 0);
+    EXPECT_EQ(scheduler.daysUntilPayable(0, 0), -1);
+}
+
+TEST(PaymentScheduler, Pending_ListsBillsInArrivalOrder) {
+    Provider a(1), b(2);
+    PaymentScheduler scheduler(parsePaymentPolicy("priority:0:partial"));
+    scheduler.add(&b, 7);
+    scheduler.add(&a, 3);
+    scheduler.add(&b, 9);
+    scheduler.next(4);
+
+    auto pending = scheduler.pending();
+    ASSERT_EQ(pending.size(), 3u);
+    EXPECT_EQ(pending[0].who, &b);
+    EXPECT_EQ(pending[0].amount, 3);
+    EXPECT_EQ(pending[1].who, &a);
+    EXPECT_EQ(pending[2].amount, 9);
+}
+
+TEST(PaymentScheduler, ParsePolicy) {
+    PaymentPolicy p = parsePaymentPolicy("priority:50:partial");
+    EXPECT_TRUE(p.prioritizeWaiting);
+    EXPECT_TRUE(p.partialPayments);
+    EXPECT_EQ(p.creditLimit, 50);
+    EXPECT_TRUE(p.prioritizeWaiting);
+    EXPECT_FALSE(parsePaymentPolicy("fifo").prioritizeWaiting);
+    EXPECT_THROW(parsePaymentPolicy("priority:-1"), std::invalid_argument);
+    EXPECT_THROW(parsePaymentPolicy("priority:5:full"), std::invalid_argument);
+    EXPECT_THROW(parsePaymentPolicy("lifo"), std::invalid_argument);
+}
@@ -0,0 +1,296 @@
+// tests/test_phases.cpp
+#include <gtest/gtest.h>
+#include <pcosynchro/pcothread.h>
+#include <memory>
+#include <vector>
+#include "day_clock.h"
+#include "hospital.h"
+#include "insurance.h"
+#include "phases.h"
+#include "supplier.h"
+#include "topology.h"
+#include "utils.h"
+
+namespace {
+
+/// Acteur minimal qui note les paiements et factures reçus.
+class Account : public Seller {
+public:
+    explicit Account(int id) : Seller(0, id) {}
+
+    int  transfer(ItemType, int) override { return 0; }
+    int  buy(ItemType, int) override { return 0; }
+    void invoice(int bill, Seller* who) override { invoices.emplace_back(who, bill); }
+    void pay(int bill) override {
+        money += bill;
+        payments.push_back(bill);
+    }
+
+    std::vector<std::pair<Seller*, int>> invoices;
+    std::vector<int> payments;
+};
+
+/// Acteur qui accepte des patients dans la limite de ses places et note les réponses reçues.
+class Ward : public Account {
+public:
+    Ward(int id, int room) : Account(id), room(room) {}
+
+    int transfer(ItemType, int qty) override {
+        int accepted = std::min(qty, room);
+        room -= accepted;
+        return accepted;
+    }
+    void settleReplies(const std::vector<Intent>& r) override { replies.insert(replies.end(), r.begin(), r.end()); }
+    int getFreeCapacity() const override { return room; }
+
+    int room;
+    std::vector<Intent> replies;
+};
+
+/// Fonds, employés payés, patients et stocks de chaque acteur d'un petit monde
+/// après quelques journées à phases.
+std::vector<int> runPhasedWorld(uint32_t seed, int nbDays, int& patientsLost, int& moneyLost) {
+    Seller::setRandomSeed(seed);
+    auto ambulances = createAmbulances(2, 0);
+    auto suppliers  = createSuppliers(2, 2);
+    auto hospitals  = createHospitals(2, 4);
+    auto clinics    = createClinics(3, 6);
+    Insurance insurance(9, INSURANCE_FUND);
+
+    std::vector<Seller*> all;
+    all.insert(all.end(), ambulances.begin(), ambulances.end());
+    all.insert(all.end(), suppliers.begin(), suppliers.end());
+    all.insert(all.end(), hospitals.begin(), hospitals.end());
+    all.insert(all.end(), clinics.begin(), clinics.end());
+    all.push_back(&insurance);
+
+    PhasedDay day(all);
+    for (auto* s : all) s->setPhases(&day);
+    applyTopology(makeTopology("", 1, 2, 3, 2), ambulances, suppliers, clinics, hospitals);
+    for (auto* a : ambulances) a->setInsurance(day.deferred(&insurance));
+    for (auto* h : hospitals)  h->setInsurance(day.deferred(&insurance));
+    for (auto* c : clinics) {
+        c->setInsurance(day.deferred(&insurance));
+        c->setTreatmentCapacity(3);
+    }
+
+    int patientsBefore = 0;
+    for (auto* a : ambulances) patientsBefore += a->getNumberPatients();
+    int moneyBefore = 0;
+    for (auto* s : all) moneyBefore += s->getFund();
+
+    DayClock clock(static_cast<int>(all.size()));
+    clock.set_phase_step([&day] { day.routeReplies(); });
+    for (auto* s : all) {
+        s->setClock(&clock);
+        s->publishState();
+    }
+    day.swapBuffers();
+
+    std::vector<std::unique_ptr<PcoThread>> threads;
+    startWorkers(ambulances, threads);
+    startWorkers(suppliers, threads);
+    startWorkers(hospitals, threads);
+    startWorkers(clinics, threads);
+    startWorkers(std::vector<Insurance*>{&insurance}, threads);
+    for (int d = 0; d < nbDays; ++d) {
+        clock.start_next_day();
+        clock.wait_all_done();
+        day.swapBuffers();
+    }
+    endService(threads);
+    clock.release_workers();
+    for (auto& t : threads) t->join();
+    day.applyAll();
+
+    std::vector<int> out;
+    int patientsAfter = 0;
+    for (auto* s : all) {
+        s->publishState();
+        ActorState state = s->readState();
+        out.insert(out.end(), {state.fund, state.employeesPaid, state.patients, state.freed});
+        out.insert(out.end(), std::begin(state.stock), std::end(state.stock));
+        patientsAfter += state.patients + state.freed;
+    }
+    patientsLost = patientsBefore - patientsAfter;
+
+    int moneyAfter = insurance.getFund() - INSURANCE_CONTRIBUTION * nbDays;
+    for (auto* a : ambulances) moneyAfter += a->getFund() + a->getAmountPaidToEmployees(EmployeeType::EmergencyStaff);
+    for (auto* s : suppliers)  moneyAfter += s->getFund() + s->getAmountPaidToEmployees(EmployeeType::Supplier);
+    for (auto* h : hospitals)  moneyAfter += h->getFund() + h->getAmountPaidToEmployees(EmployeeType::NursingStaff);
+    for (auto* c : clinics)    moneyAfter += c->getFund() + c->getAmountPaidToEmployees(EmployeeType::TreatmentSpecialist);
+    moneyLost = moneyBefore - moneyAfter;
+
+    for (auto* a : ambulances) delete a;
+    for (auto* s : suppliers)  delete s;
+    for (auto* h : hospitals)  delete h;
+    for (auto* c : clinics)    delete c;
+    Seller::setRandomSeed(1);
+    return out;
+}
+
+} // namespace
+
+TEST(PhasedDay, Payment_AppliedOnlyAfterSwap) {
+    Account a(1), b(2);
+    PhasedDay day({&a, &b});
+
+    day.deferred(&b)->pay(5);
+    day.deferred(&b)->pay(7);
+    EXPECT_EQ(b.getFund(), 0);
+
+    // Sans échange des tampons, la boîte de réception est encore vide
+    EXPECT_EQ(day.applyInbox(&b), 0);
+
+    day.swapBuffers();
+    EXPECT_EQ(day.applyInbox(&b), 2);
+    EXPECT_EQ(b.getFund(), 12);
+    EXPECT_EQ(day.applyInbox(&a), 0);
+    EXPECT_EQ(day.getIntentCount(), 2);
+}
+
+TEST(PhasedDay, Inbox_FollowsActorOrder_NotTiming) {
+    Account a(1), b(2), target(3);
+    PhasedDay day({&a, &b, &target});
+
+    // b émet avant a, mais la boîte de réception suit l'ordre des acteurs
+    PcoThread tb([&] {
+        day.bindOutbox(&b);
+        day.deferred(&target)->pay(20);
+        day.deferred(&target)->pay(21);
+    });
+    tb.join();
+    PcoThread ta([&] {
+        day.bindOutbox(&a);
+        day.deferred(&target)->pay(10);
+    });
+    ta.join();
+
+    day.swapBuffers();
+    day.applyInbox(&target);
+    EXPECT_EQ(target.payments, (std::vector<int>{10, 20, 21}));
+}
+
+TEST(PhasedDay, Invoice_PaidBackThroughProxy) {
+    Account hospital(1), insurance(2);
+    PhasedDay day({&hospital, &insurance});
+    hospital.setPhases(&day);
+    insurance.setPhases(&day);
+
+    day.deferred(&insurance)->invoice(30, &hospital);
+    day.swapBuffers();
+    day.applyInbox(&insurance);
+
+    // Le bénéficiaire est désigné par son mandataire : le paiement sera différé lui aussi
+    ASSERT_EQ(insurance.invoices.size(), 1u);
+    EXPECT_EQ(insurance.invoices[0].first, day.deferred(&hospital));
+    EXPECT_EQ(insurance.invoices[0].second, 30);
+
+    insurance.invoices[0].first->pay(30);
+    EXPECT_EQ(hospital.getFund(), 0);
+    day.applyAll();
+    EXPECT_EQ(hospital.getFund(), 30);
+}
+
+TEST(PhasedDay, Deferred_RejectsCallsNeedingAnAnswer) {
+    Account a(1);
+    PhasedDay day({&a});
+    EXPECT_THROW(day.deferred(&a)->buy(ItemType::Pill, 1), std::logic_error);
+    EXPECT_THROW(day.deferred(&a)->transfer(ItemType::SickPatient, 1), std::logic_error);
+}
+
+TEST(PhasedDay, Transfer_AnsweredByTheTarget_SettledByTheSender) {
+    Ward sender(1, 0), full(2, 1), empty(3, 10);
+    PhasedDay day({&sender, &full, &empty});
+
+    day.request(Intent::Op::Transfer, &sender, &full, ItemType::SickPatient, 4);
+    day.request(Intent::Op::Transfer, &sender, &empty, ItemType::SickPatient, 4);
+    day.swapBuffers();
+
+    // Les destinataires appliquent, puis le dernier à la barrière achemine les réponses
+    day.applyInbox(&empty);
+    day.applyInbox(&full);
+    EXPECT_EQ(day.settleReplies(&sender), 0);
+    day.routeReplies();
+    EXPECT_EQ(day.settleReplies(&sender), 2);
+
+    ASSERT_EQ(sender.replies.size(), 2u);
+    EXPECT_EQ(sender.replies[0].op, Intent::Op::Accepted);
+    EXPECT_EQ(sender.replies[0].from, day.indexOf(&full));
+    EXPECT_EQ(sender.replies[0].qty, 4);
+    EXPECT_EQ(sender.replies[0].amount, 1);
+    EXPECT_EQ(sender.replies[1].from, day.indexOf(&empty));
+    EXPECT_EQ(sender.replies[1].amount, 4);
+    EXPECT_EQ(day.getIntentCount(), 4);
+}
+
+TEST(PhasedDay, Previous_IsYesterdaysState_UntilTheSwap) {
+    Ward a(1, 5);
+    PhasedDay day({&a});
+    a.setPhases(&day);
+    a.publishState();
+    day.swapBuffers();
+    EXPECT_EQ(day.deferred(&a)->getFreeCapacity(), 5);
+
+    // Ce qui est publié aujourd'hui va dans l'autre tampon
+    a.room = 2;
+    a.publishState();
+    EXPECT_EQ(day.previous(&a).freeCapacity, 5);
+    day.swapBuffers();
+    EXPECT_EQ(day.previous(&a).freeCapacity, 2);
+    EXPECT_EQ(day.deferred(&a)->getFreeCapacity(), 2);
+}
+
+TEST(PhasedDay, Hospital_AdmitsUpToItsBeds_WithoutItsLock) {
+    Ward ambulance(1, 0);
+    Hospital hospital(2, 1000, 3);
+    PhasedDay day({&ambulance, &hospital});
+    hospital.setPhases(&day);
+
+    day.request(Intent::Op::Transfer, &ambulance, &hospital, ItemType::SickPatient, 5);
+    day.post({Intent::Op::Pay, ItemType::Nothing, -1, day.indexOf(&hospital), 0, 40});
+    day.swapBuffers();
+    day.applyInbox(&hospital);
+    day.routeReplies();
+    day.settleReplies(&ambulance);
+
+    ASSERT_EQ(ambulance.replies.size(), 1u);
+    EXPECT_EQ(ambulance.replies[0].amount, 3);
+    EXPECT_EQ(hospital.getStock()[ItemType::SickPatient], 3);
+    EXPECT_EQ(hospital.getFreeCapacity(), 0);
+    EXPECT_EQ(hospital.getFund(), 1040);
+    EXPECT_EQ(hospital.getLockStats().acquisitions, 0u);
+}
+
+TEST(PhasedDay, Supplier_SellsAllOrNothing) {
+    struct StockedSupplier : Supplier {
+        StockedSupplier() : Supplier(2, 0, {ItemType::Pill}) { stockOf(ItemType::Pill).add(4); }
+    };
+    Ward clinic(1, 0);
+    StockedSupplier supplier;
+    PhasedDay day({&clinic, &supplier});
+    supplier.setPhases(&day);
+
+    day.request(Intent::Op::Buy, &clinic, &supplier, ItemType::Pill, 3);
+    day.request(Intent::Op::Buy, &clinic, &supplier, ItemType::Pill, 3);
+    day.swapBuffers();
+    day.applyInbox(&supplier);
+    day.routeReplies();
+    day.settleReplies(&clinic);
+
+    ASSERT_EQ(clinic.replies.size(), 2u);
+    EXPECT_EQ(clinic.replies[0].op, Intent::Op::Sold);
+    EXPECT_EQ(clinic.replies[0].amount, 3);
+    EXPECT_EQ(clinic.replies[1].amount, 0);
+    EXPECT_EQ(supplier.getAvailable(ItemType::Pill), 1);
+}
+
+TEST(PhasedDay, SeededWorld_SameResultsWhateverTheTiming) {
+    int patientsLost = -1, moneyLost = -1;
+    auto first = runPhasedWorld(7, 30, patientsLost, moneyLost);
+    EXPECT_EQ(patientsLost, 0);
+    EXPECT_EQ(moneyLost, 0);
+
+    auto second = runPhasedWorld(7, 30, patientsLost, moneyLost);
+    EXPECT_EQ(first, second);
+}
@@ -0,0 +1,73 @@
+// tests/test_placement.cpp
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <pcosynchro/pcothread.h>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+
+#include "placement.h"
+
+namespace {
+
+class IdleSeller : public Seller {
+public:
+    explicit IdleSeller(int id) : Seller(0, id) {}
+    int  transfer(ItemType, int) override { return 0; }
+    int  buy(ItemType, int) override { return 0; }
+    void invoice(int, Seller*) override {}
+    void pay(int) override {}
+};
+
+} // namespace
+
+TEST(Placement, ParseCpuList_RangesAndSingles) {
+    EXPECT_EQ(parseCpuList("0-3,8,10-11\n"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_TRUE(parseCpuList("").empty());
+    EXPECT_THROW(parseCpuList("3-1"), std::invalid_argument);
+    EXPECT_THROW(parseCpuList("a"), std::invalid_argument);
+}
+
+TEST(Placement, ReadNumaNodes_SkipsCpuLessNodes) {
+    std::string root = ::testing::TempDir() + "pco_numa_test";
+    mkdir(root.c_str(), 0755);
+    for (const char* node : {"node0", "node1", "node2"}) mkdir((root + "/" + node).c_str(), 0755);
+    std::ofstream(root + "/node0/cpulist") << "0-1\n";
+    std::ofstream(root + "/node1/cpulist") << "\n";
+    std::ofstream(root + "/node2/cpulist") << "2,3\n";
+
+    auto nodes = readNumaNodes(root);
+    ASSERT_EQ(nodes.size(), 2u);
+    EXPECT_EQ(nodes[0].id, 0);
+    EXPECT_EQ(nodes[1].id, 2);
+    EXPECT_EQ(nodes[1].cpus, (std::vector<int>{2, 3}));
+
+    // Sans sysfs : un seul nœud avec tous les CPU
+    auto fallback = readNumaNodes(root + "/missing");
+    ASSERT_EQ(fallback.size(), 1u);
+    EXPECT_FALSE(fallback[0].cpus.empty());
+}
+
+TEST(Placement, GroupsGoToLeastLoadedNodeAndCallsAreCounted) {
+    Placement p;
+    p.setNodes({{0, {0}}, {1, {0}}});
+    IdleSeller hospA(1), clinicA(2), hospB(3), clinicB(4), supplier(5);
+
+    EXPECT_EQ(p.placeGroup({&hospA, &clinicA}), 0);
+    EXPECT_EQ(p.placeGroup({&hospB, &clinicB}), 1);
+    EXPECT_EQ(p.placeGroup({&supplier}), 0);
+    EXPECT_EQ(p.nodeOf(&clinicB), 1);
+
+    p.enable();
+    PcoThread t([&] {
+        p.pinCurrentThread(&hospA);
+        p.noteCall(&clinicA);
+        p.noteCall(&supplier);
+        p.noteCall(&clinicB);
+    });
+    t.join();
+
+    EXPECT_EQ(p.sameNodeCalls(), 2);
+    EXPECT_EQ(p.crossNodeCalls(), 1);
+}
@@ -0,0 +1,72 @@
+// tests/test_population.cpp
+#include <gtest/gtest.h>
+#include <pcosynchro/pcothread.h>
+#include <memory>
+#include <vector>
+
+#include "population.h"
+#include "hospital.h"
+#include "ambulance.h"
+
+namespace {
+
+/// Ambulance whose stock can be changed behind the population counter
+class SkewedAmbulance : public Ambulance {
+public:
+    using Ambulance::Ambulance;
+    void loseSilently(int qty) { stocks[ItemType::SickPatient] -= qty; }
+};
+
+} // namespace
+
+TEST(PopulationCounter, ConcurrentUpdatesSumUp) {
+    PopulationCounter counter;
+    const int N = 1000;
+    std::vector<std::unique_ptr<PcoThread>> ts;
+    for (int i = 0; i < 4; ++i) {
+        ts.emplace_back(std::make_unique<PcoThread>([&]() {
+            for (int k = 0; k < N; ++k) {
+                counter.add(PatientHolder::Ambulance, 2);
+                counter.move(PatientHolder::Ambulance, PatientHolder::Hospital, 1);
+            }
+        }));
+    }
+    for (auto& t : ts) t->join();
+
+    EXPECT_EQ(counter.count(PatientHolder::Ambulance), 4 * N);
+    EXPECT_EQ(counter.count(PatientHolder::Hospital), 4 * N);
+    EXPECT_EQ(counter.total(), 8 * N);
+
+    counter.reset();
+    EXPECT_EQ(counter.total(), 0);
+}
+
+TEST(PopulationCounter, HospitalAdmissionsAreCounted) {
+    Hospital hosp(1, /*fund*/1'000, /*maxBeds*/10);
+
+    long long startHospital = population().count(PatientHolder::Hospital);
+    long long startTotal    = population().total();
+
+    EXPECT_EQ(hosp.transfer(ItemType::SickPatient, 4), 4);
+    EXPECT_EQ(population().count(PatientHolder::Hospital), startHospital + 4);
+    EXPECT_EQ(population().total(), startTotal + 4);
+}
+
+TEST(PopulationCounter, CrossCheck_SkewedStock_IsReported) {
+    population().reset();
+    SkewedAmbulance amb(1, /*fund*/1'000, {ItemType::SickPatient}, {{ItemType::SickPatient, 5}});
+    Hospital hosp(2, /*fund*/1'000, /*maxBeds*/10);
+    EXPECT_EQ(hosp.transfer(ItemType::SickPatient, 3), 3);
+
+    std::vector<Seller*> actors{&amb, &hosp};
+    for (auto* a : actors) a->publishState();
+    EXPECT_TRUE(population().crossCheck(actors).empty());
+
+    amb.loseSilently(2);
+    for (auto* a : actors) a->publishState();
+    auto mismatches = population().crossCheck(actors);
+    ASSERT_EQ(mismatches.size(), 1u);
+    EXPECT_EQ(mismatches[0].holder, PatientHolder::Ambulance);
+    EXPECT_EQ(mismatches[0].counted, 5);
+    EXPECT_EQ(mismatches[0].published, 3);
+}
@@ -0,0 +1,69 @@
+// tests/test_seqlock.cpp
+#include <gtest/gtest.h>
+#include <pcosynchro/pcothread.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "seqlock.h"
+
+namespace {
+
+/// Toutes les cases valent la même chose : une lecture déchirée se voit
+struct Row {
+    int32_t values[16];
+};
+
+Row rowOf(int32_t v) {
+    Row row{};
+    for (auto& value : row.values) value = v;
+    return row;
+}
+
+} // namespace
+
+TEST(SeqLock, ZeroBeforeFirstPublication) {
+    SeqLock<Row> lock;
+    EXPECT_EQ(lock.version(), 0u);
+    EXPECT_EQ(lock.read().values[7], 0);
+}
+
+TEST(SeqLock, ReadsLastPublication) {
+    SeqLock<Row> lock;
+    lock.publish(rowOf(3));
+    lock.publish(rowOf(5));
+    Row row{};
+    ASSERT_TRUE(lock.tryRead(row));
+    EXPECT_EQ(row.values[0], 5);
+    EXPECT_EQ(row.values[15], 5);
+    EXPECT_EQ(lock.version(), 2u);
+}
+
+TEST(SeqLock, ConcurrentReaders_NeverSeeTornValues) {
+    SeqLock<Row> lock;
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::atomic<long long> reads{0};
+
+    std::vector<std::unique_ptr<PcoThread>> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back(std::make_unique<PcoThread>([&]() {
+            int32_t last = 0;
+            while (!done.load()) {
+                Row row = lock.read();
+                for (auto value : row.values) torn += value != row.values[0];
+                // Une seule source : les valeurs lues ne reculent jamais
+                torn += row.values[0] < last;
+                last = row.values[0];
+                ++reads;
+            }
+        }));
+    }
+    for (int32_t v = 1; v <= 200'000; ++v) lock.publish(rowOf(v));
+    done = true;
+    for (auto& t : readers) t->join();
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_GT(reads.load(), 0);
+    EXPECT_EQ(lock.read().values[3], 200'000);
+}
@@ -0,0 +1,219 @@
+// tests/test_snapshot.cpp
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "snapshot.h"
+#include "ambulance.h"
+#include "clinic.h"
+#include "hospital.h"
+#include "insurance.h"
+#include "supplier.h"
+#include "day_clock.h"
+#include <pcosynchro/pcothread.h>
+
+// Un petit monde complet, câblé comme dans main.cpp
+struct World {
+    World()
+        : amb(1, 200, {ItemType::SickPatient}, {{ItemType::SickPatient, 20}}),
+          sup(2, 200),
+          hosp(3, 1'000, 10),
+          clinic(4, 300),
+          ins(5, 1'000) {
+        amb.setHospitals({&hosp});
+        amb.setInsurance(&ins);
+        hosp.setClinics({&clinic});
+        hosp.setInsurance(&ins);
+        clinic.setHospitalsAndSuppliers({&hosp}, {&sup});
+        clinic.setInsurance(&ins);
+    }
+
+    std::vector<Seller*> sellers() { return {&amb, &sup, &hosp, &clinic, &ins}; }
+
+    Ambulance amb;
+    Pharmacy sup;
+    Hospital hosp;
+    Pulmonology clinic;
+    Insurance ins;
+};
+
+// Fournisseur dont le stock se règle directement
+class StockedSupplier : public MedicalDeviceSupplier {
+public:
+    using MedicalDeviceSupplier::MedicalDeviceSupplier;
+    using Supplier::stockOf;
+};
+
+class SnapshotFixture : public ::testing::Test {
+protected:
+    void TearDown() override { std::remove(path.c_str()); }
+    std::string path = ::testing::TempDir() + "pco_snapshot_test.bin";
+};
+
+TEST_F(SnapshotFixture, RestoreReproducesFundsStocksAndBeds) {
+    World src;
+    EXPECT_EQ(src.hosp.transfer(ItemType::SickPatient, 6), 6);
+    EXPECT_EQ(src.hosp.transfer(ItemType::RehabPatient, 2), 2);
+    EXPECT_EQ(src.clinic.transfer(ItemType::SickPatient, 3), 3);
+    src.ins.invoice(40, &src.hosp);
+    src.sup.pay(17);
+
+    Snapshot::save(path, src.sellers(), 42);
+
+    World dst;
+    EXPECT_EQ(Snapshot::restore(path, dst.sellers()), 42);
+
+    for (size_t i = 0; i < src.sellers().size(); ++i) {
+        EXPECT_EQ(dst.sellers()[i]->getFund(), src.sellers()[i]->getFund());
+        EXPECT_EQ(dst.sellers()[i]->getStock(), src.sellers()[i]->getStock());
+    }
+    EXPECT_EQ(dst.clinic.getWaitingPatients(), 3);
+
+    // 10 lits, 8 occupés : seuls 2 patients de plus peuvent entrer
+    EXPECT_EQ(dst.hosp.transfer(ItemType::SickPatient, 5), 2);
+}
+
+TEST_F(SnapshotFixture, RestoreKeepsSupplierWorkInProgress) {
+    World src;
+    src.sup.pay(10'000);
+    src.sup.setProductionPlan(ItemType::Pill, {4, 3});
+    src.sup.setProductionPlan(ItemType::Syringe, {4, 3});
+    DayClock clock(1);
+    src.sup.setClock(&clock);
+    PcoThread th([&]() { src.sup.run(); });
+    clock.start_next_day();
+    clock.wait_all_done();
+    th.requestStop();
+    clock.start_next_day();
+    th.join();
+    ASSERT_EQ(src.sup.getWorkInProgress(), 4);
+
+    Snapshot::save(path, src.sellers(), 1);
+
+    World dst;
+    Snapshot::restore(path, dst.sellers());
+    EXPECT_EQ(dst.sup.getWorkInProgress(), 4);
+}
+
+TEST_F(SnapshotFixture, RestoreContinuesRandomDrawsAndKeepsCreditLimits) {
+    World src;
+    for (int i = 0; i < 5; ++i) src.amb.chooseRandomIndex(1000);
+    src.ins.setCreditLimit(&src.hosp, 30);
+    Snapshot::save(path, src.sellers(), 7);
+
+    // Le monde restauré a tiré autre chose avant la restauration
+    World dst;
+    dst.amb.chooseRandomIndex(1000);
+    Snapshot::restore(path, dst.sellers());
+
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(dst.amb.chooseRandomIndex(1000), src.amb.chooseRandomIndex(1000));
+        EXPECT_EQ(dst.clinic.chooseRandomIndex(1000), src.clinic.chooseRandomIndex(1000));
+    }
+    EXPECT_EQ(dst.ins.getCreditLimit(&dst.hosp), 30);
+    EXPECT_EQ(dst.ins.getCreditLimit(&dst.clinic), 0);
+}
+
+TEST_F(SnapshotFixture, RestoreKeepsTheCreditDrawnByTheInsurance) {
+    Hospital hosp(3, 0, 10);
+    Insurance ins(5, 0);
+    ins.setCreditLimit(&hosp, 50);
+    ins.invoice(45, &hosp);
+
+    // Un jour de cotisations ne couvre pas la facture : le reste est tiré sur le crédit
+    DayClock clock(1);
+    ins.setClock(&clock);
+    PcoThread th([&]() { ins.run(); });
+    clock.start_next_day();
+    clock.wait_all_done();
+    th.requestStop();
+    clock.start_next_day();
+    th.join();
+    ASSERT_LT(ins.getFund(), 0);
+
+    Snapshot::save(path, {&hosp, &ins}, 1);
+    Hospital hospCopy(3, 0, 10);
+    Insurance insCopy(5, 0);
+    Snapshot::restore(path, {&hospCopy, &insCopy});
+
+    // Seul ce qui n'a pas été tiré reste disponible pour l'hôpital
+    EXPECT_EQ(insCopy.getFund(), ins.getFund());
+    EXPECT_EQ(insCopy.getCreditLeft(&hospCopy), 50 + ins.getFund());
+}
+
+TEST(SellerRandom, SameSeedAndId_SameDraws) {
+    Ambulance a(1, 0, {ItemType::SickPatient}, {});
+    Ambulance b(1, 0, {ItemType::SickPatient}, {});
+    Ambulance other(2, 0, {ItemType::SickPatient}, {});
+    std::vector<size_t> drawsA, drawsB, drawsOther;
+    for (int i = 0; i < 20; ++i) {
+        drawsA.push_back(a.chooseRandomIndex(1 << 20));
+        drawsB.push_back(b.chooseRandomIndex(1 << 20));
+        drawsOther.push_back(other.chooseRandomIndex(1 << 20));
+    }
+    EXPECT_EQ(drawsA, drawsB);
+    EXPECT_NE(drawsA, drawsOther);
+}
+
+TEST_F(SnapshotFixture, RestoreRejectsCorruptOrMismatchingFiles) {
+    World src;
+    Snapshot::save(path, src.sellers(), 1);
+
+    World dst;
+    std::vector<Seller*> partial = {&dst.amb, &dst.sup};
+    EXPECT_THROW(Snapshot::restore(path, partial), std::runtime_error);
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "garbage";
+    EXPECT_THROW(Snapshot::restore(path, dst.sellers()), std::runtime_error);
+
+    EXPECT_THROW(Snapshot::restore(path + ".missing", dst.sellers()), std::runtime_error);
+}
+
+TEST_F(SnapshotFixture, RestoreRejectsClinicBillToNonSupplier) {
+    // La clinique, sans argent, achète ses ressources à crédit
+    Pharmacy pharmacy(2, 0);
+    StockedSupplier devices(77, 0);
+    Hospital hosp(3, 1'000, 10);
+    Insurance ins(5, 1'000);
+    Pulmonology clinic(4, 1);
+    clinic.setHospitalsAndSuppliers({&hosp}, {&pharmacy, &devices});
+    clinic.setInsurance(&ins);
+    hosp.setInsurance(&ins);
+    devices.stockOf(ItemType::Thermometer).store(10);
+    ASSERT_EQ(clinic.transfer(ItemType::SickPatient, 1), 1);
+
+    DayClock clock(1);
+    clinic.setClock(&clock);
+    PcoThread th([&]() { clinic.run(); });
+    clock.start_next_day();
+    clock.wait_all_done();
+    th.requestStop();
+    clock.start_next_day();
+    th.join();
+    ASSERT_GT(clinic.readState().unpaid, 0);
+
+    // La clinique est le dernier acteur : la dernière occurrence de 77 est sa facture
+    std::vector<Seller*> sellers = {&pharmacy, &devices, &hosp, &ins, &clinic};
+    Snapshot::save(path, sellers, 1);
+    EXPECT_NO_THROW(Snapshot::restore(path, sellers));
+
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    long last = -1;
+    for (size_t at = 0; at + sizeof(int32_t) <= bytes.size(); at += sizeof(int32_t)) {
+        int32_t value;
+        std::memcpy(&value, bytes.data() + at, sizeof(value));
+        if (value == 77) last = static_cast<long>(at);
+    }
+    ASSERT_GE(last, 0);
+    const int32_t hospitalId = 3;
+    file.clear();
+    file.seekp(last);
+    file.write(reinterpret_cast<const char*>(&hospitalId), sizeof(hospitalId));
+    file.close();
+
+    EXPECT_THROW(Snapshot::restore(path, sellers), std::runtime_error);
+}
@@ -0,0 +1,105 @@
+// tests/test_stats_server.cpp
+#include <gtest/gtest.h>
+#include <pcosynchro/pcothread.h>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "hospital.h"
+#include "lock_stats.h"
+#include "population.h"
+#include "stats_server.h"
+#include "supplier.h"
+#include "wait_histogram.h"
+
+namespace {
+
+std::map<std::string, std::string> parse(const std::string& report) {
+    std::map<std::string, std::string> values;
+    std::istringstream in(report);
+    for (std::string line; std::getline(in, line);) {
+        auto space = line.find(' ');
+        if (space != std::string::npos) values[line.substr(0, space)] = line.substr(space + 1);
+    }
+    return values;
+}
+
+std::string socketPath() {
+    return "/tmp/pco_stats_test_" + std::to_string(getpid()) + ".sock";
+}
+
+} // namespace
+
+TEST(WaitHistogram, PercentilesArePowerOfTwoUpperBounds) {
+    WaitHistogram waits;
+    EXPECT_EQ(waits.percentileUs(0.5), 0u);
+    for (int i = 0; i < 90; ++i) waits.add(500);        // < 1 µs
+    for (int i = 0; i < 10; ++i) waits.add(3'000'000);  // 3 ms
+    EXPECT_EQ(waits.count(), 100u);
+    EXPECT_EQ(waits.percentileUs(0.5), 1u);
+    EXPECT_EQ(waits.percentileUs(0.99), 4096u);
+}
+
+TEST(ProfiledMutex, CountsOnlyContendedAcquisitions) {
+    ProfiledMutex mutex;
+    mutex.lock();
+    mutex.unlock();
+    EXPECT_TRUE(mutex.trylock());
+    EXPECT_FALSE(mutex.trylock());
+
+    auto waiter = std::make_unique<PcoThread>([&]() {
+        mutex.lock();
+        mutex.unlock();
+    });
+    PcoThread::usleep(20'000);
+    mutex.unlock();
+    waiter->join();
+
+    LockStats stats = mutex.stats();
+    EXPECT_EQ(stats.acquisitions, 3u);
+    EXPECT_EQ(stats.contended, 1u);
+    EXPECT_GT(stats.waitNs, 0u);
+}
+
+TEST(StatsServer, Report_SumsPublishedStatesPerGroup) {
+    population().reset();
+    Pharmacy pharmacy(1, 300);
+    MedicalDeviceSupplier devices(2, 200);
+    Hospital hospital(3, 1000, 10);
+    DayClock clock(3);
+    for (Seller* s : std::vector<Seller*>{&pharmacy, &devices, &hospital}) s->publishState();
+
+    StatsServer server(socketPath(), {{"supplier", {&pharmacy, &devices}}, {"hospital", {&hospital}}}, clock);
+    hospital.transfer(ItemType::SickPatient, 4);
+    hospital.publishState();
+
+    auto values = parse(server.report());
+    EXPECT_EQ(values["day"], "0");
+    EXPECT_EQ(values["fund_supplier"], "500");
+    EXPECT_EQ(values["fund_hospital"], "1000");
+    EXPECT_EQ(values["backlog_hospital"], "4");
+    EXPECT_EQ(values["patients_hospital"], "4");
+    EXPECT_EQ(values["barrier_waits"], "0");
+    EXPECT_TRUE(values.count("lock_hospital_contended"));
+    EXPECT_TRUE(values.count("days_per_sec"));
+    population().reset();
+}
+
+TEST(StatsServer, Query_ReturnsReportOverSocket) {
+    Pharmacy pharmacy(1, 300);
+    DayClock clock(1);
+    pharmacy.publishState();
+
+    std::string path = socketPath();
+    {
+        StatsServer server(path, {{"supplier", {&pharmacy}}}, clock);
+        for (int i = 0; i < 3; ++i) {
+            auto values = parse(StatsServer::query(path));
+            EXPECT_EQ(values["fund_supplier"], "300");
+        }
+    }
+    // Serveur arrêté : le socket a disparu
+    EXPECT_THROW(StatsServer::query(path), std::runtime_error);
+}
@@ -0,0 +1,52 @@
+// tests/test_stock_counter.cpp
+#include <gtest/gtest.h>
+#include <pcosynchro/pcothread.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "stock_counter.h"
+
+TEST(StockCounter, AllOrNothing_TakesEverythingOrNothing) {
+    StockCounter stock;
+    stock.add(5);
+    EXPECT_EQ(stock.tryTake(6), 0);
+    EXPECT_EQ(stock.load(), 5);
+    EXPECT_EQ(stock.tryTake(5), 5);
+    EXPECT_EQ(stock.load(), 0);
+}
+
+TEST(StockCounter, Partial_TakesWhatIsThere) {
+    StockCounter stock;
+    stock.add(3);
+    EXPECT_EQ(stock.tryTake(2, Fill::Partial), 2);
+    EXPECT_EQ(stock.tryTake(4, Fill::Partial), 1);
+    EXPECT_EQ(stock.tryTake(4, Fill::Partial), 0);
+    EXPECT_EQ(stock.load(), 0);
+}
+
+TEST(StockCounter, NonPositiveQuantity_TakesNothing) {
+    StockCounter stock;
+    stock.store(4);
+    EXPECT_EQ(stock.tryTake(0), 0);
+    EXPECT_EQ(stock.tryTake(-2, Fill::Partial), 0);
+    EXPECT_EQ(stock.load(), 4);
+}
+
+TEST(StockCounter, ConcurrentTakes_NeverGoBelowZero) {
+    StockCounter stock;
+    const int UNITS = 100'000;
+    stock.add(UNITS);
+    std::atomic<int> taken{0};
+
+    std::vector<std::unique_ptr<PcoThread>> ts;
+    for (int i = 0; i < 8; ++i) {
+        ts.emplace_back(std::make_unique<PcoThread>([&, i]() {
+            Fill fill = i % 2 ? Fill::Partial : Fill::AllOrNothing;
+            while (stock.load() > 0) taken += stock.tryTake(1 + i % 3, fill);
+        }));
+    }
+    for (auto& t : ts) t->join();
+
+    EXPECT_EQ(taken.load(), UNITS);
+    EXPECT_EQ(stock.load(), 0);
+}
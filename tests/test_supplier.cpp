@@ -1,6 +1,8 @@
 // tests/test_supplier.cpp
 #include <gtest/gtest.h>
 #include <pcosynchro/pcothread.h>
+#include <atomic>
+#include <map>
 #include <memory>
 #include <vector>
 #include "supplier.h"
@@ -10,18 +12,35 @@
 class TestableSupplier : public Supplier {
 public:
     using Supplier::Supplier;
-    using Seller::stocks;
     using Seller::money;
     using Seller::nbEmployeesPaid;
+    using Supplier::attemptToProduceResource;
+    using Supplier::advanceProduction;
+    using Seller::enterDay;
 
-    void setStock(ItemType it, int qty) { stocks[it] = qty; }
-    int getStock(ItemType it) const {
-        auto itf = stocks.find(it);
-        return itf == stocks.end() ? 0 : itf->second;
-    }
+    using Supplier::getStock;
+    void setStock(ItemType it, int qty) { stockOf(it).store(qty); }
+    int getStock(ItemType it) const { return getAvailable(it); }
     int getFund() const { return money; }
 };
 
+// La table des coûts est évaluée à la compilation
+static_assert(getCostPerUnit(ItemType::Pill) == PILL_COST);
+static_assert(getCostPerUnit(ItemType::SickPatient) == 0);
+static_assert(getEmployeeSalary(getEmployeeThatProduces(ItemType::RehabPatient)) == DOCTOR_COST);
+static_assert(getCostPerService(ServiceType::Rehab) == REHAB_COST);
+static_assert(getItemName(ItemType::Stethoscope) == "Stethoscope");
+
+TEST(SupplierCosts, OrderCost_SumsEveryLine) {
+    EXPECT_EQ(getOrderCost({{ItemType::Pill, 3}, {ItemType::Scalpel, 2}, {ItemType::Pill, 1}}),
+              4 * PILL_COST + 2 * SCALPEL_COST);
+    EXPECT_EQ(getOrderCost(std::vector<std::pair<ItemType, int>>{}), 0);
+
+    MedicalDeviceSupplier devices(1, 0);
+    EXPECT_EQ(devices.getMaterialCost(), SCALPEL_COST + THERMOMETER_COST + STETHOSCOPE_COST);
+    EXPECT_EQ(getItemName(static_cast<ItemType>(42)), "???");
+}
+
 TEST(SupplierBasic, SellsResource_MatchesCatalog) {
     TestableSupplier s(1, 0, {ItemType::Pill, ItemType::Thermometer});
     EXPECT_TRUE(s.sellsResource(ItemType::Pill));
@@ -67,6 +86,47 @@ TEST(SupplierThreading, PayIsThreadSafe) {
     EXPECT_EQ(s.getFund(), 4 * N);
 }
 
+TEST(SupplierThreading, ConcurrentBuysAndProduction_NeverOversell) {
+    TestableSupplier s(8, /*fund*/1'000'000, {ItemType::Pill});
+    s.setProductionPlan(ItemType::Pill, {/*batchSize*/3, /*leadTimeDays*/0});
+    const int DAYS = 2000;
+    std::atomic<int> billed{0};
+    std::atomic<bool> done{false};
+
+    std::vector<std::unique_ptr<PcoThread>> ts;
+    for (int i = 0; i < 4; ++i) {
+        ts.emplace_back(std::make_unique<PcoThread>([&, i]() {
+            while (!done.load()) billed += s.buy(ItemType::Pill, 1 + i);
+        }));
+    }
+    for (int d = 0; d < DAYS; ++d) s.attemptToProduceResource();
+    done = true;
+    for (auto& t : ts) t->join();
+
+    // Chaque unité produite est soit vendue (et facturée) une seule fois, soit encore en stock
+    EXPECT_EQ(billed.load() / getCostPerUnit(ItemType::Pill) + s.getStock(ItemType::Pill), 3 * DAYS);
+    EXPECT_GE(s.getStock(ItemType::Pill), 0);
+    EXPECT_EQ(s.getStock(), (std::map<ItemType, int>{{ItemType::Pill, s.getStock(ItemType::Pill)}}));
+}
+
+TEST(SupplierBasic, PublishState_ReadsCountersAndWorkInProgress) {
+    TestableSupplier s(9, /*fund*/100, {ItemType::Pill, ItemType::Syringe});
+    s.setProductionPlan(ItemType::Syringe, {/*batchSize*/2, /*leadTimeDays*/3});
+    s.setStock(ItemType::Pill, 7);
+    EXPECT_EQ(s.getStateVersion(), 0u);
+
+    for (int i = 0; i < 10 && s.getWorkInProgress() == 0; ++i) s.attemptToProduceResource();
+    s.publishState();
+
+    ActorState state = s.readState();
+    EXPECT_EQ(s.getStateVersion(), 1u);
+    EXPECT_EQ(state.fund, s.getFund());
+    EXPECT_EQ(state.employeesPaid, s.nbEmployeesPaid);
+    EXPECT_EQ(state.stock[static_cast<int>(ItemType::Pill)], s.getStock(ItemType::Pill));
+    EXPECT_EQ(state.backlog, s.getWorkInProgress());
+    EXPECT_EQ(state.stock[static_cast<int>(ItemType::Scalpel)], 0);
+}
+
 TEST(SupplierRun, ProducesItemsWhenFundsSufficient) {
     TestableSupplier s(7, /*fund*/100'000, {ItemType::Pill, ItemType::Thermometer, ItemType::Syringe});
 
@@ -94,3 +154,62 @@ TEST(SupplierRun, ProducesItemsWhenFundsSufficient) {
     EXPECT_GE(totalStock, 5);
     EXPECT_EQ(s.getAmountPaidToEmployees(EmployeeType::Supplier), 5 * getEmployeeSalary(EmployeeType::Supplier));
 }
+
+TEST(SupplierPipeline, BatchesReachStockAfterLeadTime) {
+    TestableSupplier s(8, /*fund*/100'000, {ItemType::Pill});
+    s.setProductionPlan(ItemType::Pill, {/*batchSize*/3, /*leadTimeDays*/2});
+    const int salary = getEmployeeSalary(EmployeeType::Supplier);
+
+    // Jour 0 : un lot de 3 démarre, payé immédiatement
+    s.advanceProduction();
+    s.attemptToProduceResource();
+    EXPECT_EQ(s.getFund(), 100'000 - 3 * salary);
+    EXPECT_EQ(s.getWorkInProgress(), 3);
+    EXPECT_EQ(s.getAvailable(ItemType::Pill), 0);
+
+    // Jour 1 : second lot, le premier n'est pas encore prêt
+    s.advanceProduction();
+    s.attemptToProduceResource();
+    EXPECT_EQ(s.getWorkInProgress(), 6);
+    EXPECT_EQ(s.buy(ItemType::Pill, 1), 0);
+
+    // Jour 2 : le premier lot arrive en stock, visible sans verrou
+    s.advanceProduction();
+    EXPECT_EQ(s.getWorkInProgress(), 3);
+    EXPECT_EQ(s.getStock(ItemType::Pill), 3);
+    EXPECT_EQ(s.getAvailable(ItemType::Pill), 3);
+
+    EXPECT_EQ(s.buy(ItemType::Pill, 2), 2 * getCostPerUnit(ItemType::Pill));
+    EXPECT_EQ(s.getAvailable(ItemType::Pill), 1);
+}
+
+TEST(SupplierPipeline, NoBatchStarted_WhenFundsCannotPayWholeBatch) {
+    const int salary = getEmployeeSalary(EmployeeType::Supplier);
+    TestableSupplier s(9, /*fund*/2 * salary, {ItemType::Pill});
+    s.setProductionPlan(ItemType::Pill, {/*batchSize*/3, /*leadTimeDays*/0});
+
+    s.attemptToProduceResource();
+    EXPECT_EQ(s.getFund(), 2 * salary);
+    EXPECT_EQ(s.getStock(ItemType::Pill), 0);
+    EXPECT_EQ(s.getWorkInProgress(), 0);
+}
+
+TEST(SupplierPipeline, IdleUntilBatchDone_WhenBroke) {
+    const int salary = getEmployeeSalary(EmployeeType::Supplier);
+    TestableSupplier s(10, /*fund*/3 * salary, {ItemType::Pill});
+    s.setProductionPlan(ItemType::Pill, {/*batchSize*/3, /*leadTimeDays*/4});
+    DayClock clock(1);
+    s.setClock(&clock);
+
+    // Jour 0 : tout l'argent part dans le lot, plus rien à faire avant qu'il soit prêt
+    s.enterDay();
+    s.attemptToProduceResource();
+    EXPECT_EQ(s.nextWorkDay(1), 4);
+
+    // Les jours sautés sont rattrapés d'un coup
+    s.advanceProduction(3);
+    EXPECT_EQ(s.getStock(ItemType::Pill), 0);
+    s.advanceProduction(1);
+    EXPECT_EQ(s.getStock(ItemType::Pill), 3);
+    EXPECT_EQ(s.nextWorkDay(5), Seller::NO_WORK_DAY);
+}
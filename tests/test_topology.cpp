@@ -0,0 +1,109 @@
+// tests/test_topology.cpp
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+#include "topology.h"
+#include "utils.h"
+
+TEST(Topology, AllToAll_MatchesHistoricalWiring) {
+    // 5 cliniques pour 2 hôpitaux : 2 chacun, la dernière partagée
+    Topology t = makeAllToAllTopology(2, 3, 5, 2);
+    EXPECT_EQ(t.hospitalClinics[0], (std::vector<int>{0, 1, 4}));
+    EXPECT_EQ(t.hospitalClinics[1], (std::vector<int>{2, 3, 4}));
+    EXPECT_EQ(t.ambulanceHospitals[1], (std::vector<int>{0, 1}));
+    EXPECT_EQ(t.clinicSuppliers[3], (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(t.nbLinks(), 2u * 2 + 6 + 5 * 2 + 5 * 3);
+}
+
+TEST(Topology, Regional_StaysInRegionWithBoundedFanOut) {
+    const int A = 400, S = 41, C = 2000, H = 200, R = 10, K = 3;
+    Topology t = makeRegionalTopology(A, S, C, H, R, K, 7);
+
+    auto region = [](int i, int count) { return i * R / count; };
+    for (int a = 0; a < A; ++a) {
+        ASSERT_EQ(t.ambulanceHospitals[a].size(), static_cast<size_t>(K));
+        for (int h : t.ambulanceHospitals[a]) EXPECT_EQ(region(h, H), region(a, A));
+    }
+    std::vector<int> owners(C, 0);
+    for (int h = 0; h < H; ++h) {
+        for (int c : t.hospitalClinics[h]) {
+            ++owners[c];
+            EXPECT_EQ(region(c, C), region(h, H));
+        }
+    }
+    for (int c = 0; c < C; ++c) {
+        EXPECT_EQ(owners[c], 1);
+        EXPECT_EQ(t.clinicHospitals[c].size(), static_cast<size_t>(K));
+        // Fournisseurs consécutifs : les deux sortes sont présentes, même avec
+        // un nombre impair de fournisseurs
+        std::set<int> parities;
+        for (int s : t.clinicSuppliers[c]) parities.insert(s % 2);
+        EXPECT_EQ(parities.size(), 2u);
+    }
+
+    // Déterministe pour une graine donnée
+    Topology again = makeRegionalTopology(A, S, C, H, R, K, 7);
+    EXPECT_EQ(again.ambulanceHospitals, t.ambulanceHospitals);
+    EXPECT_EQ(again.clinicSuppliers, t.clinicSuppliers);
+
+    EXPECT_THROW(makeRegionalTopology(A, S, C, H, H + 1, K, 7), std::invalid_argument);
+}
+
+TEST(Topology, Regional_ScalesToLargeNetworks) {
+    Topology t = makeRegionalTopology(20'000, 10'000, 100'000, 20'000, 500, 4, 1);
+    EXPECT_EQ(t.hospitalClinics.size(), 20'000u);
+    EXPECT_EQ(t.nbLinks(), 20'000u * 4 + 100'000u + 100'000u * 4 + 100'000u * 4);
+}
+
+TEST(Topology, SaveLoadRoundTripAndErrors) {
+    std::string path = ::testing::TempDir() + "pco_topology_test.txt";
+    Topology t = makeRegionalTopology(4, 4, 6, 3, 3, 2, 3);
+    saveTopology(path, t);
+
+    Topology loaded = loadTopology(path);
+    EXPECT_EQ(loaded.nbClinics, 6);
+    EXPECT_EQ(loaded.ambulanceHospitals, t.ambulanceHospitals);
+    EXPECT_EQ(loaded.hospitalClinics, t.hospitalClinics);
+    EXPECT_EQ(loaded.clinicHospitals, t.clinicHospitals);
+    EXPECT_EQ(loaded.clinicSuppliers, t.clinicSuppliers);
+
+    std::ofstream(path, std::ios::trunc) << "actors 1 1 1 1\nambulance 0 5\n";
+    EXPECT_THROW(loadTopology(path), std::runtime_error);
+    std::ofstream(path, std::ios::trunc) << "hospital 0 0\n";
+    EXPECT_THROW(loadTopology(path), std::runtime_error);
+    // Ambulances sans ligne : aucun hôpital où déposer les patients
+    std::ofstream(path, std::ios::trunc) << "actors 1 3 3 2\nhospital 0 0\n";
+    EXPECT_THROW(loadTopology(path), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(loadTopology(path), std::runtime_error);
+}
+
+TEST(Topology, Apply_WiresActorsAndChecksSuppliers) {
+    auto ambulances = createAmbulances(1, 0);
+    auto suppliers  = createSuppliers(2, 1);
+    auto hospitals  = createHospitals(2, 3);
+    auto clinics    = createClinics(3, 5);
+
+    Topology t = makeAllToAllTopology(1, 2, 3, 2);
+    EXPECT_NO_THROW(applyTopology(t, ambulances, suppliers, clinics, hospitals));
+
+    // Une clinique sans pharmacie ne peut pas acheter de Pill
+    t.clinicSuppliers[0] = {0};
+    EXPECT_THROW(applyTopology(t, ambulances, suppliers, clinics, hospitals), std::runtime_error);
+
+    Topology stranded = makeAllToAllTopology(1, 2, 3, 2);
+    stranded.ambulanceHospitals[0].clear();
+    EXPECT_THROW(applyTopology(stranded, ambulances, suppliers, clinics, hospitals), std::runtime_error);
+
+    Topology wrong = makeAllToAllTopology(1, 2, 4, 2);
+    EXPECT_THROW(applyTopology(wrong, ambulances, suppliers, clinics, hospitals), std::runtime_error);
+
+    for (auto* a : ambulances) delete a;
+    for (auto* s : suppliers) delete s;
+    for (auto* h : hospitals) delete h;
+    for (auto* c : clinics) delete c;
+}